@@ -0,0 +1,326 @@
+#include "Bot/BotClient.hpp"
+
+#include "Shared/AsyncLog.hpp"
+#include "Shared/PlanePositionCodec.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+//--------------------------------------------------------------------------
+/**
+* Add
+*/
+void latency_stats_t::Add( double seconds )
+{
+	min_seconds = count == 0 ? seconds : std::min( min_seconds, seconds );
+	max_seconds = count == 0 ? seconds : std::max( max_seconds, seconds );
+	total_seconds += seconds;
+	++count;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Merge
+*/
+void latency_stats_t::Merge( const latency_stats_t& other )
+{
+	if( other.count == 0 )
+	{
+		return;
+	}
+	min_seconds = count == 0 ? other.min_seconds : std::min( min_seconds, other.min_seconds );
+	max_seconds = count == 0 ? other.max_seconds : std::max( max_seconds, other.max_seconds );
+	total_seconds += other.total_seconds;
+	count += other.count;
+}
+
+
+//--------------------------------------------------------------------------
+/**
+* BotClient
+*/
+BotClient::BotClient( std::unique_ptr<WorkerConnection> connection, uint32_t index, const bot_settings_t& settings )
+	: m_connection( std::move( connection ) )
+	, m_session( *m_connection, *this )
+	, m_index( index )
+	, m_settings( settings )
+{
+	OnDisconnect( [this]( const std::string& reason ) {
+		LOG_WARNING( "Bot", "[%s] disconnected: %s", GetWorkerId().c_str(), reason.c_str() );
+		m_state = BOT_FAILED;
+		});
+
+	m_session.on_api_found = [this]( worker::EntityId ) {
+		RequestPlayer( bot_clock::now() );
+	};
+	m_session.on_client_entity_created = [this]( uint64_t request_id, bool success, worker::EntityId created_id ) {
+		if( m_state != BOT_WAITING_FOR_RESPONSE || request_id != m_create_request_id )
+		{
+			return;
+		}
+		if( !success )
+		{
+			LOG_WARNING( "Bot", "[%s] CreateClientEntity failed", GetWorkerId().c_str() );
+			m_state = BOT_FAILED;
+			return;
+		}
+		if( m_player_id != 0 && m_player_id != created_id )
+		{
+			LOG_WARNING( "Bot", "[%s] controls %lld but was given %lld", GetWorkerId().c_str(), (long long)m_player_id, (long long)created_id );
+		}
+		m_player_id = created_id;
+		m_state = BOT_WAITING_FOR_PLAYER;
+		CheckJoined( bot_clock::now() );
+	};
+
+	m_session.FindAPIEntity();
+}
+
+//--------------------------------------------------------------------------
+/**
+* ~BotClient
+*/
+BotClient::~BotClient()
+{
+	if( m_state == BOT_PLAYING || m_state == BOT_WAITING_FOR_PLAYER )
+	{
+		m_session.RequestClientEntityDeletion( m_player_id );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* Update
+*/
+void BotClient::Update( bot_clock::time_point now )
+{
+	if( !IsConnected() )
+	{
+		m_state = BOT_FAILED;
+		return;
+	}
+
+	m_connection->Process( *this, 0 );
+
+	if( m_state == BOT_PLAYING )
+	{
+		Move( now );
+		m_session.UpdatePing( m_player_id );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* IsConnected
+*/
+bool BotClient::IsConnected() const
+{
+	return m_connection->IsConnected();
+}
+
+//--------------------------------------------------------------------------
+/**
+* TakeReceivedCount
+*/
+uint64_t BotClient::TakeReceivedCount()
+{
+	uint64_t received = m_received;
+	m_received = 0;
+	return received;
+}
+
+//--------------------------------------------------------------------------
+/**
+* AddEntity
+*/
+void BotClient::AddEntity( worker::EntityId /*id*/ )
+{
+	++m_received;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RemoveEntity
+*/
+void BotClient::RemoveEntity( worker::EntityId id )
+{
+	++m_received;
+	m_positions.erase( id );
+	m_plane_positions.erase( id );
+	if( id == m_player_id )
+	{
+		m_player_authoritative = false;
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* AddComponent
+* Once an entity has PlanePosition its Position is only a low rate copy and is ignored.
+*/
+void BotClient::AddComponent( worker::EntityId id, const improbable::PositionData& data )
+{
+	++m_received;
+	if( m_plane_positions.count( id ) == 0 )
+	{
+		OnPosition( id, Vec2( (float)data.coords().x(), (float)data.coords().z() ), bot_clock::now() );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* AddComponent
+*/
+void BotClient::AddComponent( worker::EntityId id, const siren::PlanePositionData& data )
+{
+	++m_received;
+	m_plane_positions[id] = data;
+	OnPosition( id, DecodePlanePosition( data ), bot_clock::now() );
+}
+
+//--------------------------------------------------------------------------
+/**
+* UpdateComponent
+*/
+void BotClient::UpdateComponent( worker::EntityId id, const improbable::Position::Update& update )
+{
+	++m_received;
+	if( update.coords() && m_plane_positions.count( id ) == 0 )
+	{
+		OnPosition( id, Vec2( (float)update.coords()->x(), (float)update.coords()->z() ), bot_clock::now() );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* UpdateComponent
+*/
+void BotClient::UpdateComponent( worker::EntityId id, const siren::PlanePosition::Update& update )
+{
+	++m_received;
+	auto plane_position = m_plane_positions.find( id );
+	if( plane_position != m_plane_positions.end() )
+	{
+		update.ApplyTo( plane_position->second );
+		OnPosition( id, DecodePlanePosition( plane_position->second ), bot_clock::now() );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* RemoveComponent
+*/
+void BotClient::RemoveComponent( worker::EntityId id, worker::ComponentId component_id )
+{
+	++m_received;
+	if( component_id == siren::PlanePosition::ComponentId )
+	{
+		m_plane_positions.erase( id );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* ChangeAuthority
+* The player only counts as joined once we can steer it.
+*/
+void BotClient::ChangeAuthority( worker::EntityId id, worker::ComponentId component_id, worker::Authority authority )
+{
+	++m_received;
+	if( component_id != siren::PlayerControls::ComponentId || ( m_player_id != 0 && id != m_player_id ) )
+	{
+		return;
+	}
+	m_player_id = id;
+	m_player_authoritative = authority != worker::Authority::kNotAuthoritative;
+	CheckJoined( bot_clock::now() );
+}
+
+//--------------------------------------------------------------------------
+/**
+* RequestPlayer
+*/
+void BotClient::RequestPlayer( bot_clock::time_point now )
+{
+	worker::Option<uint64_t> request_id = m_session.RequestClientEntity();
+	if( !request_id )
+	{
+		LOG_WARNING( "Bot", "[%s] failed to send CreateClientEntity", GetWorkerId().c_str() );
+		m_state = BOT_FAILED;
+		return;
+	}
+	m_create_request_id = *request_id;
+	m_join_start = now;
+	m_state = BOT_WAITING_FOR_RESPONSE;
+}
+
+//--------------------------------------------------------------------------
+/**
+* CheckJoined
+* Ops can come in either order, the command response or the player showing up in view.
+*/
+void BotClient::CheckJoined( bot_clock::time_point now )
+{
+	if( m_state != BOT_WAITING_FOR_PLAYER || !m_player_authoritative || m_positions.count( m_player_id ) == 0 )
+	{
+		return;
+	}
+	m_join_seconds = std::chrono::duration<double>( now - m_join_start ).count();
+	m_state = BOT_PLAYING;
+	m_next_turn = now;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Move
+*/
+void BotClient::Move( bot_clock::time_point now )
+{
+	if( now < m_next_turn )
+	{
+		return;
+	}
+
+	// Start each bot at a different heading so they spread out.
+	float radians = (float)m_index * 2.39996f + (float)m_turns * 1.5707963f;
+	m_direction = Vec2( std::cos( radians ), std::sin( radians ) );
+	++m_turns;
+	m_next_turn = now + std::chrono::duration_cast<bot_clock::duration>( std::chrono::duration<float>( m_settings.move_change_seconds ) );
+
+	m_session.SendPlayerControls( m_player_id, m_direction * m_settings.move_speed );
+
+	auto position = m_positions.find( m_player_id );
+	if( position != m_positions.end() )
+	{
+		m_echo_pending = true;
+		m_echo_sent = now;
+		m_echo_origin = position->second;
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* OnPosition
+* The echo is the first position of our player that moved along the direction we last sent.
+*/
+void BotClient::OnPosition( worker::EntityId id, const Vec2& position, bot_clock::time_point now )
+{
+	m_positions[id] = position;
+	if( id != m_player_id )
+	{
+		return;
+	}
+	CheckJoined( now );
+
+	if( !m_echo_pending )
+	{
+		return;
+	}
+	Vec2 moved = position - m_echo_origin;
+	float along = moved.x * m_direction.x + moved.y * m_direction.y;
+	if( along >= m_settings.echo_min_distance )
+	{
+		m_echo_stats.Add( std::chrono::duration<double>( now - m_echo_sent ).count() );
+		m_echo_pending = false;
+	}
+}
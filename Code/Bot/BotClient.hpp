@@ -0,0 +1,121 @@
+#pragma once
+#include "Shared/WorkerConnection.hpp"
+#include "Shared/ClientSession.hpp"
+
+#include "Engine/Math/Vec2.hpp"
+
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+
+typedef std::chrono::steady_clock bot_clock;
+
+struct bot_settings_t
+{
+	float move_speed = 5.0f;				// Sent as PlayerControls, same scale as the Game's direction * speed.
+	float move_change_seconds = 1.0f;		// How long a bot holds a direction before turning.
+	float echo_min_distance = 0.01f;		// Movement along the new direction that counts as the echo.
+};
+
+struct latency_stats_t
+{
+	uint64_t count = 0;
+	double total_seconds = 0.0;
+	double min_seconds = 0.0;
+	double max_seconds = 0.0;
+
+	void Add( double seconds );
+	void Merge( const latency_stats_t& other );
+	double GetAverage() const { return count > 0 ? total_seconds / (double)count : 0.0; }
+};
+
+enum BotState
+{
+	BOT_FINDING_API,
+	BOT_WAITING_FOR_RESPONSE,
+	BOT_WAITING_FOR_PLAYER,
+	BOT_PLAYING,
+	BOT_FAILED
+};
+
+//--------------------------------------------------------------------------
+// One headless player. Joins through the same ClientSession flow as the Game client,
+// then walks its player around, turning 90 degrees every move_change_seconds.
+// Only tracks positions, from PlanePosition when an entity has it and Position otherwise,
+// everything else it receives is just counted.
+//--------------------------------------------------------------------------
+class BotClient
+	: public WorkerDispatcher
+{
+public:
+	BotClient( std::unique_ptr<WorkerConnection> connection, uint32_t index, const bot_settings_t& settings );
+	~BotClient();
+
+	BotClient( const BotClient& ) = delete;
+	BotClient& operator=( const BotClient& ) = delete;
+
+public:
+	void Update( bot_clock::time_point now );
+
+	bool IsConnected() const;
+	BotState GetState() const								{ return m_state; }
+	const std::string& GetWorkerId() const					{ return m_connection->GetWorkerId(); }
+
+	// Negative until the bot has its player.
+	double GetJoinSeconds() const							{ return m_join_seconds; }
+	const latency_stats_t& GetEchoStats() const				{ return m_echo_stats; }
+	const client_ping_stats_t& GetPingStats() const			{ return m_session.GetPingStats(); }
+
+	// Ops received since the last call.
+	uint64_t TakeReceivedCount();
+
+public:
+	// WorkerDispatcher, only here to count and to watch our own player.
+	void AddEntity( worker::EntityId id ) override;
+	void RemoveEntity( worker::EntityId id ) override;
+	void AddComponent( worker::EntityId id, const improbable::PositionData& data ) override;
+	void AddComponent( worker::EntityId /*id*/, const improbable::MetadataData& /*data*/ ) override			{ ++m_received; }
+	void AddComponent( worker::EntityId /*id*/, const siren::PlayerControlsData& /*data*/ ) override			{ ++m_received; }
+	void AddComponent( worker::EntityId id, const siren::PlanePositionData& data ) override;
+	void UpdateComponent( worker::EntityId id, const improbable::Position::Update& update ) override;
+	void UpdateComponent( worker::EntityId /*id*/, const improbable::Metadata::Update& /*update*/ ) override	{ ++m_received; }
+	void UpdateComponent( worker::EntityId /*id*/, const siren::PlayerControls::Update& /*update*/ ) override	{ ++m_received; }
+	void UpdateComponent( worker::EntityId id, const siren::PlanePosition::Update& update ) override;
+	void RemoveComponent( worker::EntityId id, worker::ComponentId component_id ) override;
+	void ChangeAuthority( worker::EntityId id, worker::ComponentId component_id, worker::Authority authority ) override;
+
+private:
+	void RequestPlayer( bot_clock::time_point now );
+	void CheckJoined( bot_clock::time_point now );
+	void Move( bot_clock::time_point now );
+	void OnPosition( worker::EntityId id, const Vec2& position, bot_clock::time_point now );
+
+private:
+	std::unique_ptr<WorkerConnection> m_connection;
+	ClientSession m_session;
+	uint32_t m_index = 0;
+	bot_settings_t m_settings;
+
+	BotState m_state = BOT_FINDING_API;
+	uint64_t m_create_request_id = 0;
+	bot_clock::time_point m_join_start;
+	double m_join_seconds = -1.0;
+
+	// Whichever entity we get PlayerControls authority on, that can happen before the command response.
+	worker::EntityId m_player_id = 0;
+	bool m_player_authoritative = false;
+	std::unordered_map<worker::EntityId, Vec2> m_positions;
+	std::unordered_map<worker::EntityId, siren::PlanePositionData> m_plane_positions;	// Updates only carry the fields that changed.
+
+	// Movement and echo timing
+	uint32_t m_turns = 0;
+	bot_clock::time_point m_next_turn;
+	Vec2 m_direction = Vec2::ZERO;
+	bool m_echo_pending = false;
+	bot_clock::time_point m_echo_sent;
+	Vec2 m_echo_origin = Vec2::ZERO;
+	latency_stats_t m_echo_stats;
+
+	uint64_t m_received = 0;
+
+};
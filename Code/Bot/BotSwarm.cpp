@@ -0,0 +1,185 @@
+#include "Bot/BotSwarm.hpp"
+
+#include "Shared/AsyncLog.hpp"
+#include "Shared/LocalWorkerBus.hpp"
+#include "Shared/SpatialOSConnection.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+//--------------------------------------------------------------------------
+/**
+* BotSwarm
+*/
+BotSwarm::BotSwarm( const bot_swarm_settings_t& settings )
+	: m_settings( settings )
+{
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* ~BotSwarm
+*/
+BotSwarm::~BotSwarm()
+{
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* ConnectLocal
+*/
+void BotSwarm::ConnectLocal( LocalWorkerBus& bus, uint32_t count )
+{
+	for( uint32_t idx = 0; idx < count; ++idx )
+	{
+		std::unique_ptr<WorkerConnection> connection( bus.Connect( "External", MakeWorkerId( (uint32_t)m_bots.size() ) ) );
+		m_bots.push_back( std::make_unique<BotClient>( std::move( connection ), (uint32_t)m_bots.size(), m_settings.bot ) );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* ConnectReceptionist
+*/
+bool BotSwarm::ConnectReceptionist( const std::string& hostname, uint16_t port, uint32_t count )
+{
+	worker::ConnectionParameters parameters;
+	parameters.WorkerType = "External";
+	parameters.Network.ConnectionType = worker::NetworkConnectionType::kTcp;
+	parameters.Network.UseExternalIp = true;
+
+	for( uint32_t idx = 0; idx < count; ++idx )
+	{
+		std::string worker_id = MakeWorkerId( (uint32_t)m_bots.size() );
+		auto future = worker::Connection::ConnectAsync( WorkerComponentRegistry{}, hostname, port, worker_id, parameters );
+		std::unique_ptr<WorkerConnection> connection = std::make_unique<SpatialOSConnection>( future.Get() );
+		if( !connection->IsConnected() )
+		{
+			LOG_WARNING( "Bot", "Bot %s failed to connect, stopping at %zu bots", worker_id.c_str(), m_bots.size() );
+			return false;
+		}
+		m_bots.push_back( std::make_unique<BotClient>( std::move( connection ), (uint32_t)m_bots.size(), m_settings.bot ) );
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Run
+*/
+void BotSwarm::Run( float run_seconds )
+{
+	const bot_clock::duration frame_period = std::chrono::duration_cast<bot_clock::duration>( std::chrono::duration<float>( 1.0f / m_settings.update_rate_hz ) );
+	const bot_clock::duration report_period = std::chrono::duration_cast<bot_clock::duration>( std::chrono::duration<float>( m_settings.report_interval_seconds ) );
+
+	bot_clock::time_point start = bot_clock::now();
+	bot_clock::time_point last_report = start;
+	bot_clock::time_point next_frame = start;
+
+	m_running = true;
+	while( m_running )
+	{
+		bot_clock::time_point now = bot_clock::now();
+		for( std::unique_ptr<BotClient>& bot : m_bots )
+		{
+			bot->Update( now );
+		}
+
+		now = bot_clock::now();
+		if( now - last_report >= report_period )
+		{
+			PrintReport( std::chrono::duration<double>( now - last_report ).count() );
+			last_report = now;
+		}
+
+		if( run_seconds > 0.0f && std::chrono::duration<float>( now - start ).count() >= run_seconds )
+		{
+			break;
+		}
+
+		// Behind means the bots can't keep up with the rate, don't try to catch up.
+		next_frame += frame_period;
+		if( next_frame > now )
+		{
+			std::this_thread::sleep_until( next_frame );
+		}
+		else
+		{
+			next_frame = now;
+		}
+	}
+	m_running = false;
+
+	PrintReport( std::chrono::duration<double>( bot_clock::now() - last_report ).count() );
+}
+
+//--------------------------------------------------------------------------
+/**
+* PrintReport
+* Receive rates cover the time since the last report, latencies the whole run.
+*/
+void BotSwarm::PrintReport( double elapsed_seconds )
+{
+	uint32_t state_counts[BOT_FAILED + 1] = {};
+	latency_stats_t join_stats;
+	latency_stats_t echo_stats;
+	latency_stats_t ping_stats;			// Each bot's smoothed RTT.
+	double max_jitter = 0.0;
+	double min_rate = 0.0;
+	double max_rate = 0.0;
+	double total_rate = 0.0;
+
+	for( size_t idx = 0; idx < m_bots.size(); ++idx )
+	{
+		BotClient& bot = *m_bots[idx];
+		++state_counts[bot.GetState()];
+		if( bot.GetJoinSeconds() >= 0.0 )
+		{
+			join_stats.Add( bot.GetJoinSeconds() );
+		}
+		echo_stats.Merge( bot.GetEchoStats() );
+		const client_ping_stats_t& ping = bot.GetPingStats();
+		if( ping.received > 0 )
+		{
+			ping_stats.Add( ping.smoothed_rtt_seconds );
+			max_jitter = std::max( max_jitter, ping.jitter_seconds );
+		}
+
+		double rate = elapsed_seconds > 0.0 ? (double)bot.TakeReceivedCount() / elapsed_seconds : 0.0;
+		min_rate = idx == 0 ? rate : std::min( min_rate, rate );
+		max_rate = idx == 0 ? rate : std::max( max_rate, rate );
+		total_rate += rate;
+	}
+	double average_rate = m_bots.empty() ? 0.0 : total_rate / (double)m_bots.size();
+
+	std::cout << "Bots: " << m_bots.size()
+		<< " playing " << state_counts[BOT_PLAYING]
+		<< " joining " << state_counts[BOT_FINDING_API] + state_counts[BOT_WAITING_FOR_RESPONSE] + state_counts[BOT_WAITING_FOR_PLAYER]
+		<< " failed " << state_counts[BOT_FAILED] << std::endl;
+	std::cout << "	Join:    " << join_stats.count << " avg " << join_stats.GetAverage() * 1000.0
+		<< "ms min " << join_stats.min_seconds * 1000.0 << "ms max " << join_stats.max_seconds * 1000.0 << "ms" << std::endl;
+	std::cout << "	Echo:    " << echo_stats.count << " avg " << echo_stats.GetAverage() * 1000.0
+		<< "ms min " << echo_stats.min_seconds * 1000.0 << "ms max " << echo_stats.max_seconds * 1000.0 << "ms" << std::endl;
+	std::cout << "	Ping:    " << ping_stats.count << " avg " << ping_stats.GetAverage() * 1000.0
+		<< "ms min " << ping_stats.min_seconds * 1000.0 << "ms max " << ping_stats.max_seconds * 1000.0 << "ms worst jitter " << max_jitter * 1000.0 << "ms" << std::endl;
+	std::cout << "	Receive: avg " << average_rate << " ops/s per bot, min " << min_rate << " max " << max_rate << std::endl;
+}
+
+//--------------------------------------------------------------------------
+/**
+* MakeWorkerId
+*/
+std::string BotSwarm::MakeWorkerId( uint32_t index ) const
+{
+	static const char charset[] = "0123456789ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz";
+	std::string suffix( 4, '0' );
+	for( char& c : suffix )
+	{
+		c = charset[std::rand() % ( sizeof( charset ) - 1 )];
+	}
+	return "Bot_" + std::to_string( index ) + "_" + suffix;
+}
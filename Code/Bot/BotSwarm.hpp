@@ -0,0 +1,45 @@
+#pragma once
+#include "Bot/BotClient.hpp"
+
+#include <atomic>
+#include <vector>
+
+class LocalWorkerBus;
+
+struct bot_swarm_settings_t
+{
+	float update_rate_hz = 30.0f;			// How often every bot processes and steers.
+	float report_interval_seconds = 5.0f;
+	bot_settings_t bot;
+};
+
+//--------------------------------------------------------------------------
+// N bots updated round robin from one thread, with a report of join latency,
+// input-to-position echo latency and how much each bot receives.
+//--------------------------------------------------------------------------
+class BotSwarm
+{
+public:
+	BotSwarm( const bot_swarm_settings_t& settings );
+	~BotSwarm();
+
+public:
+	// Either one connects count bots, worker ids are Bot_<index>_<random>.
+	void ConnectLocal( LocalWorkerBus& bus, uint32_t count );
+	bool ConnectReceptionist( const std::string& hostname, uint16_t port, uint32_t count );
+
+	// Runs until Stop or run_seconds is up, 0 for no limit.
+	void Run( float run_seconds );
+	void Stop() { m_running = false; }
+
+	void PrintReport( double elapsed_seconds );
+
+private:
+	std::string MakeWorkerId( uint32_t index ) const;
+
+private:
+	bot_swarm_settings_t m_settings;
+	std::vector<std::unique_ptr<BotClient>> m_bots;
+	std::atomic<bool> m_running{ false };
+
+};
@@ -0,0 +1,254 @@
+#include "Bot/BotSwarm.hpp"
+#include "Bot/CheckpointBench.hpp"
+#include "Bot/EntityStoreBench.hpp"
+#include "Bot/RegistryBench.hpp"
+#include "Bot/SpatialBench.hpp"
+#include "Bot/TemplateBench.hpp"
+#include "Bot/ViewBench.hpp"
+
+#include "Server/SpatialOSServer.hpp"
+#include "Server/ServerApp.hpp"
+#include "Server/ServerCommon.hpp"
+#include "Server/ServerConsole.hpp"
+
+#include "Shared/AsyncLog.hpp"
+#include "Shared/LocalWorkerBus.hpp"
+
+#include "Engine/Core/EngineCommon.hpp"
+#include "Engine/Core/Strings/NamedStrings.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+
+//-----------------------------------------------------------------------------------------------
+static void PrintUsage()
+{
+	std::cout << "Usage: Bot local <bot_count> [<seconds>]" << std::endl;
+	std::cout << "       Bot receptionist <hostname> <port> <bot_count> [<seconds>]" << std::endl;
+	std::cout << "       Bot viewbench <entity_count> [<rounds>]" << std::endl;
+	std::cout << "       Bot checkpointbench <entity_count> [<entity_type>]" << std::endl;
+	std::cout << "       Bot registrybench [<entity_count>] [<rounds>]" << std::endl;
+	std::cout << "       Bot spatialbench [<crawler_count>] [<player_count>] [<rounds>]" << std::endl;
+	std::cout << "       Bot storebench [<entity_count>] [<entity_type>]" << std::endl;
+	std::cout << "       Bot templatebench [<spawn_count>] [<entity_type>]" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Puts scripted players on the Managed worker" << std::endl;
+	std::cout << "    local            - runs the Managed sim in this process on a LocalWorkerBus." << std::endl;
+	std::cout << "    receptionist     - connects every bot to a deployment as an External worker." << std::endl;
+	std::cout << "    viewbench        - no bots, measures the Managed worker's View on its own." << std::endl;
+	std::cout << "    checkpointbench  - no bots, times a Managed worker restart with and without a world checkpoint." << std::endl;
+	std::cout << "    registrybench    - no bots, times a tick's entity info lookups from 100 entities up to <entity_count>." << std::endl;
+	std::cout << "    spatialbench     - no bots, times the crawlers' nearest player search by scan and by spatial hash." << std::endl;
+	std::cout << "    storebench       - no bots, times the Zone position integration with and without the entity store." << std::endl;
+	std::cout << "    templatebench    - no bots, times and counts the allocations of a spawn's entity, built and from a template." << std::endl;
+	std::cout << "    <bot_count>      - how many players to join." << std::endl;
+	std::cout << "    <seconds>        - (optional) how long to run, forever if left out." << std::endl;
+	std::cout << std::endl;
+}
+
+//-----------------------------------------------------------------------------------------------
+static bot_swarm_settings_t LoadSwarmSettings()
+{
+	bot_swarm_settings_t settings;
+	settings.update_rate_hz = g_gameConfigBlackboard.GetValue( "bot_rate", settings.update_rate_hz );
+	settings.report_interval_seconds = g_gameConfigBlackboard.GetValue( "bot_report_interval", settings.report_interval_seconds );
+	settings.bot.move_speed = g_gameConfigBlackboard.GetValue( "bot_move_speed", settings.bot.move_speed );
+	settings.bot.move_change_seconds = g_gameConfigBlackboard.GetValue( "bot_move_change_seconds", settings.bot.move_change_seconds );
+	return settings;
+}
+
+//-----------------------------------------------------------------------------------------------
+// Same as the Managed worker's Startup, the sim runs on this thread.
+static void StartupServerApp()
+{
+	g_theServerApp = new ServerApp();
+	g_theServerApp->Startup();
+}
+
+//-----------------------------------------------------------------------------------------------
+static void ShutdownServerApp()
+{
+	g_theServerApp->Shutdown();
+	delete g_theServerApp;
+	g_theServerApp = nullptr;
+}
+
+//-----------------------------------------------------------------------------------------------
+static int RunLocal( uint32_t bot_count, float run_seconds )
+{
+	SpatialOSServer::Startup( { "local", "Managed_bots" } );
+	StartupServerApp();
+
+	LocalWorkerBus* bus = SpatialOSServer::GetLocalBus();
+	if( !bus )
+	{
+		LOG_ERROR( "Bot", "Managed worker didn't start a local bus" );
+		return 1;
+	}
+
+	// Bots go before the bus so their players get deleted on the way out.
+	{
+		BotSwarm swarm( LoadSwarmSettings() );
+		swarm.ConnectLocal( *bus, bot_count );
+
+		std::atomic<bool> bots_done{ false };
+		std::thread bot_thread( [&]() {
+			swarm.Run( run_seconds );
+			bots_done = true;
+			} );
+
+		ServerConsole::Startup();
+		while( SpatialOSServer::IsRunning() && !bots_done )
+		{
+			ServerConsole::Pump();
+			g_theServerApp->RunFrame();
+			std::this_thread::yield();
+		}
+
+		swarm.Stop();
+		bot_thread.join();
+	}
+
+	ShutdownServerApp();
+	SpatialOSServer::Shutdown();
+	return 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+static int RunReceptionist( const std::string& hostname, uint16_t port, uint32_t bot_count, float run_seconds )
+{
+	BotSwarm swarm( LoadSwarmSettings() );
+	if( !swarm.ConnectReceptionist( hostname, port, bot_count ) )
+	{
+		return 1;
+	}
+	swarm.Run( run_seconds );
+	return 0;
+}
+
+//-----------------------------------------------------------------------------------------------
+static int Run( const std::vector<std::string>& arguments )
+{
+	if( arguments.size() >= 2 && arguments[0] == "local" )
+	{
+		float run_seconds = arguments.size() >= 3 ? (float)atof( arguments[2].c_str() ) : 0.0f;
+		return RunLocal( (uint32_t)atoi( arguments[1].c_str() ), run_seconds );
+	}
+	if( arguments.size() >= 4 && arguments[0] == "receptionist" )
+	{
+		float run_seconds = arguments.size() >= 5 ? (float)atof( arguments[4].c_str() ) : 0.0f;
+		return RunReceptionist( arguments[1], (uint16_t)atoi( arguments[2].c_str() ), (uint32_t)atoi( arguments[3].c_str() ), run_seconds );
+	}
+
+	if( arguments.size() >= 2 && arguments[0] == "viewbench" )
+	{
+		view_bench_settings_t settings;
+		settings.entity_count = (uint32_t)atoi( arguments[1].c_str() );
+		if( arguments.size() >= 3 )
+		{
+			settings.rounds = (uint32_t)atoi( arguments[2].c_str() );
+		}
+		RunViewBench( settings );
+		return 0;
+	}
+
+	if( arguments.size() >= 2 && arguments[0] == "checkpointbench" )
+	{
+		checkpoint_bench_settings_t settings;
+		settings.entity_count = (uint32_t)atoi( arguments[1].c_str() );
+		if( arguments.size() >= 3 )
+		{
+			settings.entity_type = arguments[2];
+		}
+		return RunCheckpointBench( settings );
+	}
+
+	if( arguments.size() >= 1 && arguments[0] == "registrybench" )
+	{
+		registry_bench_settings_t settings;
+		if( arguments.size() >= 2 )
+		{
+			settings.entity_count = (uint32_t)atoi( arguments[1].c_str() );
+		}
+		if( arguments.size() >= 3 )
+		{
+			settings.rounds = (uint32_t)atoi( arguments[2].c_str() );
+		}
+		RunRegistryBench( settings );
+		return 0;
+	}
+
+	if( arguments.size() >= 1 && arguments[0] == "spatialbench" )
+	{
+		spatial_bench_settings_t settings;
+		if( arguments.size() >= 2 )
+		{
+			settings.crawler_count = (uint32_t)atoi( arguments[1].c_str() );
+		}
+		if( arguments.size() >= 3 )
+		{
+			settings.player_count = (uint32_t)atoi( arguments[2].c_str() );
+		}
+		if( arguments.size() >= 4 )
+		{
+			settings.rounds = (uint32_t)atoi( arguments[3].c_str() );
+		}
+		return RunSpatialBench( settings );
+	}
+
+	if( arguments.size() >= 1 && arguments[0] == "storebench" )
+	{
+		entity_store_bench_settings_t settings;
+		if( arguments.size() >= 2 )
+		{
+			settings.entity_count = (uint32_t)atoi( arguments[1].c_str() );
+		}
+		if( arguments.size() >= 3 )
+		{
+			settings.entity_type = arguments[2];
+		}
+		return RunEntityStoreBench( settings );
+	}
+
+	if( arguments.size() >= 1 && arguments[0] == "templatebench" )
+	{
+		template_bench_settings_t settings;
+		if( arguments.size() >= 2 )
+		{
+			settings.spawn_count = (uint32_t)atoi( arguments[1].c_str() );
+		}
+		if( arguments.size() >= 3 )
+		{
+			settings.entity_type = arguments[2];
+		}
+		RunTemplateBench( settings );
+		return 0;
+	}
+
+	PrintUsage();
+	return 1;
+}
+
+// Entry point
+int main( int argc, char** argv ) 
+{
+	std::vector<std::string> arguments( argv + 1, argv + argc );
+	auto now = std::chrono::high_resolution_clock::now();
+	std::srand( (unsigned int)std::chrono::time_point_cast<std::chrono::nanoseconds>( now ).time_since_epoch().count() );
+
+	tinyxml2::XMLDocument config;
+	config.LoadFile( "Data/GameConfig.xml" );
+	XmlElement* root = config.RootElement();
+	if( root )
+	{
+		g_gameConfigBlackboard.PopulateFromXmlElementAttributes( *root );
+	}
+
+	AsyncLog::Startup();
+	int result = Run( arguments );
+	AsyncLog::Shutdown();
+	return result;
+}
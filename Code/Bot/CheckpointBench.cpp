@@ -0,0 +1,108 @@
+#include "Bot/CheckpointBench.hpp"
+
+#include "Server/SpatialOSServer.hpp"
+#include "Server/ServerApp.hpp"
+#include "Server/ServerCommon.hpp"
+#include "Server/WorldSim.hpp"
+
+#include "Shared/EntityBase.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <iostream>
+#include <thread>
+
+//--------------------------------------------------------------------------
+/**
+* RunUntil
+* Runs frames until done says so or the time is up, returns the seconds since start.
+*/
+template <typename F>
+static double RunUntil( std::chrono::steady_clock::time_point start, float timeout_seconds, F&& done )
+{
+	double seconds = 0.0;
+	do
+	{
+		g_theServerApp->RunFrame();
+		std::this_thread::yield();
+		seconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - start ).count();
+	} while( SpatialOSServer::IsRunning() && !done() && seconds < (double)timeout_seconds );
+	return seconds;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RunCheckpointBench
+*/
+int RunCheckpointBench( const checkpoint_bench_settings_t& settings )
+{
+	using bench_clock = std::chrono::steady_clock;
+
+	// The Managed worker's bus outlives both runs, same as the runtime outlives a worker restart.
+	SpatialOSServer::Startup( { "local", "Managed_checkpoint_bench" } );
+
+	// Cold, every entity goes through reserve, create and checkout.
+	bench_clock::time_point cold_start = bench_clock::now();
+	g_theServerApp = new ServerApp();
+	g_theServerApp->Startup();
+
+	uint32_t side = (uint32_t)std::ceil( std::sqrt( (double)settings.entity_count ) );
+	for( uint32_t idx = 0; idx < settings.entity_count; ++idx )
+	{
+		EntityBase* entity = g_theSim->CreateSimulatedEntity( settings.entity_type );
+		if( !entity )
+		{
+			std::cout << "Checkpoint bench: no definition for " << settings.entity_type << std::endl;
+			g_theServerApp->Shutdown();
+			SAFE_DELETE( g_theServerApp );
+			SpatialOSServer::Shutdown();
+			return 1;
+		}
+		entity->SetPosition( 2.0f * (float)( idx % side ), 2.0f * (float)( idx / side ) );
+		SpatialOSServer::RequestEntityCreation( entity );
+	}
+
+	uint64_t ticks_before = 0;
+	double cold_seconds = RunUntil( cold_start, settings.timeout_seconds, [&]() {
+		// Counted after the tick so the last tick had the whole world in it.
+		bool ticked = g_theServerApp->GetTickStats().ticks > ticks_before;
+		ticks_before = g_theServerApp->GetTickStats().ticks;
+		return ticked && SpatialOSServer::GetCreatedEntityCount() >= settings.entity_count;
+		} );
+	uint32_t cold_count = SpatialOSServer::GetCreatedEntityCount();
+
+	bool saved = SpatialOSServer::SaveWorldCheckpoint( settings.path );
+	g_theServerApp->Shutdown();
+	SAFE_DELETE( g_theServerApp );
+
+	// Warm, the same world out of the checkpoint.
+	double warm_seconds = 0.0;
+	uint32_t warm_count = 0;
+	if( saved )
+	{
+		bench_clock::time_point warm_start = bench_clock::now();
+		g_theServerApp = new ServerApp();
+		g_theServerApp->Startup();
+		warm_count = SpatialOSServer::LoadWorldCheckpoint( settings.path );
+		warm_seconds = RunUntil( warm_start, settings.timeout_seconds, []() { return g_theServerApp->GetTickStats().ticks > 0; } );
+
+		g_theServerApp->Shutdown();
+		SAFE_DELETE( g_theServerApp );
+		remove( settings.path.c_str() );
+	}
+
+	SpatialOSServer::Shutdown();
+
+	std::cout << "Checkpoint bench: " << settings.entity_count << " " << settings.entity_type << " entities" << std::endl;
+	std::cout << "	Cold:       " << cold_count << " entities, " << 1000.0 * cold_seconds << " ms to the first full tick" << std::endl;
+	if( saved )
+	{
+		std::cout << "	Checkpoint: " << warm_count << " entities, " << 1000.0 * warm_seconds << " ms to the first tick" << std::endl;
+	}
+	else
+	{
+		std::cout << "	Checkpoint: couldn't write " << settings.path << std::endl;
+	}
+	return saved && cold_count >= settings.entity_count ? 0 : 1;
+}
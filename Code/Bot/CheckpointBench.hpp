@@ -0,0 +1,18 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+//--------------------------------------------------------------------------
+// Times a Managed worker on a local bus from startup to its first tick with the
+// whole world in its Zone, once rebuilding it through reserve and create and
+// once loading it back from a world checkpoint.
+//--------------------------------------------------------------------------
+struct checkpoint_bench_settings_t
+{
+	uint32_t entity_count = 100000;
+	std::string entity_type = "player";
+	std::string path = "checkpoint_bench.wckp";		// Removed afterwards.
+	float timeout_seconds = 600.0f;					// Gives up on the cold path after this long.
+};
+
+int RunCheckpointBench( const checkpoint_bench_settings_t& settings );
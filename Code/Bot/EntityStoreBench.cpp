@@ -0,0 +1,184 @@
+#include "Bot/EntityStoreBench.hpp"
+
+#include "Server/SpatialOSServer.hpp"
+#include "Server/ServerApp.hpp"
+#include "Server/ServerCommon.hpp"
+#include "Server/WorldSim.hpp"
+
+#include "Shared/AbilityBase.hpp"
+#include "Shared/EntityBase.hpp"
+#include "Shared/Zone.hpp"
+
+#include "Engine/Physics/PhysicsSystem.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using bench_clock = std::chrono::high_resolution_clock;
+
+//--------------------------------------------------------------------------
+struct entity_store_bench_result_t
+{
+	uint32_t entity_count = 0;
+	double integrate_ms = 0.0;		// Per pass.
+	double tick_ms = 0.0;
+};
+
+//--------------------------------------------------------------------------
+/**
+* RandomFloat
+*/
+static float RandomFloat( float max )
+{
+	return max * ( (float)std::rand() / (float)RAND_MAX );
+}
+
+//--------------------------------------------------------------------------
+/**
+* IntegratePass
+* Zone::Update's entity phase and WorldSim's position broadcast, without the
+* controllers and physics step in between.
+*/
+static void IntegratePass( Zone* zone, float deltaSeconds )
+{
+	SpatialOSServer::AdvanceTickTime( deltaSeconds );
+	for( EntityBase* entity : zone->m_entities )
+	{
+		if( entity )
+		{
+			entity->Update( deltaSeconds );
+		}
+	}
+
+	if( EntityStore* store = zone->GetEntityStore() )
+	{
+		store->IntegrateProjectiles( deltaSeconds );
+		store->GatherPositions();
+
+		const Vec2* positions = store->GetPositions();
+		EntityBase* const* entities = store->GetEntities();
+		for( uint32_t idx = 0; idx < store->GetCount(); ++idx )
+		{
+			SpatialOSServer::UpdatePosition( entities[idx], positions[idx] );
+		}
+	}
+	else
+	{
+		for( EntityBase* entity : zone->m_entities )
+		{
+			if( entity )
+			{
+				SpatialOSServer::UpdatePosition( entity );
+			}
+		}
+	}
+	SpatialOSServer::FlushPositionUpdates();
+}
+
+//--------------------------------------------------------------------------
+/**
+* RunTicks
+* Average milliseconds per tick over the next count ticks.
+*/
+static double RunTicks( uint32_t count )
+{
+	tick_stats_t before = g_theServerApp->GetTickStats();
+	while( SpatialOSServer::IsRunning() && g_theServerApp->GetTickStats().ticks < before.ticks + count )
+	{
+		g_theServerApp->RunFrame();
+		std::this_thread::yield();
+	}
+	const tick_stats_t& after = g_theServerApp->GetTickStats();
+	return after.ticks > before.ticks ? 1000.0 * ( after.total_seconds - before.total_seconds ) / (double)( after.ticks - before.ticks ) : 0.0;
+}
+
+//--------------------------------------------------------------------------
+/**
+* MeasureZone
+*/
+static bool MeasureZone( bool use_entity_store, uint32_t entity_count, const entity_store_bench_settings_t& settings, entity_store_bench_result_t& result )
+{
+	// The store can only be switched on an empty zone.
+	Zone* zone = Zone::GetZone();
+	zone->Clear();
+	zone->m_physics_system->SetGravity( Vec2::ZERO );
+	zone->SetEntityStoreEnabled( use_entity_store );
+
+	for( uint32_t idx = 0; idx < entity_count; ++idx )
+	{
+		EntityBase* entity = g_theSim->CreateSimulatedEntity( settings.entity_type );
+		if( !entity )
+		{
+			std::cout << "Entity store bench: no definition for " << settings.entity_type << std::endl;
+			return false;
+		}
+		entity->SetPosition( RandomFloat( settings.world_size ), RandomFloat( settings.world_size ) );
+		if( entity->GetType() == ENTITY_ABILITY )
+		{
+			float angle = RandomFloat( 6.2831853f );
+			( (AbilityBase*) entity )->SetDirection( Vec2( cosf( angle ), sinf( angle ) ) );
+		}
+	}
+
+	result.entity_count = entity_count;
+
+	// One tick first so spawning isn't counted.
+	RunTicks( 1 );
+	result.tick_ms = RunTicks( settings.rounds );
+
+	float deltaSeconds = 1.0f / 60.0f;
+	bench_clock::time_point start = bench_clock::now();
+	for( uint32_t round = 0; round < settings.rounds; ++round )
+	{
+		IntegratePass( zone, deltaSeconds );
+	}
+	double seconds = std::chrono::duration<double>( bench_clock::now() - start ).count();
+	result.integrate_ms = settings.rounds > 0 ? 1000.0 * seconds / (double)settings.rounds : 0.0;
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RunEntityStoreBench
+*/
+int RunEntityStoreBench( const entity_store_bench_settings_t& settings )
+{
+	std::vector<uint32_t> counts;
+	for( uint32_t count : { 1000u, 10000u, 100000u } )
+	{
+		if( count < settings.entity_count )
+		{
+			counts.push_back( count );
+		}
+	}
+	counts.push_back( settings.entity_count );
+
+	SpatialOSServer::Startup( { "local", "Managed_entity_store_bench" } );
+	g_theServerApp = new ServerApp();
+	g_theServerApp->Startup();
+
+	bool ok = true;
+	std::cout << "Entity store bench: " << settings.entity_type << ", " << settings.rounds << " rounds per size" << std::endl;
+	for( uint32_t count : counts )
+	{
+		entity_store_bench_result_t entities;
+		entity_store_bench_result_t store;
+		ok = MeasureZone( false, count, settings, entities ) && MeasureZone( true, count, settings, store );
+		if( !ok )
+		{
+			break;
+		}
+		std::cout << "	" << count << " entities | integrate and broadcast: " << entities.integrate_ms << " ms entities, "
+			<< store.integrate_ms << " ms store | Zone tick: " << entities.tick_ms << " ms entities, "
+			<< store.tick_ms << " ms store" << std::endl;
+	}
+
+	g_theServerApp->Shutdown();
+	SAFE_DELETE( g_theServerApp );
+	SpatialOSServer::Shutdown();
+	return ok ? 0 : 1;
+}
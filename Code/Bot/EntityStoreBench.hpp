@@ -0,0 +1,19 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+//--------------------------------------------------------------------------
+// Fills the Managed worker's Zone with projectiles and times the per-entity
+// position integration and broadcast, once through the entities themselves and
+// once through the structure of arrays EntityStore, at 1k, 10k and 100k entities
+// up to entity_count. Then the whole Zone tick either way.
+//--------------------------------------------------------------------------
+struct entity_store_bench_settings_t
+{
+	uint32_t entity_count = 100000;
+	uint32_t rounds = 20;				// Integration passes and ticks at each size. Projectiles only live a second.
+	std::string entity_type = "basic_ranged";
+	float world_size = 500.0f;
+};
+
+int RunEntityStoreBench( const entity_store_bench_settings_t& settings );
@@ -0,0 +1,70 @@
+#include "Bot/HeapCounter.hpp"
+
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+
+//--------------------------------------------------------------------------
+// Every allocation carries its size in a header so frees can be subtracted.
+//--------------------------------------------------------------------------
+static std::atomic<int64_t> s_live_heap_bytes{ 0 };
+static std::atomic<uint64_t> s_heap_allocation_count{ 0 };
+static std::atomic<uint64_t> s_heap_allocated_bytes{ 0 };
+static constexpr size_t kAllocationHeaderSize = alignof( std::max_align_t );
+
+void* operator new( size_t size )
+{
+	void* block = std::malloc( size + kAllocationHeaderSize );
+	if( !block )
+	{
+		throw std::bad_alloc();
+	}
+	*(size_t*)block = size;
+	s_live_heap_bytes += (int64_t)size;
+	++s_heap_allocation_count;
+	s_heap_allocated_bytes += size;
+	return (char*)block + kAllocationHeaderSize;
+}
+
+void operator delete( void* pointer ) noexcept
+{
+	if( pointer )
+	{
+		void* block = (char*)pointer - kAllocationHeaderSize;
+		s_live_heap_bytes -= (int64_t)*(size_t*)block;
+		std::free( block );
+	}
+}
+
+void operator delete( void* pointer, size_t ) noexcept
+{
+	operator delete( pointer );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetLiveHeapBytes
+*/
+int64_t GetLiveHeapBytes()
+{
+	return s_live_heap_bytes;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetHeapAllocationCount
+*/
+uint64_t GetHeapAllocationCount()
+{
+	return s_heap_allocation_count;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetHeapAllocatedBytes
+*/
+uint64_t GetHeapAllocatedBytes()
+{
+	return s_heap_allocated_bytes;
+}
@@ -0,0 +1,10 @@
+#pragma once
+#include <cstdint>
+
+// Live heap bytes for the whole Bot process, HeapCounter.cpp replaces the global
+// operator new and delete to keep it. Only meaningful as a difference.
+int64_t GetLiveHeapBytes();
+
+// Calls to operator new so far, and the bytes they asked for.
+uint64_t GetHeapAllocationCount();
+uint64_t GetHeapAllocatedBytes();
@@ -0,0 +1,138 @@
+#include "Bot/RegistryBench.hpp"
+
+#include "Server/EntityInfoRegistry.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <vector>
+
+using bench_clock = std::chrono::high_resolution_clock;
+
+//--------------------------------------------------------------------------
+struct registry_bench_result_t
+{
+	uint32_t entity_count = 0;
+	double by_entity_us = 0.0;		// Per tick, every entity looked up once.
+	double by_entity_id_us = 0.0;
+	double by_request_us = 0.0;		// Creation and deletion request, every entity once each.
+	double list_scan_us = 0.0;		// By entity through the old list, scaled up from the sample.
+	uint64_t missed = 0;			// Lookups that came back empty, should always be 0.
+};
+
+//--------------------------------------------------------------------------
+/**
+* TimeTicks
+* Microseconds per tick, averaged over rounds.
+*/
+template <typename F>
+static double TimeTicks( uint32_t rounds, F&& tick )
+{
+	bench_clock::time_point start = bench_clock::now();
+	for( uint32_t round = 0; round < rounds; ++round )
+	{
+		tick();
+	}
+	double seconds = std::chrono::duration<double>( bench_clock::now() - start ).count();
+	return rounds > 0 ? 1000000.0 * seconds / (double)rounds : 0.0;
+}
+
+//--------------------------------------------------------------------------
+/**
+* MeasureRegistry
+*/
+static registry_bench_result_t MeasureRegistry( uint32_t entity_count, const registry_bench_settings_t& settings )
+{
+	registry_bench_result_t result;
+	result.entity_count = entity_count;
+	worker::EntityId first_id = 100;
+	uint64_t first_request_id = 1000;
+
+	// Only their addresses are used, as keys.
+	std::vector<char> entities( entity_count );
+	auto entity_at = [&]( uint32_t idx ) { return reinterpret_cast<EntityBase*>( &entities[idx] ); };
+
+	EntityInfoRegistry registry;
+	std::vector<entity_info_t> list;
+	list.reserve( entity_count );
+	for( uint32_t idx = 0; idx < entity_count; ++idx )
+	{
+		entity_info_t info;
+		info.game_entity = entity_at( idx );
+		info.id = first_id + idx;
+		info.entity_creation_request_id = first_request_id + 2 * idx;
+		info.entity_deletion_request_id = first_request_id + 2 * idx + 1;
+		registry.Add( info );
+		list.push_back( info );
+	}
+
+	uint64_t found = 0;
+	result.by_entity_us = TimeTicks( settings.rounds, [&]() {
+		for( uint32_t idx = 0; idx < entity_count; ++idx )
+		{
+			found += registry.FindWithEntity( entity_at( idx ) ) ? 1 : 0;
+		}
+		} );
+	result.by_entity_id_us = TimeTicks( settings.rounds, [&]() {
+		for( uint32_t idx = 0; idx < entity_count; ++idx )
+		{
+			found += registry.FindWithEntityId( first_id + idx ) ? 1 : 0;
+		}
+		} );
+	result.by_request_us = TimeTicks( settings.rounds, [&]() {
+		for( uint32_t idx = 0; idx < entity_count; ++idx )
+		{
+			found += registry.FindWithCreationRequest( first_request_id + 2 * idx ) ? 1 : 0;
+			found += registry.FindWithDeletionRequest( first_request_id + 2 * idx + 1 ) ? 1 : 0;
+		}
+		} );
+
+	// The list is what GetInfoWithEnity scanned before the registry, a whole tick of it is O(N^2).
+	uint32_t sample = std::min( settings.linear_sample, entity_count );
+	double sample_us = TimeTicks( settings.rounds, [&]() {
+		for( uint32_t step = 0; step < sample; ++step )
+		{
+			EntityBase* entity = entity_at( (uint32_t)( (uint64_t)step * entity_count / sample ) );
+			auto itr = std::find_if( list.begin(), list.end(), [&]( const entity_info_t& info ) { return info.game_entity == entity; } );
+			found += itr != list.end() ? 1 : 0;
+		}
+		} );
+	result.list_scan_us = sample > 0 ? sample_us * (double)entity_count / (double)sample : 0.0;
+
+	uint64_t expected = (uint64_t)settings.rounds * ( 4 * (uint64_t)entity_count + sample );
+	result.missed = expected - found;
+	return result;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RunRegistryBench
+*/
+void RunRegistryBench( const registry_bench_settings_t& settings )
+{
+	std::vector<uint32_t> counts;
+	for( uint32_t count : { 100u, 1000u, 10000u, 50000u } )
+	{
+		if( count < settings.entity_count )
+		{
+			counts.push_back( count );
+		}
+	}
+	counts.push_back( settings.entity_count );
+
+	std::cout << "Registry bench: " << settings.rounds << " ticks per size" << std::endl;
+	for( uint32_t count : counts )
+	{
+		registry_bench_result_t result = MeasureRegistry( count, settings );
+		// Flat per lookup is what keeps the whole tick linear.
+		double per_lookup = 1000.0 / (double)( count > 0 ? count : 1 );
+		std::cout << "	" << result.entity_count << " entities | by entity: " << result.by_entity_us << " us/tick (" << result.by_entity_us * per_lookup
+			<< " ns/lookup) by entity id: " << result.by_entity_id_us
+			<< " us/tick by request: " << result.by_request_us
+			<< " us/tick | list scan: " << result.list_scan_us << " us/tick (" << result.list_scan_us * per_lookup << " ns/lookup)" << std::endl;
+		if( result.missed > 0 )
+		{
+			std::cout << "	" << result.missed << " lookups missed" << std::endl;
+		}
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+
+//--------------------------------------------------------------------------
+// Times the lookups a Managed worker tick makes into its entity infos, one per
+// entity by game entity and by entity id plus the request id lookups, at world
+// sizes from 100 up to entity_count, next to the linear list scan it replaced.
+//--------------------------------------------------------------------------
+struct registry_bench_settings_t
+{
+	uint32_t entity_count = 50000;
+	uint32_t rounds = 100;				// Ticks timed at each size.
+	uint32_t linear_sample = 1000;		// The list scan is O(N) per lookup, only this many are timed per tick and scaled up.
+};
+
+void RunRegistryBench( const registry_bench_settings_t& settings );
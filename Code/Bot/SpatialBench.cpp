@@ -0,0 +1,152 @@
+#include "Bot/SpatialBench.hpp"
+
+#include "Server/SpatialOSServer.hpp"
+#include "Server/ServerApp.hpp"
+#include "Server/ServerCommon.hpp"
+#include "Server/WorldSim.hpp"
+
+#include "Shared/EntityBase.hpp"
+#include "Shared/Zone.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <thread>
+#include <vector>
+
+using bench_clock = std::chrono::high_resolution_clock;
+
+//--------------------------------------------------------------------------
+/**
+* FindClosestPlayerByScan
+* AIController::FindClosestPlayer before the Zone had a SpatialHash.
+*/
+static EntityBase* FindClosestPlayerByScan( Zone* zone, EntityBase* crawler, float search_range )
+{
+	float closestDist = search_range;
+	EntityBase* toRet = nullptr;
+	for( EntityBase* entity : zone->m_entities )
+	{
+		if( entity && entity->GetName() == "player" )
+		{
+			Vec2 disp = entity->GetPosition() - crawler->GetPosition();
+			float dist = disp.GetLength();
+			if( dist < closestDist )
+			{
+				toRet = entity;
+				closestDist = dist;
+			}
+		}
+	}
+	return toRet;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SpawnScattered
+*/
+static bool SpawnScattered( const std::string& entity_type, uint32_t count, float world_size, std::vector<EntityBase*>& spawned )
+{
+	for( uint32_t idx = 0; idx < count; ++idx )
+	{
+		EntityBase* entity = g_theSim->CreateSimulatedEntity( entity_type );
+		if( !entity )
+		{
+			std::cout << "Spatial bench: no definition for " << entity_type << std::endl;
+			return false;
+		}
+		float x = world_size * ( (float)std::rand() / (float)RAND_MAX );
+		float y = world_size * ( (float)std::rand() / (float)RAND_MAX );
+		entity->SetPosition( x, y );
+		spawned.push_back( entity );
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RunSpatialBench
+*/
+int RunSpatialBench( const spatial_bench_settings_t& settings )
+{
+	// Same search range the AIController uses.
+	const float search_range = 5.0f;
+
+	SpatialOSServer::Startup( { "local", "Managed_spatial_bench" } );
+	g_theServerApp = new ServerApp();
+	g_theServerApp->Startup();
+
+	std::vector<EntityBase*> crawlers;
+	std::vector<EntityBase*> players;
+	bool spawned = SpawnScattered( "crawler", settings.crawler_count, settings.world_size, crawlers )
+		&& SpawnScattered( "player", settings.player_count, settings.world_size, players );
+
+	double scan_seconds = 0.0;
+	double hash_seconds = 0.0;
+	uint64_t found = 0;
+	uint64_t disagreed = 0;
+	double tick_ms = 0.0;
+	if( spawned )
+	{
+		// One tick first so the hash holds everything that was just spawned.
+		uint64_t first_tick = g_theServerApp->GetTickStats().ticks;
+		while( SpatialOSServer::IsRunning() && g_theServerApp->GetTickStats().ticks == first_tick )
+		{
+			g_theServerApp->RunFrame();
+			std::this_thread::yield();
+		}
+
+		Zone* zone = Zone::GetZone();
+		const SpatialHash& hash = zone->GetSpatialHash();
+		EntityTypeId player_type = EntityTypeRegistry::Find( "player" );
+		std::vector<EntityBase*> scan_results( crawlers.size() );
+		for( uint32_t round = 0; round < settings.rounds; ++round )
+		{
+			bench_clock::time_point start = bench_clock::now();
+			for( size_t idx = 0; idx < crawlers.size(); ++idx )
+			{
+				scan_results[idx] = FindClosestPlayerByScan( zone, crawlers[idx], search_range );
+			}
+			scan_seconds += std::chrono::duration<double>( bench_clock::now() - start ).count();
+
+			start = bench_clock::now();
+			for( size_t idx = 0; idx < crawlers.size(); ++idx )
+			{
+				EntityBase* closest = hash.FindNearest( crawlers[idx]->GetPosition(), search_range, player_type, crawlers[idx] );
+				found += closest ? 1 : 0;
+				disagreed += closest != scan_results[idx] ? 1 : 0;
+			}
+			hash_seconds += std::chrono::duration<double>( bench_clock::now() - start ).count();
+		}
+
+		// The real thing, controllers through the hash plus physics and the position broadcast.
+		tick_stats_t before = g_theServerApp->GetTickStats();
+		while( SpatialOSServer::IsRunning() && g_theServerApp->GetTickStats().ticks < before.ticks + settings.rounds )
+		{
+			g_theServerApp->RunFrame();
+			std::this_thread::yield();
+		}
+		const tick_stats_t& after = g_theServerApp->GetTickStats();
+		if( after.ticks > before.ticks )
+		{
+			tick_ms = 1000.0 * ( after.total_seconds - before.total_seconds ) / (double)( after.ticks - before.ticks );
+		}
+	}
+
+	g_theServerApp->Shutdown();
+	SAFE_DELETE( g_theServerApp );
+	SpatialOSServer::Shutdown();
+	if( !spawned )
+	{
+		return 1;
+	}
+
+	double rounds = settings.rounds > 0 ? (double)settings.rounds : 1.0;
+	std::cout << "Spatial bench: " << settings.crawler_count << " crawlers, " << settings.player_count << " players over "
+		<< settings.world_size << "x" << settings.world_size << ", " << settings.rounds << " rounds" << std::endl;
+	std::cout << "	Scan:         " << 1000.0 * scan_seconds / rounds << " ms per pass over every crawler" << std::endl;
+	std::cout << "	Spatial hash: " << 1000.0 * hash_seconds / rounds << " ms per pass, "
+		<< (double)found / rounds << " crawlers with a player in range, " << disagreed << " answers differed from the scan" << std::endl;
+	std::cout << "	Zone tick:    " << tick_ms << " ms" << std::endl;
+	return 0;
+}
@@ -0,0 +1,17 @@
+#pragma once
+#include <cstdint>
+
+//--------------------------------------------------------------------------
+// Fills the Managed worker's Zone with AI crawlers and players and times the
+// crawlers' nearest player search, once as the scan over every entity it used
+// to be and once through the Zone's SpatialHash, then the whole Zone tick.
+//--------------------------------------------------------------------------
+struct spatial_bench_settings_t
+{
+	uint32_t crawler_count = 10000;
+	uint32_t player_count = 500;
+	uint32_t rounds = 30;
+	float world_size = 200.0f;			// Side of the square everything is scattered over.
+};
+
+int RunSpatialBench( const spatial_bench_settings_t& settings );
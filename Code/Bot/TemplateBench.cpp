@@ -0,0 +1,74 @@
+#include "Bot/TemplateBench.hpp"
+#include "Bot/HeapCounter.hpp"
+
+#include "Server/EntityTemplateCache.hpp"
+
+#include <chrono>
+#include <iostream>
+
+using bench_clock = std::chrono::high_resolution_clock;
+
+//--------------------------------------------------------------------------
+struct template_bench_result_t
+{
+	double us = 0.0;				// Per spawn.
+	double allocations = 0.0;		// Per spawn, the entity's own teardown included.
+	double allocated_bytes = 0.0;
+};
+
+//--------------------------------------------------------------------------
+/**
+* MeasureSpawns
+*/
+template <typename F>
+static template_bench_result_t MeasureSpawns( uint32_t spawn_count, F&& build )
+{
+	template_bench_result_t result;
+	uint64_t allocations_before = GetHeapAllocationCount();
+	uint64_t bytes_before = GetHeapAllocatedBytes();
+	bench_clock::time_point start = bench_clock::now();
+	for( uint32_t idx = 0; idx < spawn_count; ++idx )
+	{
+		worker::Entity entity = build( Vec2( (float)( idx % 1000 ), (float)( idx / 1000 ) ) );
+	}
+	double seconds = std::chrono::duration<double>( bench_clock::now() - start ).count();
+	if( spawn_count > 0 )
+	{
+		result.us = 1000000.0 * seconds / (double)spawn_count;
+		result.allocations = (double)( GetHeapAllocationCount() - allocations_before ) / (double)spawn_count;
+		result.allocated_bytes = (double)( GetHeapAllocatedBytes() - bytes_before ) / (double)spawn_count;
+	}
+	return result;
+}
+
+//--------------------------------------------------------------------------
+/**
+* PrintResult
+*/
+static void PrintResult( const char* label, const template_bench_result_t& built, const template_bench_result_t& copied )
+{
+	std::cout << "	" << label << " | built: " << built.us << " us, " << built.allocations << " allocations, " << built.allocated_bytes
+		<< " bytes | template: " << copied.us << " us, " << copied.allocations << " allocations, " << copied.allocated_bytes << " bytes" << std::endl;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RunTemplateBench
+*/
+void RunTemplateBench( const template_bench_settings_t& settings )
+{
+	EntityTypeId type_id = EntityTypeRegistry::Intern( settings.entity_type );
+	const std::string owner_id = "Bot_template_bench";
+
+	// Built ahead, the cache pays for its templates once at startup.
+	EntityTemplateCache templates;
+	templates.Build();
+
+	std::cout << "Template bench: " << settings.spawn_count << " spawns of " << settings.entity_type << ", per spawn" << std::endl;
+	PrintResult( "simulation owned",
+		MeasureSpawns( settings.spawn_count, [&]( const Vec2& position ) { return EntityTemplateCache::BuildEntity( settings.entity_type, position, "" ); } ),
+		MeasureSpawns( settings.spawn_count, [&]( const Vec2& position ) { return templates.Make( type_id, position, "" ); } ) );
+	PrintResult( "client owned",
+		MeasureSpawns( settings.spawn_count, [&]( const Vec2& position ) { return EntityTemplateCache::BuildEntity( settings.entity_type, position, owner_id ); } ),
+		MeasureSpawns( settings.spawn_count, [&]( const Vec2& position ) { return templates.Make( type_id, position, owner_id ); } ) );
+}
@@ -0,0 +1,16 @@
+#pragma once
+#include <cstdint>
+#include <string>
+
+//--------------------------------------------------------------------------
+// Builds the worker::Entity for spawn_count spawns of entity_type, from scratch
+// and copied from an EntityTemplateCache, for a simulation owned and a client
+// owned entity, and reports the time and heap allocations per spawn.
+//--------------------------------------------------------------------------
+struct template_bench_settings_t
+{
+	uint32_t spawn_count = 100000;
+	std::string entity_type = "player";
+};
+
+void RunTemplateBench( const template_bench_settings_t& settings );
@@ -0,0 +1,139 @@
+#include "Bot/ViewBench.hpp"
+#include "Bot/HeapCounter.hpp"
+
+#include "Server/View.hpp"
+#include "Shared/AsyncLog.hpp"
+
+#include <chrono>
+#include <iostream>
+#include <memory>
+
+//--------------------------------------------------------------------------
+// The View as it was, a worker::Entity and an authority map per entity.
+//--------------------------------------------------------------------------
+class EntityMapView
+	: public WorkerDispatcher
+{
+public:
+	struct entity_tracker_t
+	{
+		worker::Entity worker_entity;
+		bool updated = false;
+	};
+
+	void AddEntity( worker::EntityId id ) override														{ m_entities[id]; m_component_authority[id]; }
+	void RemoveEntity( worker::EntityId id ) override													{ m_entities.erase( id ); m_component_authority.erase( id ); }
+	void AddComponent( worker::EntityId id, const improbable::PositionData& data ) override				{ TrackAdd<improbable::Position>( id, data ); }
+	void AddComponent( worker::EntityId id, const improbable::MetadataData& data ) override				{ TrackAdd<improbable::Metadata>( id, data ); }
+	void AddComponent( worker::EntityId id, const siren::PlayerControlsData& data ) override			{ TrackAdd<siren::PlayerControls>( id, data ); }
+	void UpdateComponent( worker::EntityId id, const improbable::Position::Update& update ) override	{ TrackUpdate<improbable::Position>( id, update ); }
+	void UpdateComponent( worker::EntityId id, const improbable::Metadata::Update& update ) override	{ TrackUpdate<improbable::Metadata>( id, update ); }
+	void UpdateComponent( worker::EntityId id, const siren::PlayerControls::Update& update ) override	{ TrackUpdate<siren::PlayerControls>( id, update ); }
+	void ChangeAuthority( worker::EntityId id, worker::ComponentId component_id, worker::Authority authority ) override
+	{
+		m_component_authority[id][component_id] = authority;
+	}
+
+private:
+	template <typename T>
+	void TrackAdd( worker::EntityId id, const typename T::Data& data )
+	{
+		auto it = m_entities.find( id );
+		if( it != m_entities.end() ) {
+			it->second.worker_entity.Add<T>( data );
+			it->second.updated = true;
+		}
+	}
+
+	template <typename T>
+	void TrackUpdate( worker::EntityId id, const typename T::Update& update )
+	{
+		auto it = m_entities.find( id );
+		if( it != m_entities.end() && it->second.worker_entity.Get<T>() ) {
+			it->second.worker_entity.Update<T>( update );
+			it->second.updated = true;
+		}
+	}
+
+private:
+	worker::Map<worker::EntityId, entity_tracker_t> m_entities;
+	worker::Map<worker::EntityId, worker::Map<worker::ComponentId, worker::Authority>> m_component_authority;
+};
+
+//--------------------------------------------------------------------------
+struct view_bench_result_t
+{
+	double bytes_per_entity = 0.0;
+	double ops_per_second = 0.0;
+};
+
+//--------------------------------------------------------------------------
+// Checks out every entity the way a player entity arrives, then times rounds of
+// updates. between_rounds runs untimed after each round, for the View's cleanup.
+//--------------------------------------------------------------------------
+template <typename V, typename F>
+static view_bench_result_t MeasureView( const view_bench_settings_t& settings, F&& between_rounds )
+{
+	using bench_clock = std::chrono::high_resolution_clock;
+	view_bench_result_t result;
+	worker::EntityId first_id = 100;
+
+	// The View logs every entity it checks out.
+	AsyncLog::SetLevel( LOG_LEVEL_INFO );
+
+	int64_t heap_before = GetLiveHeapBytes();
+	std::unique_ptr<V> view( new V() );
+	for( uint32_t idx = 0; idx < settings.entity_count; ++idx )
+	{
+		worker::EntityId id = first_id + idx;
+		view->AddEntity( id );
+		view->AddComponent( id, improbable::PositionData( improbable::Coordinates( (double)idx, 0.0, 0.0 ) ) );
+		view->AddComponent( id, improbable::MetadataData( "Player" ) );
+		view->AddComponent( id, siren::PlayerControlsData( 0.0f, 0.0f ) );
+		view->ChangeAuthority( id, improbable::Position::ComponentId, worker::Authority::kAuthoritative );
+	}
+	between_rounds( *view );
+	result.bytes_per_entity = settings.entity_count > 0 ? (double)( GetLiveHeapBytes() - heap_before ) / (double)settings.entity_count : 0.0;
+
+	AsyncLog::SetLevel( LOG_LEVEL_DEBUG );
+
+	improbable::Position::Update position_update;
+	siren::PlayerControls::Update controls_update;
+	double seconds = 0.0;
+	for( uint32_t round = 0; round < settings.rounds; ++round )
+	{
+		position_update.set_coords( improbable::Coordinates( (double)round, 0.0, 1.0 ) );
+		controls_update.set_x_move( round & 1 ? 1.0f : -1.0f );
+
+		bench_clock::time_point start = bench_clock::now();
+		for( uint32_t idx = 0; idx < settings.entity_count; ++idx )
+		{
+			worker::EntityId id = first_id + idx;
+			view->UpdateComponent( id, position_update );
+			view->UpdateComponent( id, controls_update );
+		}
+		seconds += std::chrono::duration<double>( bench_clock::now() - start ).count();
+
+		between_rounds( *view );
+	}
+
+	double op_count = 2.0 * (double)settings.entity_count * (double)settings.rounds;
+	result.ops_per_second = seconds > 0.0 ? op_count / seconds : 0.0;
+	return result;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RunViewBench
+*/
+void RunViewBench( const view_bench_settings_t& settings )
+{
+	view_bench_result_t entity_map = MeasureView<EntityMapView>( settings, []( EntityMapView& ) {} );
+	view_bench_result_t dense = MeasureView<View>( settings, []( View& view ) { view.CleanupGarbage(); } );
+
+	std::cout << "View bench: " << settings.entity_count << " entities, " << settings.rounds << " rounds" << std::endl;
+	std::cout << "	worker::Entity map: " << entity_map.bytes_per_entity << " bytes/entity, "
+		<< entity_map.ops_per_second / 1000000.0 << "M ops/s" << std::endl;
+	std::cout << "	Component arrays:   " << dense.bytes_per_entity << " bytes/entity, "
+		<< dense.ops_per_second / 1000000.0 << "M ops/s" << std::endl;
+}
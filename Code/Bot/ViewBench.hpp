@@ -0,0 +1,15 @@
+#pragma once
+#include <cstdint>
+
+//--------------------------------------------------------------------------
+// Feeds the Managed worker's View the ops a busy deployment would and reports
+// heap bytes per entity and component update throughput, next to the
+// worker::Entity per entity layout the View used to have.
+//--------------------------------------------------------------------------
+struct view_bench_settings_t
+{
+	uint32_t entity_count = 10000;
+	uint32_t rounds = 100;			// Each round updates Position and PlayerControls on every entity.
+};
+
+void RunViewBench( const view_bench_settings_t& settings );
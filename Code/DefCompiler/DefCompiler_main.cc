@@ -0,0 +1,33 @@
+#include "Shared/AsyncLog.hpp"
+#include "Shared/SharedCommon.hpp"
+
+#include <iostream>
+#include <string>
+
+//-----------------------------------------------------------------------------------------------
+static void PrintUsage()
+{
+	std::cout << "Usage: DefCompiler [<output>]" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Compiles Data/Gameplay's definition XML into the cache workers and clients load at startup." << std::endl;
+	std::cout << "Run from Run/ after editing the XML, a stale cache is ignored." << std::endl;
+	std::cout << "    <output>            - cache to write, " << DEFINITION_CACHE_PATH << " by default." << std::endl;
+	std::cout << std::endl;
+}
+
+// Entry point
+int main( int argc, char** argv )
+{
+	if( argc > 2 || ( argc == 2 && argv[1][0] == '-' ) )
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	AsyncLog::Startup();
+	std::string output_path = argc == 2 ? argv[1] : DEFINITION_CACHE_PATH;
+	bool compiled = CompileDefinitions( output_path );
+	std::cout << ( compiled ? "Wrote " : "Failed writing " ) << output_path << std::endl;
+	AsyncLog::Shutdown();
+	return compiled ? 0 : 1;
+}
@@ -14,6 +14,16 @@ ActorRenderable::ActorRenderable( const std::string& name )
 	
 }
 
+//--------------------------------------------------------------------------
+/**
+* ActorRenderable
+*/
+ActorRenderable::ActorRenderable( EntityTypeId type_id )
+	: ActorBase( type_id )
+{
+
+}
+
 //--------------------------------------------------------------------------
 /**
 * ~EntityBase
@@ -30,15 +40,19 @@ ActorRenderable::~ActorRenderable()
 void ActorRenderable::Render() const
 {
 	std::vector<Vertex_PCU> verts;
+	static const EntityTypeId player_type = EntityTypeRegistry::Intern( "player" );
+	static const EntityTypeId crawler_type = EntityTypeRegistry::Intern( "crawler" );
+	static const EntityTypeId turret_type = EntityTypeRegistry::Intern( "turret" );
+
 	AABB2 box( 1.0f, 1.0f, m_transform.m_position );
-	if( m_name == "player" )
+	if( m_type_id == player_type )
 	{
 		Vec2 mins( 0.f, 0.75f );
 		Vec2 maxs( 0.25f, 1.0f );
 		g_theRenderer->BindTextureView( 0, (TextureView*) g_theRenderer->CreateOrGetTextureViewFromFile( "Data/Images/Engineer.png" ) );
 		AddVertsForAABB2D( verts, box, Rgba::WHITE, mins, maxs );
 	}
-	if( m_name == "crawler" )
+	else if( m_type_id == crawler_type )
 	{
 		Vec2 mins(0.f, 0.f);
 		Vec2 maxs(1.0f / 8.0f, 1.0f / 8.0f);
@@ -46,7 +60,7 @@ void ActorRenderable::Render() const
 		AddVertsForAABB2D(verts, box, Rgba::WHITE, mins, maxs);
 
 	}
-	if( m_name == "turret" )
+	else if( m_type_id == turret_type )
 	{
 		Vec2 mins(0.7f, 9.0f / 10.0f);
 		Vec2 maxs(0.8f, 1.0f);
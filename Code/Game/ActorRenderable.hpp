@@ -11,6 +11,7 @@ class ActorRenderable : public ActorBase
 {
 public:
 	ActorRenderable( const std::string& name );
+	ActorRenderable( EntityTypeId type_id );
 	virtual ~ActorRenderable();
 
 	virtual void Render() const;
@@ -24,8 +24,11 @@
 #include "Game/GameCommon.hpp"
 #include "Game/SpatialOSClient.hpp"
 
+#include "Shared/AsyncLog.hpp"
 #include "Shared/Zone.hpp"
 
+#include <iostream>
+
 //--------------------------------------------------------------------------
 // Global Singletons
 //--------------------------------------------------------------------------
@@ -46,6 +49,7 @@ ImGUISystem* g_theImGUISystem = nullptr;
 */
 void App::Startup()
 {
+	AsyncLog::Startup();
 	g_theRNG = new RNG();
 	g_theEventSystem = new EventSystem();
 	g_theConsole = new DevConsole( "SquirrelFixedFont" );
@@ -108,6 +112,8 @@ void App::Shutdown()
 	SAFE_DELETE(g_theRenderer);
 	SAFE_DELETE(g_theEventSystem);
 	SAFE_DELETE(g_theRNG);
+
+	AsyncLog::Shutdown();
 }
 
 //--------------------------------------------------------------------------
@@ -294,6 +300,61 @@ bool App::QuitEvent( EventArgs& args )
 	return true;
 }
 
+//--------------------------------------------------------------------------
+/**
+* PredictionStatsEvent
+*/
+bool App::PredictionStatsEvent( EventArgs& args )
+{
+	UNUSED( args );
+	const prediction_error_stats_t& stats = SpatialOSClient::GetPredictionStats();
+	double average_error = stats.corrections > 0 ? stats.total_error / (double)stats.corrections : 0.0;
+	std::cout << "Prediction | corrections: " << stats.corrections << " resets: " << stats.resets 
+		<< " avg error: " << average_error << " max error: " << stats.max_error << std::endl;
+
+	float lower = 0.0f;
+	for( int bucket = 0; bucket < PREDICTION_ERROR_BUCKET_COUNT; ++bucket )
+	{
+		std::cout << "	" << lower;
+		if( bucket < PREDICTION_ERROR_BUCKET_COUNT - 1 )
+		{
+			lower = PREDICTION_ERROR_BUCKET_LIMITS[bucket];
+			std::cout << " - " << lower;
+		}
+		else
+		{
+			std::cout << " and up";
+		}
+		std::cout << " units: " << stats.histogram[bucket] << std::endl;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* PredictionStatsResetEvent
+*/
+bool App::PredictionStatsResetEvent( EventArgs& args )
+{
+	UNUSED( args );
+	SpatialOSClient::ResetPredictionStats();
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* PingStatsEvent
+*/
+bool App::PingStatsEvent( EventArgs& args )
+{
+	UNUSED( args );
+	client_ping_stats_t stats = SpatialOSClient::GetPingStats();
+	std::cout << "Pings | sent: " << stats.sent << " received: " << stats.received << " failed: " << stats.failed << std::endl;
+	std::cout << "	rtt ms last: " << 1000.0 * stats.last_rtt_seconds << " smoothed: " << 1000.0 * stats.smoothed_rtt_seconds
+		<< " min: " << 1000.0 * stats.min_rtt_seconds << " max: " << 1000.0 * stats.max_rtt_seconds << " jitter: " << 1000.0 * stats.jitter_seconds << std::endl;
+	return true;
+}
+
 
 //--------------------------------------------------------------------------
 /**
@@ -448,5 +509,8 @@ void App::ToggleDebug()
 void App::RegisterEvents()
 {
 	g_theEventSystem->SubscribeEventCallbackFunction( "quit", QuitEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "prediction_stats", PredictionStatsEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "prediction_stats_reset", PredictionStatsResetEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "ping_stats", PingStatsEvent );
 }
 
@@ -22,6 +22,9 @@ public:
 	bool HandleQuitRequested();
 
 	static bool QuitEvent( EventArgs& args );
+	static bool PredictionStatsEvent( EventArgs& args );
+	static bool PredictionStatsResetEvent( EventArgs& args );
+	static bool PingStatsEvent( EventArgs& args );
 
 	bool IsPaused() const;
 	void Unpause();
@@ -70,6 +70,12 @@ void Game::Startup()
 	LoadAbilities();
 	LoadActors();
 
+	interpolation_settings_t interpolation_settings;
+	interpolation_settings.delay_seconds = g_gameConfigBlackboard.GetValue( "interpolation_delay", interpolation_settings.delay_seconds );
+	interpolation_settings.max_extrapolation_seconds = g_gameConfigBlackboard.GetValue( "interpolation_max_extrapolation", interpolation_settings.max_extrapolation_seconds );
+	SpatialOSClient::SetInterpolationSettings( interpolation_settings );
+	SpatialOSClient::SetPingInterval( g_gameConfigBlackboard.GetValue( "client_ping_interval", 1.0f ) );
+
 	m_curentCamera.SetModelMatrix( Matrix44::IDENTITY );
 	m_curentCamera.SetOrthographicProjection( Vec2( -25.0f, -12.5f ), Vec2( 25.0f, 12.5f ) );	
 
@@ -351,15 +357,17 @@ bool Game::OnServerConnection(EventArgs& args)
 */
 EntityBase* Game::CreateSimulatedEntity( const std::string& name )
 {
-	
-	if (AbilityBaseDefinition::DoesDefExist(name))
+	static const EntityTypeId player_type = EntityTypeRegistry::Intern( "player" );
+	EntityTypeId type_id = EntityTypeRegistry::Find( name );
+
+	if (AbilityBaseDefinition::DoesDefExist(type_id))
 	{
-		return new AbilityBase(name);
+		return new AbilityBase(type_id);
 	}
-	else if (ActorBaseDefinition::DoesDefExist(name))
+	else if (ActorBaseDefinition::DoesDefExist(type_id))
 	{
-		ActorRenderable* actor = new ActorRenderable(name);
-		if (name == "player")
+		ActorRenderable* actor = new ActorRenderable(type_id);
+		if (type_id == player_type)
 		{
 			actor->Possess(new SimController());
 		}
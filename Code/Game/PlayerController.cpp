@@ -37,7 +37,6 @@ PlayerController::~PlayerController()
 */
 void PlayerController::Update( float deltaTime )
 {
-	UNUSED( deltaTime );
 	m_moveDir = Vec2::ZERO;
 
 	if( g_theInputSystem->KeyIsDown( KEY_W ) )
@@ -76,7 +75,8 @@ void PlayerController::Update( float deltaTime )
 	}
 
 	m_moveDir.Normalize();
-	//m_controlled->ApplyForce( m_moveDir * m_controlled->GetSpeed() * deltaTime );
+	// Same force SimController applies on the server for the controls sent this frame.
+	m_controlled->ApplyForce( m_moveDir * m_controlled->GetSpeed() * deltaTime );
 }
 
 //--------------------------------------------------------------------------
@@ -0,0 +1,87 @@
+#include "Game/PlayerPrediction.hpp"
+
+#include <cmath>
+
+//--------------------------------------------------------------------------
+/**
+* RecordInput
+* Sequences only go up, the oldest input is dropped once the history is full.
+*/
+void PlayerPrediction::RecordInput( const predicted_state_t& state )
+{
+	if( m_count == HISTORY_SIZE )
+	{
+		m_oldest = ( m_oldest + 1 ) % HISTORY_SIZE;
+		--m_count;
+	}
+	GetEntry( m_count ) = state;
+	++m_count;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Reconcile
+*/
+bool PlayerPrediction::Reconcile( uint32_t input_sequence, const Vec2& server_position, const Vec2& server_velocity, Vec2& position, Vec2& velocity )
+{
+	if( input_sequence <= m_last_acknowledged )
+	{
+		return false;
+	}
+	m_last_acknowledged = input_sequence;
+
+	// Everything up to the acknowledged input is settled.
+	while( m_count > 0 && GetEntry( 0 ).sequence < input_sequence )
+	{
+		m_oldest = ( m_oldest + 1 ) % HISTORY_SIZE;
+		--m_count;
+	}
+
+	if( m_count == 0 || GetEntry( 0 ).sequence != input_sequence )
+	{
+		// Fell out of the history, nothing left to replay from.
+		++m_stats.resets;
+		m_count = 0;
+		position = server_position;
+		velocity = server_velocity;
+		return true;
+	}
+
+	Vec2 position_error = server_position - GetEntry( 0 ).position;
+	Vec2 velocity_error = server_velocity - GetEntry( 0 ).velocity;
+	m_oldest = ( m_oldest + 1 ) % HISTORY_SIZE;
+	--m_count;
+
+	for( uint32_t idx = 0; idx < m_count; ++idx )
+	{
+		predicted_state_t& entry = GetEntry( idx );
+		entry.position = entry.position + position_error;
+		entry.velocity = entry.velocity + velocity_error;
+	}
+	position = position + position_error;
+	velocity = velocity + velocity_error;
+
+	RecordError( std::sqrt( position_error.GetLengthSquared() ) );
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RecordError
+*/
+void PlayerPrediction::RecordError( float error )
+{
+	++m_stats.corrections;
+	m_stats.total_error += error;
+	if( error > m_stats.max_error )
+	{
+		m_stats.max_error = error;
+	}
+
+	int bucket = 0;
+	while( bucket < PREDICTION_ERROR_BUCKET_COUNT - 1 && error >= PREDICTION_ERROR_BUCKET_LIMITS[bucket] )
+	{
+		++bucket;
+	}
+	++m_stats.histogram[bucket];
+}
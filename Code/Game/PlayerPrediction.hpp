@@ -0,0 +1,65 @@
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+
+#include <cstdint>
+
+// World units, how far the prediction was from the server when an input was acknowledged.
+constexpr int PREDICTION_ERROR_BUCKET_COUNT = 7;
+constexpr float PREDICTION_ERROR_BUCKET_LIMITS[PREDICTION_ERROR_BUCKET_COUNT - 1] = { 0.01f, 0.05f, 0.1f, 0.25f, 0.5f, 1.0f };
+
+struct prediction_error_stats_t
+{
+	uint64_t corrections = 0;
+	uint64_t resets = 0;				// Acknowledged inputs already gone from the history, snapped instead.
+	double total_error = 0.0;
+	float max_error = 0.0f;
+	uint64_t histogram[PREDICTION_ERROR_BUCKET_COUNT] = {};
+};
+
+// The player's state once the frame that sent an input has been simulated.
+struct predicted_state_t
+{
+	uint32_t sequence = 0;
+	Vec2 position = Vec2::ZERO;
+	Vec2 velocity = Vec2::ZERO;
+};
+
+//--------------------------------------------------------------------------
+// Client-side prediction for the local player. The client moves its own actor
+// with the force SimController applies on the server and keeps what each input
+// led to. When the server acknowledges an input, the difference between its
+// state and ours for that input is carried onto the current state and every
+// input still in flight, the same as rewinding to the server's state and
+// replaying them while movement doesn't depend on where the player is.
+//--------------------------------------------------------------------------
+class PlayerPrediction
+{
+public:
+	static constexpr uint32_t HISTORY_SIZE = 256;		// Inputs in flight, a few seconds of round trip at 60 fps.
+
+public:
+	void RecordInput( const predicted_state_t& state );
+
+	// The server's state for input_sequence. Moves position and velocity, the player's
+	// current state, onto it. False for stale or repeated acknowledgements.
+	bool Reconcile( uint32_t input_sequence, const Vec2& server_position, const Vec2& server_velocity, Vec2& position, Vec2& velocity );
+
+	// Until the first acknowledgement the player just follows the server.
+	bool HasReconciled() const								{ return m_last_acknowledged > 0; }
+
+	const prediction_error_stats_t& GetStats() const		{ return m_stats; }
+	void ResetStats()										{ m_stats = prediction_error_stats_t(); }
+
+private:
+	const predicted_state_t& GetEntry( uint32_t index ) const	{ return m_history[( m_oldest + index ) % HISTORY_SIZE]; }
+	predicted_state_t& GetEntry( uint32_t index )				{ return m_history[( m_oldest + index ) % HISTORY_SIZE]; }
+	void RecordError( float error );
+
+private:
+	predicted_state_t m_history[HISTORY_SIZE];
+	uint32_t m_oldest = 0;
+	uint32_t m_count = 0;
+	uint32_t m_last_acknowledged = 0;
+
+	prediction_error_stats_t m_stats;
+};
@@ -0,0 +1,67 @@
+#include "Game/PositionHistory.hpp"
+
+//--------------------------------------------------------------------------
+/**
+* Push
+*/
+void PositionHistory::Push( double time, const Vec2& position )
+{
+	if( m_count > 0 && time <= GetSample( 0 ).time )
+	{
+		m_samples[( m_next + CAPACITY - 1 ) % CAPACITY].position = position;
+		return;
+	}
+
+	m_samples[m_next].time = time;
+	m_samples[m_next].position = position;
+	m_next = ( m_next + 1 ) % CAPACITY;
+	if( m_count < CAPACITY )
+	{
+		++m_count;
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* Sample
+*/
+Vec2 PositionHistory::Sample( double render_time, double max_extrapolation ) const
+{
+	if( m_count == 0 )
+	{
+		return Vec2::ZERO;
+	}
+
+	const position_sample_t& newest = GetSample( 0 );
+	if( m_count == 1 )
+	{
+		return newest.position;
+	}
+
+	if( render_time >= newest.time )
+	{
+		// Late, keep going the way it was going but not for long.
+		const position_sample_t& previous = GetSample( 1 );
+		double ahead = render_time - newest.time;
+		if( ahead > max_extrapolation )
+		{
+			ahead = max_extrapolation;
+		}
+		float fraction = (float)( ahead / ( newest.time - previous.time ) );
+		return newest.position + ( newest.position - previous.position ) * fraction;
+	}
+
+	for( uint32_t age = 1; age < m_count; ++age )
+	{
+		const position_sample_t& older = GetSample( age );
+		if( older.time <= render_time )
+		{
+			const position_sample_t& newer = GetSample( age - 1 );
+			float fraction = (float)( ( render_time - older.time ) / ( newer.time - older.time ) );
+			return older.position + ( newer.position - older.position ) * fraction;
+		}
+	}
+
+	// Further back than the history goes.
+	return GetSample( m_count - 1 ).position;
+}
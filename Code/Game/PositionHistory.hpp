@@ -0,0 +1,46 @@
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+
+#include <cstdint>
+
+struct interpolation_settings_t
+{
+	float delay_seconds = 0.1f;					// How far behind the newest position remote entities are drawn.
+	float max_extrapolation_seconds = 0.05f;	// How long they keep moving past the newest position when updates run late.
+};
+
+struct position_sample_t
+{
+	double time = 0.0;
+	Vec2 position = Vec2::ZERO;
+};
+
+//--------------------------------------------------------------------------
+// The last few positions the server sent for one entity, stamped with when they
+// arrived. Drawing a little in the past always has a sample on each side to
+// blend between, so motion stays smooth well below the server's tick rate.
+//--------------------------------------------------------------------------
+class PositionHistory
+{
+public:
+	static constexpr uint32_t CAPACITY = 16;
+
+public:
+	// Times only go forward, a sample at the newest sample's time replaces it.
+	void Push( double time, const Vec2& position );
+	void Clear() { m_count = 0; }
+	bool IsEmpty() const { return m_count == 0; }
+
+	// Between the two samples around render_time, carried on along the newest two
+	// samples for at most max_extrapolation past the newest.
+	Vec2 Sample( double render_time, double max_extrapolation ) const;
+
+private:
+	// 0 is the newest.
+	const position_sample_t& GetSample( uint32_t age ) const { return m_samples[( m_next + CAPACITY - 1 - age ) % CAPACITY]; }
+
+private:
+	position_sample_t m_samples[CAPACITY];
+	uint32_t m_next = 0;
+	uint32_t m_count = 0;
+};
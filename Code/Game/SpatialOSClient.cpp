@@ -18,27 +18,20 @@
 #include "Shared/AIController.hpp"
 #include "Shared/SimController.hpp"
 
+#include "Shared/AsyncLog.hpp"
+#include "Shared/SpatialOSConnection.hpp"
+#include "Shared/ClientSession.hpp"
+#include "Shared/PlanePositionCodec.hpp"
+
 #include "Game/View.hpp"
 #include "Game/GameCommon.hpp"
 #include "Game/Game.hpp"
 
-worker::Components<
-	improbable::Position,
-	improbable::EntityAcl,
-	improbable::Metadata,
-	improbable::Persistence,
-	improbable::Interest,
-	siren::PlayerControls,
-	siren::ServerAPI
-> ComponentRegistry;
+static const WorkerComponentRegistry ComponentRegistry;
 
 
 // Constants and parameters
 const std::string kLoggerName = "client";
-const std::uint32_t kGetOpListTimeoutInMilliseconds = 100;
-static worker::RequestId<worker::EntityQueryRequest> APIQueryRequestId;
-
-using DeleteClientEntity = siren::ServerAPI::Commands::DeleteClientEntity;
 
 // Connection helpers
 worker::Connection ConnectWithLocator(const std::string hostname,
@@ -92,103 +85,6 @@ static std::string get_random_characters(size_t count) {
 	return str;
 }
 
-//-----------------------------------------------------------------------------------------------
-
-
-int CreateCleanSnapshot()
-{
-	// Pre data
-	improbable::WorkerAttributeSet clientAttributeSet({ "client" });
-	improbable::WorkerAttributeSet serverAttributeSet({ "simulation" });
-	improbable::WorkerRequirementSet clientRequirementSet({ clientAttributeSet });
-	improbable::WorkerRequirementSet serverRequirementSet({ serverAttributeSet });
-	improbable::WorkerRequirementSet clientOrServerRequirementSet({ clientAttributeSet, serverAttributeSet });
-
-
-	worker::Map<worker::ComponentId, improbable::WorkerRequirementSet> componentAcl;
-	componentAcl[improbable::Position::ComponentId] = serverRequirementSet;
-	componentAcl[improbable::EntityAcl::ComponentId] = serverRequirementSet;
-	componentAcl[improbable::Metadata::ComponentId] = serverRequirementSet;
-	componentAcl[siren::PlayerControls::ComponentId] = clientRequirementSet;
-
-	improbable::ComponentInterest::QueryConstraint relativeConstraint;
-	relativeConstraint.set_relative_box_constraint({ {{20.5, 9999, 20.5}} });
-	improbable::ComponentInterest::Query relativeQuery;
-	relativeQuery.set_constraint(relativeConstraint);
-	relativeQuery.set_full_snapshot_result({ true });
-	improbable::ComponentInterest ai_interest{ {relativeQuery} };
-
-	siren::PlayerControls::Data cntr_data;
-
-	// API Addition
-	worker::Entity apiEntity;
-	apiEntity.Add<improbable::Metadata>({ "API" });
-	apiEntity.Add<improbable::Persistence>({});
-	apiEntity.Add<improbable::Position>({ {-100, -100, -100} });
-	apiEntity.Add<siren::ServerAPI>({});
-	worker::Map<std::uint32_t, improbable::WorkerRequirementSet> bootstrapComponentAclMap;
-	bootstrapComponentAclMap.insert({ {siren::ServerAPI::ComponentId, serverRequirementSet} });
-	apiEntity.Add<improbable::EntityAcl>({ clientOrServerRequirementSet, bootstrapComponentAclMap });
-	improbable::ComponentInterest::Query query;
-	improbable::ComponentInterest::QueryConstraint queryConstraint;
-	queryConstraint.set_component_constraint(siren::Client::ComponentId);
-	query.set_constraint(queryConstraint);
-	query.set_full_snapshot_result({ true });
-	improbable::ComponentInterest componentInterest;
-	componentInterest.set_queries({ query });
-	improbable::InterestData interestData;
-	interestData.component_interest()[siren::ServerAPI::ComponentId] = componentInterest;
-	apiEntity.Add<improbable::Interest>(interestData);
-
-
-
-	// World creation
-	worker::Entity turret1;
-	turret1.Add<improbable::Metadata>({ "turret" });
-	turret1.Add<improbable::Persistence>({});
-	turret1.Add<improbable::Position>({ {7, 0, 7} });
-	turret1.Add<siren::PlayerControls>(cntr_data);
-	turret1.Add<improbable::EntityAcl>(
-		improbable::EntityAcl::Data{/* read */ clientOrServerRequirementSet, /* write */ componentAcl });
-	turret1.Add<improbable::Interest>({ {{siren::Client::ComponentId, ai_interest}} });
-
-	worker::Entity turret2;
-	turret2.Add<improbable::Metadata>({ "turret" });
-	turret2.Add<improbable::Persistence>({});
-	turret2.Add<improbable::Position>({ {5, 0, 7} });
-	turret2.Add<siren::PlayerControls>(cntr_data);
-	turret2.Add<improbable::EntityAcl>(
-		improbable::EntityAcl::Data{/* read */ clientOrServerRequirementSet, /* write */ componentAcl });
-	turret2.Add<improbable::Interest>({ {{siren::Client::ComponentId, ai_interest}} });
-
-	worker::Entity crawler;
-	crawler.Add<improbable::Metadata>({ "crawler" });
-	crawler.Add<improbable::Persistence>({});
-	crawler.Add<improbable::Position>({ {-5, 0, 7} });
-	crawler.Add<siren::PlayerControls>(cntr_data);
-	crawler.Add<improbable::EntityAcl>(
-		improbable::EntityAcl::Data{/* read */ clientOrServerRequirementSet, /* write */ componentAcl });
-	crawler.Add<improbable::Interest>({ {{siren::Client::ComponentId, ai_interest}} });
-
-
-	worker::Result<worker::SnapshotOutputStream, worker::StreamErrorCode> outputStream = worker::SnapshotOutputStream::Create(ComponentRegistry, "D:/GitHubRepos/SpatialClientServer/SpatialOS/snapshots/WorldWithAPI.snapshot");
-	if( !outputStream )
-	{
-		return 1;
-	}
-	
-	worker::Result<worker::None, worker::StreamErrorCode> entityWritten = outputStream->WriteEntity(1, apiEntity);
-	worker::Result<worker::None, worker::StreamErrorCode> entityWritten1 = outputStream->WriteEntity(2, turret1);
-	worker::Result<worker::None, worker::StreamErrorCode> entityWritten2 = outputStream->WriteEntity(3, turret2);
-	worker::Result<worker::None, worker::StreamErrorCode> entityWritten3 = outputStream->WriteEntity(4, crawler);
-		
-	if ( !entityWritten || !entityWritten1 || !entityWritten2 || !entityWritten3 ) 
-	{
-		return 1;
-	}
-	return 0;
-}
-
 //--------------------------------------------------------------------------
 /**
 * Startup
@@ -209,9 +105,7 @@ void SpatialOSClient::Startup(const std::vector<std::string>& args)
 void SpatialOSClient::Shutdown()
 {
 	ClientContext& context = GetInstance()->context;
-	::siren::DeleteClientEntityRequest request;
-	request.set_id_to_delete( context.clientEntityId );
-	worker::Result<worker::RequestId<worker::OutgoingCommandRequest<DeleteClientEntity>>> createEntityRequestId = context.connection->SendCommandRequest<DeleteClientEntity>( GetContext()->APIEntityId, request, 30000, {} );
+	context.session->RequestClientEntityDeletion( context.clientEntityId );
 	for( entity_info_t*& info : GetInstance()->entity_info_list )
 	{
 		SAFE_DELETE(info);
@@ -228,10 +122,16 @@ void SpatialOSClient::Process()
 {
 	if( IsRunning() )
 	{
-		auto opList = GetInstance()->context.connection->GetOpList(0);
-		GetInstance()->context.view->Process(opList);
+		GetInstance()->context.connection->Process( *GetInstance()->context.view, 0 );
 
 		GetInstance()->Update();
+
+		// Keeps the player from being evicted as idle, and measures the round trip.
+		ClientContext& context = GetInstance()->context;
+		if( context.session && context.clientEntityId != 0 )
+		{
+			context.session->UpdatePing( context.clientEntityId );
+		}
 	}
 }
 
@@ -268,17 +168,18 @@ void SpatialOSClient::RequestEntityCreation( EntityBase* entity )
 
 	entity_info_t* info = new entity_info_t();
 	info->game_entity = entity;
+	info->predict = true;
 
-	worker::Result<worker::RequestId<worker::OutgoingCommandRequest<CreateClientEntity>>> createEntityRequestId = GetContext()->connection->SendCommandRequest<CreateClientEntity>(GetContext()->APIEntityId, 30000, {});
+	worker::Option<uint64_t> createEntityRequestId = GetContext()->session->RequestClientEntity();
 	if (!createEntityRequestId) {
-		std::cout << "Failed to send create client entity request: " << createEntityRequestId.GetErrorMessage().c_str() << std::endl;
+		std::cout << "Failed to send create client entity request" << std::endl;
 		ERROR_RECOVERABLE( "Failed to send create client entity" );
 		SAFE_DELETE( info );
 		return;
 	}
 
-	std::cout << "Sent create client entity request with id " << createEntityRequestId->Id << std::endl;
-	info->createEntityCommandRequestId = createEntityRequestId->Id;
+	std::cout << "Sent create client entity request with id " << *createEntityRequestId << std::endl;
+	info->createEntityCommandRequestId = *createEntityRequestId;
 	AddEntityInfo( info );
 }
 
@@ -298,19 +199,66 @@ void SpatialOSClient::UpdatePlayerControls( EntityBase* player, const Vec2& forc
 
 	if( info && info->created )
 	{
-		siren::PlayerControls::Update ctrUpdate;
-		ctrUpdate.set_x_move( force_vec.x );
-		ctrUpdate.set_y_move( force_vec.y );
-		worker::UpdateParameters params;
-		Logf( "", "	Sending intent x: %.04f y:%.04f with entity ID: %i", force_vec.x, force_vec.y, info->id );
-		GetContext()->connection->SendComponentUpdate<siren::PlayerControls>( info->id, ctrUpdate, params );
+		LOG_DEBUG( "Client", "Sending intent x: %.04f y: %.04f for entity %lld", force_vec.x, force_vec.y, (long long)info->id );
+		predicted_state_t state;
+		state.sequence = GetContext()->session->SendPlayerControls( info->id, force_vec );
+		state.position = player->GetPosition();
+		state.velocity = player->GetVelocity();
+		GetInstance()->player_prediction.RecordInput( state );
 	}
 	else
 	{
-		Logf("WARNING", "Failed to send input", force_vec.x, force_vec.y);
+		LOG_WARNING( "Client", "Failed to send input x: %.04f y: %.04f", force_vec.x, force_vec.y );
 	}
 }
 
+//--------------------------------------------------------------------------
+/**
+* SetInterpolationSettings
+*/
+void SpatialOSClient::SetInterpolationSettings( const interpolation_settings_t& settings )
+{
+	GetInstance()->interpolation_settings = settings;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetPredictionStats
+*/
+const prediction_error_stats_t& SpatialOSClient::GetPredictionStats()
+{
+	return GetInstance()->player_prediction.GetStats();
+}
+
+//--------------------------------------------------------------------------
+/**
+* ResetPredictionStats
+*/
+void SpatialOSClient::ResetPredictionStats()
+{
+	GetInstance()->player_prediction.ResetStats();
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetPingInterval
+* Takes effect on the next connection.
+*/
+void SpatialOSClient::SetPingInterval( double seconds )
+{
+	GetInstance()->ping_interval = seconds;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetPingStats
+*/
+client_ping_stats_t SpatialOSClient::GetPingStats()
+{
+	ClientSession* session = GetInstance()->context.session;
+	return session ? session->GetPingStats() : client_ping_stats_t();
+}
+
 
 //--------------------------------------------------------------------------
 /**
@@ -321,8 +269,6 @@ void SpatialOSClient::Run( std::vector<std::string> arguments )
 	auto now = std::chrono::high_resolution_clock::now();
 	std::srand((uint)std::chrono::time_point_cast<std::chrono::nanoseconds>(now).time_since_epoch().count());
 
-	//CreateCleanSnapshot();
-
 	constexpr unsigned kFramesPerSecond = 30;
 	constexpr std::chrono::duration<double> kFramePeriodSeconds{
 		1. / static_cast<double>(kFramesPerSecond) };
@@ -405,33 +351,35 @@ void SpatialOSClient::Run( std::vector<std::string> arguments )
 	parameters.Network.UseExternalIp = true;
 
 	// Connect with locator or receptionist
-	worker::Connection connection = use_locator
+	SpatialOSConnection connection( use_locator
 		? ConnectWithLocator(arguments[1], arguments[3], login_details.DeploymentName, login_details.LoginToken, parameters )
-		: ConnectWithReceptionist(arguments[1], (uint16_t)atoi(arguments[2].c_str()), arguments[3], parameters);
+		: ConnectWithReceptionist(arguments[1], (uint16_t)atoi(arguments[2].c_str()), arguments[3], parameters) );
 	GetInstance()->context.connection = &connection;
 	connection.SendLogMessage( worker::LogLevel::kInfo, kLoggerName, "Connected successfully" );
 
 	// Register callbacks and run the worker main loop.
-	View view{ ComponentRegistry };
+	View view;
 	GetInstance()->context.view = &view;
 	bool is_connected = connection.IsConnected();
 
-	view.OnDisconnect([&](const worker::DisconnectOp& op) {
-		Logf("ClientLog", "[disconnect] %s", op.Reason.c_str());
-		ERROR_RECOVERABLE( Stringf( "Disconnected from the server : %s", op.Reason.c_str() ).c_str() );
+	view.OnDisconnect([&](const std::string& reason) {
+		Logf("ClientLog", "[disconnect] %s", reason.c_str());
+		ERROR_RECOVERABLE( Stringf( "Disconnected from the server : %s", reason.c_str() ).c_str() );
 		is_connected = false;
 		});
 
 
 	RegisterCallbacks( view );
-	
+
 	// Look for API
-	worker::query::EntityQuery APIEntityQuery
-	{
-		worker::query::ComponentConstraint{siren::ServerAPI::ComponentId},
-		worker::query::SnapshotResultType{{{siren::ServerAPI::ComponentId}}}
+	ClientSession session( connection, view );
+	session.SetPingInterval( GetInstance()->ping_interval );
+	GetInstance()->context.session = &session;
+	session.on_api_found = []( worker::EntityId ) {
+		g_theEventSystem->FireEvent("API_connection_made");
 	};
-	APIQueryRequestId = connection.SendEntityQueryRequest(APIEntityQuery, {});
+	session.on_client_entity_created = ClientCreationResponse;
+	session.FindAPIEntity();
 	Logf( "ClientLog", "Connected and running" );
 
 
@@ -451,6 +399,7 @@ void SpatialOSClient::Run( std::vector<std::string> arguments )
 	GetInstance()->isRunning = false;
 	GetInstance()->context.connection = nullptr;
 	GetInstance()->context.view = nullptr;
+	GetInstance()->context.session = nullptr;
 }
 
 
@@ -461,22 +410,18 @@ void SpatialOSClient::Run( std::vector<std::string> arguments )
 void SpatialOSClient::RegisterCallbacks( View& view )
 {
 	// Print messages received from SpatialOS
-	view.OnLogMessage([&](const worker::LogMessageOp& op) {
-		if (op.Level == worker::LogLevel::kFatal) {
-			std::cerr << "Fatal error: " << op.Message << std::endl;
-			Logf( "ClientLog", "Fetal error: %s", op.Message.c_str() );
+	view.OnLogMessage([&](worker::LogLevel level, const std::string& message) {
+		if (level == worker::LogLevel::kFatal) {
+			std::cerr << "Fatal error: " << message << std::endl;
+			Logf( "ClientLog", "Fetal error: %s", message.c_str() );
 		}
-		std::cout << "Connection: " << op.Message << std::endl;
-		Logf("ClientLog", "Connection: %s", op.Message.c_str());
+		std::cout << "Connection: " << message << std::endl;
+		Logf("ClientLog", "Connection: %s", message.c_str());
 		});
 
-	view.OnEntityQueryResponse( EntityQueryResponse );
-
-	view.OnCommandResponse<CreateClientEntity>( ClientCreationResponse );
-
-	view.OnCommandResponse<DeleteClientEntity>( []( const worker::CommandResponseOp<DeleteClientEntity>& op )
+	view.OnDeleteClientEntityResponse( []( const command_response_t<DeleteClientEntity>& op )
 		{
-			Logf( "%s", op.Message.c_str() );
+			Logf( "%s", op.message.c_str() );
 		}
 	);
 
@@ -490,27 +435,70 @@ void SpatialOSClient::RegisterCallbacks( View& view )
 */
 void SpatialOSClient::Update()
 {
-	for( auto& ent_pair : context.view->m_entities )
+	View& view = *context.view;
+	double now = GetClientTime();
+
+	// Check for deleted entities
+	for( worker::EntityId removed_id : view.GetRemovedEntities() )
+	{
+		if( view.m_components.FindSlot( removed_id ) != ViewComponentStore::INVALID_SLOT )
+		{
+			// Checked out again in the same frame, keep the game entity and let the update below catch it up.
+			continue;
+		}
+
+		for( entity_info_t*& info : entity_info_list )
+		{
+			// See if we can no longer see an entity that has been created
+			if( info && info->id == removed_id && info->created && (EntityBase*)g_theGame->GetPlayerEntity() != info->game_entity )
+			{
+				// Tell the entity to die and then erase knowledge of entity
+				info->game_entity->Die();
+				SAFE_DELETE(info);
+			}
+		}
+	}
+
+	for( worker::EntityId id : view.GetDirtyEntities() )
 	{
-		View::entity_tracker_t& tracker = ent_pair.second;
-		if( !tracker.updated )
+		uint32_t slot = view.m_components.FindSlot( id );
+		if( slot == ViewComponentStore::INVALID_SLOT || view.GetChanged( slot ) == 0 )
 		{
-			// Entity wasn't updated so there's nothing to tell the client
+			// Removed after it changed, or already listed earlier this frame.
 			continue;
 		}
+		Vec2 position;
+		bool position_changed = false;
+		bool has_position = GetPlanePosition( view, slot, position, position_changed );
 		
-		entity_info_t* info = GetInfoWithEntityId( ent_pair.first );
+		entity_info_t* info = GetInfoWithEntityId( id );
 		if( info )
 		{
 			if( info->game_entity )
 			{
-				Logf("SpatialOSClient::Update", "Updating ID: %i", ent_pair.first);
-				UpdateEntityWithWorkerEntity( *(info->game_entity), tracker.worker_entity );
+				if( info->predict )
+				{
+					ReconcilePlayer( *info, slot );
+				}
+
+				// Only the position makes it into the game entity.
+				if( has_position && position_changed )
+				{
+					LOG_DEBUG( "Client", "Updating entity %lld", (long long)id );
+					if( info->interpolate )
+					{
+						info->position_history.Push( now, position );
+					}
+					else if( !info->predict || !player_prediction.HasReconciled() )
+					{
+						info->game_entity->SetPosition( position );
+					}
+				}
 			}
 			else
 			{
 				// should never get here.
-				Logf("ERROR", "SpatialOSClient::Update - info and worker entity found but no game entity to update");
+				LOG_ERROR( "Client", "Entity %lld has info but no game entity to update", (long long)id );
 			}
 		}
 		else
@@ -518,22 +506,24 @@ void SpatialOSClient::Update()
 			// Game doesn't know about the instance from the server yet.
 			
 			//	Working on getting an entity into the game from the server
-			Logf("SpatialOSClient::Update", "can't find info with ID: %i", ent_pair.first);
-			worker::Option<improbable::MetadataData&> data = tracker.worker_entity.Get<improbable::Metadata>();
-			worker::Option<improbable::InterestData&> intrest = tracker.worker_entity.Get<improbable::Interest>();
+			const improbable::MetadataData* data = view.m_components.Get<improbable::Metadata>( slot );
 			if (data)
 			{
-				Logf("SpatialOSClient::Update", "Making from data");
+				LOG_DEBUG( "Client", "Making a %s for entity %lld", data->entity_type().c_str(), (long long)id );
 				entity_info_t* new_info = new entity_info_t();
 				std::string name = data->entity_type();
 				new_info->game_entity = g_theGame->CreateSimulatedEntity( name );
 				if( new_info->game_entity )
 				{
-					UpdateEntityWithWorkerEntity( *(new_info->game_entity), tracker.worker_entity );
-					new_info->id = ent_pair.first;
+					if( has_position )
+					{
+						new_info->game_entity->SetPosition( position );
+						new_info->position_history.Push( now, position );
+					}
+					new_info->id = id;
 					new_info->created = true;
+					new_info->interpolate = true;
 					AddEntityInfo( new_info );
-					Logf("SpatialOSClient::Update", "Success in creation of entity");
 				}
 				else
 				{
@@ -541,33 +531,90 @@ void SpatialOSClient::Update()
 				}
 			}
 		}
-		tracker.updated = false;
+		view.ClearChanged( slot );
 	}
 
-	// Check for deleted entities
-	for( entity_info_t*& info : entity_info_list )
+	view.ClearChanges();
+	ApplyInterpolatedPositions( now );
+}
+
+//--------------------------------------------------------------------------
+/**
+* ApplyInterpolatedPositions
+* Every frame, not just when positions arrive, so entities keep moving between updates.
+*/
+void SpatialOSClient::ApplyInterpolatedPositions( double now )
+{
+	double render_time = now - interpolation_settings.delay_seconds;
+	for( entity_info_t* info : entity_info_list )
 	{
-		// See if we can no longer see an entity that has been created
-		if( info && context.view->m_entities.find( info->id ) == context.view->m_entities.end() && info->created && (EntityBase*)g_theGame->GetPlayerEntity() != info->game_entity )
+		if( info && info->interpolate && info->game_entity && !info->position_history.IsEmpty() )
 		{
-			// Tell the entity to die and then erase knowledge of entity
-			info->game_entity->Die();
-			SAFE_DELETE(info);
+			info->game_entity->SetPosition( info->position_history.Sample( render_time, interpolation_settings.max_extrapolation_seconds ) );
 		}
 	}
 }
 
 //--------------------------------------------------------------------------
 /**
-* UpdateEntityWithWorkerEntity
+* ReconcilePlayer
+* Once the server has acknowledged an input, the player's Position updates are
+* only used for the ones PlayerMovement doesn't carry, they lag behind the prediction.
 */
-void SpatialOSClient::UpdateEntityWithWorkerEntity( EntityBase& entity, worker::Entity& worker_entity )
+void SpatialOSClient::ReconcilePlayer( entity_info_t& info, uint32_t slot )
 {
-	worker::Option<improbable::PositionData&> pos = worker_entity.Get<improbable::Position>();
-	if (pos)
+	View& view = *context.view;
+	const siren::PlayerMovementData* movement = view.m_components.Get<siren::PlayerMovement>( slot );
+	if( !movement || ( view.GetChanged( slot ) & VIEW_CHANGED_MOVEMENT ) == 0 || movement->input_sequence() == 0 )
 	{
-		entity.SetPosition((float)pos->coords().x(), (float)pos->coords().z());
-	}	
+		return;
+	}
+
+	EntityBase& player = *info.game_entity;
+	Vec2 position = player.GetPosition();
+	Vec2 velocity = player.GetVelocity();
+	Vec2 server_position( movement->position().x(), movement->position().y() );
+	Vec2 server_velocity( movement->velocity().x(), movement->velocity().y() );
+	if( player_prediction.Reconcile( movement->input_sequence(), server_position, server_velocity, position, velocity ) )
+	{
+		player.SetPosition( position );
+		player.SetVelocity( velocity );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetPlanePosition
+* From PlanePosition, or Position for entities that don't have it, e.g. ones from older snapshots.
+* Once an entity has PlanePosition its Position is only a low rate copy and is ignored.
+*/
+bool SpatialOSClient::GetPlanePosition( const View& view, uint32_t slot, Vec2& position, bool& changed )
+{
+	const siren::PlanePositionData* plane_position = view.m_components.Get<siren::PlanePosition>( slot );
+	if( plane_position )
+	{
+		position = DecodePlanePosition( *plane_position );
+		changed = ( view.GetChanged( slot ) & VIEW_CHANGED_PLANE_POSITION ) != 0;
+		return true;
+	}
+
+	const improbable::PositionData* coordinates = view.m_components.Get<improbable::Position>( slot );
+	if( coordinates )
+	{
+		position = Vec2( (float)coordinates->coords().x(), (float)coordinates->coords().z() );
+		changed = ( view.GetChanged( slot ) & VIEW_CHANGED_POSITION ) != 0;
+		return true;
+	}
+	return false;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetClientTime
+*/
+double SpatialOSClient::GetClientTime()
+{
+	return std::chrono::duration<double>( std::chrono::steady_clock::now().time_since_epoch() ).count();
 }
 
 //--------------------------------------------------------------------------
@@ -606,32 +653,17 @@ entity_info_t* SpatialOSClient::GetInfoWithEntity( EntityBase* entity_id )
 }
 
 
-//--------------------------------------------------------------------------
-/**
-* EntityQueryResponse
-*/
-void SpatialOSClient::EntityQueryResponse( const worker::EntityQueryResponseOp& op )
-{
-	std::cout << "Received entity query response for request " << op.RequestId.Id << " with status code " << (int)(op.StatusCode) << std::endl;
-
-
-	if (op.RequestId == APIQueryRequestId && !op.Result.empty()) {
-		GetInstance()->context.APIEntityId = op.Result.begin()->first;
-		g_theEventSystem->FireEvent("API_connection_made");
-	}
-}
-
 //--------------------------------------------------------------------------
 /**
 * ClientCreationResponse
 */
-void SpatialOSClient::ClientCreationResponse( const worker::CommandResponseOp<CreateClientEntity>& op )
+void SpatialOSClient::ClientCreationResponse( uint64_t request_id, bool success, worker::EntityId created_id )
 {
-	Logf( "SpatialOSClient::ClientCreationResponse", "Response with Request ID: %i and Entity ID: %i", op.RequestId.Id, op.EntityId );
-	if( op.StatusCode == worker::StatusCode::kSuccess )
+	Logf( "SpatialOSClient::ClientCreationResponse", "Response with Request ID: %i", request_id );
+	if( success )
 	{
-		Logf( "SpatialOSClient::ClientCreationResponse", "		Response from response received: %i", op.Response->id_created() );
-		entity_info_t* info = GetInfoWithCreateEntityCommandRequestId( op.RequestId.Id );
+		Logf( "SpatialOSClient::ClientCreationResponse", "		Response from response received: %i", created_id );
+		entity_info_t* info = GetInfoWithCreateEntityCommandRequestId( request_id );
 
 		if( info )
 		{
@@ -642,8 +674,8 @@ void SpatialOSClient::ClientCreationResponse( const worker::CommandResponseOp<Cr
 			}
 			
 			info->created = true;
-			info->id = op.Response->id_created();
-			GetInstance()->context.clientEntityId = op.Response->id_created();
+			info->id = created_id;
+			GetInstance()->context.clientEntityId = created_id;
 		}
 		else
 		{
@@ -1,11 +1,11 @@
 #pragma once
 #include "Engine/Math/Vec2.hpp"
 
-#include <improbable/worker.h>
-#include <improbable/standard_library.h>
-#include <improbable/view.h>
+#include "Game/PositionHistory.hpp"
+#include "Game/PlayerPrediction.hpp"
 
-#include <ClientServer.h>
+#include "Shared/ClientSession.hpp"
+#include "Shared/WorkerConnection.hpp"
 
 #include <thread>
 #include <mutex>
@@ -14,10 +14,10 @@ class EntityBase;
 class View;
 
 struct ClientContext {
-	worker::Connection* connection = nullptr;
+	WorkerConnection* connection = nullptr;
 	View* view = nullptr;
-	worker::EntityId APIEntityId;
-	worker::EntityId clientEntityId;
+	ClientSession* session = nullptr;
+	worker::EntityId clientEntityId = 0;
 };
 
 struct entity_info_t
@@ -26,9 +26,14 @@ struct entity_info_t
 	worker::EntityId id = 0;
 	uint64_t createEntityCommandRequestId = 0;
 	bool created = false;
-};
 
-using CreateClientEntity = siren::ServerAPI::Commands::CreateClientEntity;
+	// Server driven entities are drawn from their history, the player isn't.
+	bool interpolate = false;
+	PositionHistory position_history;
+
+	// The local player moves straight away and is corrected by PlayerMovement acks.
+	bool predict = false;
+};
 
 
 class SpatialOSClient
@@ -45,17 +50,26 @@ public:
 	static void RequestEntityCreation( EntityBase* entity );
 	static void UpdatePlayerControls( EntityBase* player, const Vec2& direction );
 
+	static void SetInterpolationSettings( const interpolation_settings_t& settings );
+
+	static const prediction_error_stats_t& GetPredictionStats();
+	static void ResetPredictionStats();
+	static void SetPingInterval( double seconds );
+	static client_ping_stats_t GetPingStats();
+
 private:
 	static void Run( std::vector<std::string> arguments );
 	static void RegisterCallbacks( View& view );
 
 private:
 	void Update();
-	static void UpdateEntityWithWorkerEntity( EntityBase& entity, worker::Entity& worker_entity );
+	void ApplyInterpolatedPositions( double now );
+	void ReconcilePlayer( entity_info_t& info, uint32_t slot );
+	static bool GetPlanePosition( const View& view, uint32_t slot, Vec2& position, bool& changed );
+	static double GetClientTime();
 
 	// Component Updating
-	static void EntityQueryResponse( const worker::EntityQueryResponseOp& op );
-	static void ClientCreationResponse( const worker::CommandResponseOp<CreateClientEntity>& op );
+	static void ClientCreationResponse( uint64_t request_id, bool success, worker::EntityId created_id );
 	
 	static entity_info_t* GetInfoWithCreateEntityCommandRequestId( uint64_t request_id );
 	static entity_info_t* GetInfoWithEntityId( const worker::EntityId& entity_id );
@@ -77,5 +91,9 @@ private:
 
 	ClientContext context;
 	std::vector<entity_info_t*> entity_info_list;	
+
+	interpolation_settings_t interpolation_settings;
+	PlayerPrediction player_prediction;
+	double ping_interval = 1.0;
 	
 };
\ No newline at end of file
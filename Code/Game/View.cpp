@@ -1 +1,88 @@
 #include "Game/View.hpp"
+
+
+//--------------------------------------------------------------------------
+/**
+* AddEntity
+*/
+void View::AddEntity( worker::EntityId id )
+{
+	uint32_t slot = m_components.AddEntity( id );
+	if( slot >= m_changed.size() )
+	{
+		m_changed.resize( slot + 1, 0 );
+	}
+	MarkChanged( id, slot, VIEW_CHANGED_ADDED );
+}
+
+//--------------------------------------------------------------------------
+/**
+* RemoveEntity
+*/
+void View::RemoveEntity( worker::EntityId id )
+{
+	uint32_t slot = m_components.FindSlot( id );
+	if( slot != ViewComponentStore::INVALID_SLOT )
+	{
+		m_changed[slot] = 0;
+		m_components.RemoveEntity( id );
+		m_removed.push_back( id );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* RemoveComponent
+*/
+void View::RemoveComponent( worker::EntityId id, worker::ComponentId component_id )
+{
+	uint32_t slot = m_components.FindSlot( id );
+	if( slot != ViewComponentStore::INVALID_SLOT && m_components.RemoveComponent( slot, component_id ) )
+	{
+		MarkChanged( id, slot, GetViewChangeBit( component_id ) );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* ChangeAuthority
+*/
+void View::ChangeAuthority( worker::EntityId id, worker::ComponentId component_id, worker::Authority authority )
+{
+	uint32_t slot = m_components.FindSlot( id );
+	if( slot != ViewComponentStore::INVALID_SLOT && m_components.SetAuthority( slot, component_id, authority ) )
+	{
+		MarkChanged( id, slot, VIEW_CHANGED_AUTHORITY );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* ClearChanges
+*/
+void View::ClearChanges()
+{
+	for( worker::EntityId id : m_dirty )
+	{
+		uint32_t slot = m_components.FindSlot( id );
+		if( slot != ViewComponentStore::INVALID_SLOT )
+		{
+			m_changed[slot] = 0;
+		}
+	}
+	m_dirty.clear();
+	m_removed.clear();
+}
+
+//--------------------------------------------------------------------------
+/**
+* MarkChanged
+*/
+void View::MarkChanged( worker::EntityId id, uint32_t slot, uint32_t bits )
+{
+	if( m_changed[slot] == 0 )
+	{
+		m_dirty.push_back( id );
+	}
+	m_changed[slot] |= bits;
+}
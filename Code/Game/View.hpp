@@ -1,15 +1,15 @@
 #pragma once
-#include <improbable/worker.h>
-#include <improbable/standard_library.h>
+#include "Shared/WorkerDispatcher.hpp"
+#include "Shared/ViewComponentStore.hpp"
 
+#include <vector>
 
 
 class View 
-	: public worker::Dispatcher
+	: public WorkerDispatcher
 {
 public:
-	template <typename... T>
-	View(const worker::Components<T...>& components);
+	View() {};
 	~View() {};
 
 	// Not copyable or movable.
@@ -20,83 +20,59 @@ public:
 
 
 public:
-	struct entity_tracker_t
-	{
-		worker::Entity worker_entity;
-		bool updated = false;
-		bool garbage = false;
-	};
-
-	worker::Map<worker::EntityId, entity_tracker_t> m_entities;
-	worker::Map<worker::EntityId, worker::Map<worker::ComponentId, worker::Authority>> m_component_authority;
-
-private:	
-
-	struct track_component_handler {
-		View& view_reference;
-
-		template <typename T>
-		void Accept() const 
-		{
-			View& view = this->view_reference;
-
-			view.OnAddComponent<T>([&view](const worker::AddComponentOp<T>& op) 
-			{
-				auto it = view.m_entities.find(op.EntityId);
-				if (it != view.m_entities.end()) {
-					entity_tracker_t& tracker = it->second;
-					tracker.worker_entity.Add<T>(op.Data);
-					tracker.updated = true;
-				}
-			});
+	// What the client has to look at this frame, instead of every entity in view.
+	// Removed ids are gone from m_components unless they were checked out again.
+	const std::vector<worker::EntityId>& GetDirtyEntities() const		{ return m_dirty; }
+	const std::vector<worker::EntityId>& GetRemovedEntities() const	{ return m_removed; }
+	void ClearChanges();
 
-			view.OnRemoveComponent<T>([&view](const worker::RemoveComponentOp& op) 
-			{
-				auto it = view.m_entities.find(op.EntityId);
-				if (it != view.m_entities.end()) {
-					entity_tracker_t& tracker = it->second;
-					tracker.worker_entity.Remove<T>();
-					tracker.updated = true;
-				}
-			});
+	// ViewChangeBits of the entity in the slot, non zero while the entity is on the dirty list.
+	uint32_t GetChanged( uint32_t slot ) const							{ return m_changed[slot]; }
+	void ClearChanged( uint32_t slot )									{ m_changed[slot] = 0; }
 
-			view.OnAuthorityChange<T>([&view](const worker::AuthorityChangeOp& op) 
-			{
-				view.m_component_authority[op.EntityId][T::ComponentId] = op.Authority;
-			});
+	ViewComponentStore m_components;
 
-			view.OnComponentUpdate<T>([&view](const worker::ComponentUpdateOp<T>& op) 
-			{
-				auto it = view.m_entities.find(op.EntityId);
-				if (it != view.m_entities.end()) {
-					entity_tracker_t& tracker = it->second;
-					if (tracker.worker_entity.Get<T>()) {
-						tracker.worker_entity.Update<T>(op.Update);
-						tracker.updated = true;
-					}
-				}
-			});
+public:
+	// WorkerDispatcher
+	void AddEntity( worker::EntityId id ) override;
+	void RemoveEntity( worker::EntityId id ) override;
+	void AddComponent( worker::EntityId id, const improbable::PositionData& data ) override				{ TrackAdd<improbable::Position>( id, data ); }
+	void AddComponent( worker::EntityId id, const improbable::MetadataData& data ) override				{ TrackAdd<improbable::Metadata>( id, data ); }
+	void AddComponent( worker::EntityId id, const siren::PlayerControlsData& data ) override			{ TrackAdd<siren::PlayerControls>( id, data ); }
+	void AddComponent( worker::EntityId id, const siren::PlayerMovementData& data ) override			{ TrackAdd<siren::PlayerMovement>( id, data ); }
+	void AddComponent( worker::EntityId id, const siren::PlanePositionData& data ) override				{ TrackAdd<siren::PlanePosition>( id, data ); }
+	void UpdateComponent( worker::EntityId id, const improbable::Position::Update& update ) override	{ TrackUpdate<improbable::Position>( id, update ); }
+	void UpdateComponent( worker::EntityId id, const improbable::Metadata::Update& update ) override	{ TrackUpdate<improbable::Metadata>( id, update ); }
+	void UpdateComponent( worker::EntityId id, const siren::PlayerControls::Update& update ) override	{ TrackUpdate<siren::PlayerControls>( id, update ); }
+	void UpdateComponent( worker::EntityId id, const siren::PlayerMovement::Update& update ) override	{ TrackUpdate<siren::PlayerMovement>( id, update ); }
+	void UpdateComponent( worker::EntityId id, const siren::PlanePosition::Update& update ) override	{ TrackUpdate<siren::PlanePosition>( id, update ); }
+	void RemoveComponent( worker::EntityId id, worker::ComponentId component_id ) override;
+	void ChangeAuthority( worker::EntityId id, worker::ComponentId component_id, worker::Authority authority ) override;
+
+private:
+	void MarkChanged( worker::EntityId id, uint32_t slot, uint32_t bits );
+
+	template <typename T>
+	void TrackAdd( worker::EntityId id, const typename T::Data& data )
+	{
+		uint32_t slot = m_components.FindSlot( id );
+		if( slot != ViewComponentStore::INVALID_SLOT ) {
+			m_components.Set<T>( slot, data );
+			MarkChanged( id, slot, GetViewChangeBit( T::ComponentId ) );
 		}
-	};
+	}
 
+	template <typename T>
+	void TrackUpdate( worker::EntityId id, const typename T::Update& update )
+	{
+		uint32_t slot = m_components.FindSlot( id );
+		if( slot != ViewComponentStore::INVALID_SLOT && m_components.Update<T>( slot, update ) ) {
+			MarkChanged( id, slot, GetViewChangeBit( T::ComponentId ) );
+		}
+	}
 
+private:
+	std::vector<uint32_t> m_changed;		// Indexed by slot
+	std::vector<worker::EntityId> m_dirty;
+	std::vector<worker::EntityId> m_removed;
 };
-
-//--------------------------------------------------------------------------
-/**
-* View
-*/
-template <typename... T>
-View::View(const worker::Components<T...>& components)
-	: worker::Dispatcher{components}
-{
-	OnAddEntity([this](const worker::AddEntityOp& op) {
-		m_entities[op.EntityId];
-		m_component_authority[op.EntityId];
-		});
-	OnRemoveEntity([this](const worker::RemoveEntityOp& op) {
-		m_entities.erase(op.EntityId);
-		m_component_authority.erase(op.EntityId);
-		});
-	ForEachComponent(components, track_component_handler{ *this });
-}
@@ -0,0 +1,91 @@
+#include "Server/EntityIdPool.hpp"
+
+//--------------------------------------------------------------------------
+/**
+* TryTake
+*/
+bool EntityIdPool::TryTake( worker::EntityId& id )
+{
+	if( m_ranges.empty() )
+	{
+		return false;
+	}
+
+	id_range_t& range = m_ranges.front();
+	id = range.next++;
+	if( range.next == range.end )
+	{
+		m_ranges.pop_front();
+	}
+	--m_available;
+	++m_stats.taken;
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* TakeRefillCount
+*/
+uint32_t EntityIdPool::TakeRefillCount( uint32_t waiting )
+{
+	uint32_t block_size = m_settings.block_size > 0 ? m_settings.block_size : 1;
+	uint32_t wanted = m_settings.low_water + waiting;
+	uint32_t have = m_available + m_requested;
+	if( have >= wanted )
+	{
+		return 0;
+	}
+
+	uint32_t count = ( wanted - have + block_size - 1 ) / block_size * block_size;
+	m_requested += count;
+	return count;
+}
+
+//--------------------------------------------------------------------------
+/**
+* OnRequestSent
+*/
+void EntityIdPool::OnRequestSent( uint64_t request_id, uint32_t count )
+{
+	m_requests[request_id] = count;
+}
+
+//--------------------------------------------------------------------------
+/**
+* OnResponse
+*/
+bool EntityIdPool::OnResponse( uint64_t request_id, bool success, worker::EntityId first_id )
+{
+	auto itr = m_requests.find( request_id );
+	if( itr == m_requests.end() )
+	{
+		return false;
+	}
+
+	uint32_t count = itr->second;
+	m_requests.erase( itr );
+	m_requested -= count;
+
+	if( !success )
+	{
+		++m_stats.requests_failed;
+		return true;
+	}
+
+	m_ranges.push_back( { first_id, first_id + (worker::EntityId) count } );
+	m_available += count;
+	++m_stats.blocks_received;
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetStats
+*/
+entity_id_pool_stats_t EntityIdPool::GetStats() const
+{
+	entity_id_pool_stats_t stats = m_stats;
+	stats.available = m_available;
+	stats.requested = m_requested;
+	return stats;
+}
@@ -0,0 +1,63 @@
+#pragma once
+#include <improbable/worker.h>
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+
+struct entity_id_pool_settings_t
+{
+	uint32_t block_size = 64;		// Ids per ReserveEntityIds request, more blocks go in one request when spawns are waiting.
+	uint32_t low_water = 16;		// Another block is asked for once fewer than this are on hand or on the way.
+};
+
+struct entity_id_pool_stats_t
+{
+	uint32_t available = 0;
+	uint32_t requested = 0;			// Asked for and not back yet.
+	uint64_t taken = 0;
+	uint64_t blocks_received = 0;
+	uint64_t requests_failed = 0;
+};
+
+//--------------------------------------------------------------------------
+// Entity ids reserved ahead of time, so a spawn can send its CreateEntity request
+// the frame it's asked for instead of waiting on a ReserveEntityIds round trip of its own.
+// Reservations come back as contiguous ranges and are handed out in order.
+// Sim thread only.
+//--------------------------------------------------------------------------
+class EntityIdPool
+{
+public:
+	void SetSettings( const entity_id_pool_settings_t& settings )	{ m_settings = settings; }
+
+	bool TryTake( worker::EntityId& id );
+
+	// How many ids to reserve now to stay above the low water mark with waiting spawns
+	// served, 0 when there are enough. Counted as requested from here on.
+	uint32_t TakeRefillCount( uint32_t waiting );
+
+	void OnRequestSent( uint64_t request_id, uint32_t count );
+
+	// False if the request isn't one of the pool's.
+	bool OnResponse( uint64_t request_id, bool success, worker::EntityId first_id );
+
+	entity_id_pool_stats_t GetStats() const;
+
+private:
+	struct id_range_t
+	{
+		worker::EntityId next;
+		worker::EntityId end;
+	};
+
+private:
+	entity_id_pool_settings_t m_settings;
+
+	std::deque<id_range_t> m_ranges;
+	std::unordered_map<uint64_t, uint32_t> m_requests;		// Request id to how many it asked for.
+	uint32_t m_available = 0;
+	uint32_t m_requested = 0;
+
+	entity_id_pool_stats_t m_stats;
+};
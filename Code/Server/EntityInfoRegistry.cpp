@@ -0,0 +1,186 @@
+#include "Server/EntityInfoRegistry.hpp"
+
+//--------------------------------------------------------------------------
+/**
+* ~EntityInfoRegistry
+*/
+EntityInfoRegistry::~EntityInfoRegistry()
+{
+	Clear();
+}
+
+//--------------------------------------------------------------------------
+/**
+* Add
+*/
+entity_info_t* EntityInfoRegistry::Add( const entity_info_t& info )
+{
+	entity_info_t* added = new entity_info_t( info );
+	m_infos.insert( added );
+
+	// Clear the keys and go through the setters so every key lands in its index.
+	added->game_entity = nullptr;
+	added->id = 0;
+	added->entity_creation_request_id = 0;
+	added->entity_deletion_request_id = 0;
+	SetGameEntity( added, info.game_entity );
+	SetEntityId( added, info.id );
+	SetCreationRequestId( added, info.entity_creation_request_id );
+	SetDeletionRequestId( added, info.entity_deletion_request_id );
+	return added;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Remove
+*/
+void EntityInfoRegistry::Remove( entity_info_t* info )
+{
+	auto itr = m_infos.find( info );
+	if( itr == m_infos.end() )
+	{
+		return;
+	}
+
+	Unindex( m_by_entity, info->game_entity, info );
+	Unindex( m_by_entity_id, info->id, info );
+	Unindex( m_by_creation_request, info->entity_creation_request_id, info );
+	Unindex( m_by_deletion_request, info->entity_deletion_request_id, info );
+
+	m_infos.erase( itr );
+	delete info;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Clear
+*/
+void EntityInfoRegistry::Clear()
+{
+	for( entity_info_t* info : m_infos )
+	{
+		delete info;
+	}
+	m_infos.clear();
+	m_by_entity.clear();
+	m_by_entity_id.clear();
+	m_by_creation_request.clear();
+	m_by_deletion_request.clear();
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetGameEntity
+*/
+void EntityInfoRegistry::SetGameEntity( entity_info_t* info, EntityBase* game_entity )
+{
+	Reindex<EntityBase*>( m_by_entity, info->game_entity, game_entity, info, nullptr );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetEntityId
+*/
+void EntityInfoRegistry::SetEntityId( entity_info_t* info, worker::EntityId id )
+{
+	Reindex<worker::EntityId>( m_by_entity_id, info->id, id, info, 0 );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetCreationRequestId
+*/
+void EntityInfoRegistry::SetCreationRequestId( entity_info_t* info, uint64_t request_id )
+{
+	Reindex<uint64_t>( m_by_creation_request, info->entity_creation_request_id, request_id, info, 0 );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetDeletionRequestId
+*/
+void EntityInfoRegistry::SetDeletionRequestId( entity_info_t* info, uint64_t request_id )
+{
+	Reindex<uint64_t>( m_by_deletion_request, info->entity_deletion_request_id, request_id, info, 0 );
+}
+
+//--------------------------------------------------------------------------
+/**
+* FindWithEntity
+*/
+entity_info_t* EntityInfoRegistry::FindWithEntity( EntityBase* entity ) const
+{
+	return Find( m_by_entity, entity );
+}
+
+//--------------------------------------------------------------------------
+/**
+* FindWithEntityId
+*/
+entity_info_t* EntityInfoRegistry::FindWithEntityId( worker::EntityId id ) const
+{
+	return Find( m_by_entity_id, id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* FindWithCreationRequest
+*/
+entity_info_t* EntityInfoRegistry::FindWithCreationRequest( uint64_t request_id ) const
+{
+	return Find( m_by_creation_request, request_id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* FindWithDeletionRequest
+*/
+entity_info_t* EntityInfoRegistry::FindWithDeletionRequest( uint64_t request_id ) const
+{
+	return Find( m_by_deletion_request, request_id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* Reindex
+* Moves the info from its old key to the new one. The unset value is never indexed.
+*/
+template <typename KEY>
+void EntityInfoRegistry::Reindex( std::unordered_map<KEY, entity_info_t*>& index, KEY& field, KEY new_key, entity_info_t* info, KEY unset )
+{
+	if( field != unset )
+	{
+		Unindex( index, field, info );
+	}
+	field = new_key;
+	if( new_key != unset )
+	{
+		index[new_key] = info;
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* Unindex
+* Only drops the key if it still points at this info, a newer info may have claimed it.
+*/
+template <typename KEY>
+void EntityInfoRegistry::Unindex( std::unordered_map<KEY, entity_info_t*>& index, KEY key, entity_info_t* info )
+{
+	auto itr = index.find( key );
+	if( itr != index.end() && itr->second == info )
+	{
+		index.erase( itr );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* Find
+*/
+template <typename KEY>
+entity_info_t* EntityInfoRegistry::Find( const std::unordered_map<KEY, entity_info_t*>& index, KEY key )
+{
+	auto itr = index.find( key );
+	return itr != index.end() ? itr->second : nullptr;
+}
@@ -0,0 +1,106 @@
+#pragma once
+#include <improbable/worker.h>
+
+#include "Engine/Math/Vec2.hpp"
+
+#include "Shared/PlanePositionCodec.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+class EntityBase;
+
+struct entity_info_t
+{
+	EntityBase* game_entity = nullptr;
+	worker::EntityId id = 0;
+	uint64_t entity_creation_request_id = 0;
+	uint64_t entity_deletion_request_id = 0;
+	uint64_t command_response_id = (uint64_t)-1;
+	std::string owner_id = "";
+	bool created = false;
+	bool updated = false;
+
+	// Last position we sent out, used to skip updates that wouldn't change anything.
+	Vec2 last_sent_position = Vec2::ZERO;
+	double last_sent_time = 0.0;
+	bool has_sent_position = false;
+
+	// What clients hold of PlanePosition, and when the low rate improbable::Position last caught up.
+	plane_position_encoder_t plane_position;
+	Vec2 last_sent_coordinates = Vec2::ZERO;
+	double last_coordinates_time = 0.0;
+	bool has_sent_coordinates = false;
+
+	// Last PlayerControls sequence applied, sent back with the position so the owning client can reconcile.
+	uint32_t input_sequence = 0;
+	bool has_input = false;
+	uint32_t acked_input_sequence = 0;
+	bool has_acked_input = false;
+
+	// When RequestEntityCreation was called, for spawn latency.
+	double creation_requested_time = 0.0;
+	uint32_t creation_attempts = 0;		// CreateEntity requests sent, failed ones are sent again with the same id.
+	uint32_t creation_unanswered = 0;	// Of those, still owed a response. Expired ones included, the runtime may yet create them.
+
+	// Players only, from their ClientPing commands. Starts at creation so a client that never pings is evicted too.
+	double last_heartbeat_time = 0.0;
+	double max_heartbeat_gap = 0.0;
+	uint64_t pings = 0;
+	float client_rtt_ms = 0.0f;			// As measured and reported by the client.
+	float client_jitter_ms = 0.0f;
+	double eviction_time = 0.0;			// When it was last deleted for going idle, 0 if never.
+};
+
+//--------------------------------------------------------------------------
+// Owns every entity_info_t the server knows about and indexes them by game entity,
+// entity id and each outstanding request id. Infos are individually allocated so
+// pointers handed out stay valid until the info is removed.
+// Keys must be changed through the setters so the indices stay in sync.
+// Not thread safe, callers hold SpatialOSServer::entity_info_list_lock.
+//--------------------------------------------------------------------------
+class EntityInfoRegistry
+{
+public:
+	EntityInfoRegistry() {};
+	~EntityInfoRegistry();
+
+	// Not copyable, owns the infos.
+	EntityInfoRegistry( const EntityInfoRegistry& ) = delete;
+	EntityInfoRegistry& operator=( const EntityInfoRegistry& ) = delete;
+
+public:
+	entity_info_t* Add( const entity_info_t& info );
+	void Remove( entity_info_t* info );
+	void Clear();
+
+	void SetGameEntity( entity_info_t* info, EntityBase* game_entity );
+	void SetEntityId( entity_info_t* info, worker::EntityId id );
+	void SetCreationRequestId( entity_info_t* info, uint64_t request_id );
+	void SetDeletionRequestId( entity_info_t* info, uint64_t request_id );
+
+	entity_info_t* FindWithEntity( EntityBase* entity ) const;
+	entity_info_t* FindWithEntityId( worker::EntityId id ) const;
+	entity_info_t* FindWithCreationRequest( uint64_t request_id ) const;
+	entity_info_t* FindWithDeletionRequest( uint64_t request_id ) const;
+
+	size_t GetCount() const { return m_infos.size(); }
+	const std::unordered_set<entity_info_t*>& GetAll() const { return m_infos; }
+
+private:
+	template <typename KEY>
+	static void Reindex( std::unordered_map<KEY, entity_info_t*>& index, KEY& field, KEY new_key, entity_info_t* info, KEY unset );
+	template <typename KEY>
+	static void Unindex( std::unordered_map<KEY, entity_info_t*>& index, KEY key, entity_info_t* info );
+	template <typename KEY>
+	static entity_info_t* Find( const std::unordered_map<KEY, entity_info_t*>& index, KEY key );
+
+private:
+	std::unordered_set<entity_info_t*> m_infos;
+
+	std::unordered_map<EntityBase*, entity_info_t*> m_by_entity;
+	std::unordered_map<worker::EntityId, entity_info_t*> m_by_entity_id;
+	std::unordered_map<uint64_t, entity_info_t*> m_by_creation_request;
+	std::unordered_map<uint64_t, entity_info_t*> m_by_deletion_request;
+};
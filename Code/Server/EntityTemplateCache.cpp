@@ -0,0 +1,166 @@
+#include "Server/EntityTemplateCache.hpp"
+
+#include <improbable/standard_library.h>
+
+#include "ClientServer.h"
+
+#include "Shared/PlanePositionCodec.hpp"
+
+// Stands in for the owner's worker id in client class templates, Make swaps it out.
+static const char* const OWNER_PLACEHOLDER = "{owner}";
+
+//--------------------------------------------------------------------------
+/**
+* GetOwnerAttribute
+*/
+static std::string GetOwnerAttribute( const std::string& owner_id )
+{
+	return "workerId:" + owner_id;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetTemplateKey
+*/
+static uint32_t GetTemplateKey( EntityTypeId type_id, EntityOwnerClass owner_class )
+{
+	return ( (uint32_t) type_id << 1 ) | ( owner_class == ENTITY_OWNER_CLIENT ? 1u : 0u );
+}
+
+//--------------------------------------------------------------------------
+/**
+* Build
+*/
+void EntityTemplateCache::Build()
+{
+	for( size_t idx = 0; idx < EntityTypeRegistry::GetCount(); ++idx )
+	{
+		GetTemplate( (EntityTypeId) idx, ENTITY_OWNER_SIMULATION );
+		GetTemplate( (EntityTypeId) idx, ENTITY_OWNER_CLIENT );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* Make
+*/
+worker::Entity EntityTemplateCache::Make( EntityTypeId type_id, const Vec2& position, const std::string& owner_id )
+{
+	EntityOwnerClass owner_class = owner_id.empty() ? ENTITY_OWNER_SIMULATION : ENTITY_OWNER_CLIENT;
+	const entity_template_t& entity_template = GetTemplate( type_id, owner_class );
+	worker::Entity entity = entity_template.entity;
+
+	improbable::Position::Update position_update;
+	position_update.set_coords( { position.x, 0.0f, position.y } );
+	entity.Update<improbable::Position>( position_update );
+
+	siren::PlanePositionData plane_position = MakePlanePositionData( position );
+	siren::PlanePosition::Update plane_position_update;
+	plane_position_update.set_keyframe_x( plane_position.keyframe_x() );
+	plane_position_update.set_keyframe_y( plane_position.keyframe_y() );
+	entity.Update<siren::PlanePosition>( plane_position_update );
+
+	if( owner_class == ENTITY_OWNER_CLIENT )
+	{
+		// The placeholder is in the read ACL and PlayerControls' write ACL.
+		std::string owner_attribute = GetOwnerAttribute( owner_id );
+		worker::Option<improbable::EntityAcl::Data&> acl = entity.Get<improbable::EntityAcl>();
+		acl->read_acl().attribute_set()[entity_template.owner_read_set].attribute()[0] = owner_attribute;
+		acl->component_write_acl()[siren::PlayerControls::ComponentId].attribute_set()[0].attribute()[0] = owner_attribute;
+	}
+	return entity;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetTemplate
+*/
+const EntityTemplateCache::entity_template_t& EntityTemplateCache::GetTemplate( EntityTypeId type_id, EntityOwnerClass owner_class )
+{
+	uint32_t key = GetTemplateKey( type_id, owner_class );
+	auto itr = m_templates.find( key );
+	if( itr != m_templates.end() )
+	{
+		return itr->second;
+	}
+
+	// Simulation owned entities go out with an empty owner id, same as BuildEntity gives them.
+	bool client = owner_class == ENTITY_OWNER_CLIENT;
+	entity_template_t entity_template;
+	entity_template.entity = BuildEntity( EntityTypeRegistry::GetName( type_id ), Vec2::ZERO, client ? OWNER_PLACEHOLDER : "" );
+	if( client )
+	{
+		std::string placeholder_attribute = GetOwnerAttribute( OWNER_PLACEHOLDER );
+		const worker::List<improbable::WorkerAttributeSet>& read_sets = entity_template.entity.Get<improbable::EntityAcl>()->read_acl().attribute_set();
+		for( size_t idx = 0; idx < read_sets.size(); ++idx )
+		{
+			if( read_sets[idx].attribute().size() == 1 && read_sets[idx].attribute()[0] == placeholder_attribute )
+			{
+				entity_template.owner_read_set = idx;
+				break;
+			}
+		}
+	}
+	return m_templates.emplace( key, std::move( entity_template ) ).first->second;
+}
+
+//--------------------------------------------------------------------------
+/**
+* BuildEntity
+*/
+worker::Entity EntityTemplateCache::BuildEntity( const std::string& entity_type, const Vec2& position, const std::string& owner_id )
+{
+	worker::Entity clientEntity;
+
+	clientEntity.Add<improbable::Position>({ { position.x,  0.0f, position.y } });
+	clientEntity.Add<siren::PlanePosition>( MakePlanePositionData( position ) );
+
+
+	worker::List<std::string> callerWorkerAttributeSet{ GetOwnerAttribute( owner_id ) };
+	worker::List<std::string> simulationWorkerAttributeSet{ "simulation" };
+	worker::List<std::string> clientWorkerAttributeSet{ "client" };
+
+	improbable::WorkerRequirementSet clientWorkerRequirementSet{ worker::List<improbable::WorkerAttributeSet>{ {clientWorkerAttributeSet} } };
+	improbable::WorkerRequirementSet simulationWorkerRequirementSet{ worker::List<improbable::WorkerAttributeSet>{ {simulationWorkerAttributeSet} } };
+	improbable::WorkerRequirementSet callerWorkerRequirementSet{ worker::List<improbable::WorkerAttributeSet>{ {callerWorkerAttributeSet} } };
+	improbable::WorkerRequirementSet clientOrSimRequirementSet
+	{
+		worker::List<improbable::WorkerAttributeSet>
+	{
+		simulationWorkerAttributeSet,
+			clientWorkerAttributeSet,
+			callerWorkerAttributeSet
+	}
+	};
+
+	worker::Map<worker::ComponentId, improbable::WorkerRequirementSet> componentAcl;
+	componentAcl[improbable::Position::ComponentId] = simulationWorkerRequirementSet;
+	componentAcl[improbable::EntityAcl::ComponentId] = simulationWorkerRequirementSet;
+	componentAcl[improbable::Metadata::ComponentId] = simulationWorkerRequirementSet;
+	componentAcl[siren::PlayerControls::ComponentId] = callerWorkerRequirementSet;
+	componentAcl[siren::PlayerMovement::ComponentId] = simulationWorkerRequirementSet;
+	componentAcl[siren::PlanePosition::ComponentId] = simulationWorkerRequirementSet;
+	componentAcl[siren::ClientHeartbeat::ComponentId] = simulationWorkerRequirementSet;
+
+	clientEntity.Add<improbable::EntityAcl>(
+		improbable::EntityAcl::Data{/* read */ clientOrSimRequirementSet, /* write */ componentAcl });
+
+	improbable::Metadata::Data metadata;
+	metadata.set_entity_type( entity_type );
+	clientEntity.Add<improbable::Metadata>(metadata);
+
+	siren::PlayerControls::Data client_data;
+	clientEntity.Add<siren::PlayerControls>(client_data);
+	clientEntity.Add<siren::PlayerMovement>( siren::PlayerMovement::Data() );
+	clientEntity.Add<siren::ClientHeartbeat>( siren::ClientHeartbeat::Data() );
+
+	improbable::ComponentInterest::QueryConstraint relativeConstraint;
+	relativeConstraint.set_relative_box_constraint({ {{20.5, 9999, 20.5}} });
+	improbable::ComponentInterest::Query relativeQuery;
+	relativeQuery.set_constraint(relativeConstraint);
+	relativeQuery.set_full_snapshot_result({ true });
+	improbable::ComponentInterest interest{ {relativeQuery} };
+	clientEntity.Add<improbable::Interest>({ {{siren::Client::ComponentId, interest}} });
+
+	return clientEntity;
+}
@@ -0,0 +1,50 @@
+#pragma once
+#include <improbable/worker.h>
+
+#include "Engine/Math/Vec2.hpp"
+
+#include "Shared/EntityTypeRegistry.hpp"
+
+#include <string>
+#include <unordered_map>
+
+enum EntityOwnerClass
+{
+	ENTITY_OWNER_SIMULATION,		// Nothing but the simulation writes to it.
+	ENTITY_OWNER_CLIENT,			// A client worker writes its PlayerControls.
+	NUM_ENTITY_OWNER_CLASSES
+};
+
+//--------------------------------------------------------------------------
+// The worker::Entity CreateEntity sends, built once per definition type and owner
+// class. A spawn copies its template and patches in the position and owner, instead
+// of putting the ACL, metadata and interest together again every time. Client class
+// templates are built for a placeholder owner so the slots to patch can be found.
+// Sim thread only.
+//--------------------------------------------------------------------------
+class EntityTemplateCache
+{
+public:
+	// Every definition type registered so far, in both owner classes.
+	void Build();
+	void Clear()	{ m_templates.clear(); }
+	size_t GetCount() const { return m_templates.size(); }
+
+	// Types that weren't around for Build are built on first use.
+	worker::Entity Make( EntityTypeId type_id, const Vec2& position, const std::string& owner_id );
+
+	// The whole entity from scratch, what every spawn used to do.
+	static worker::Entity BuildEntity( const std::string& entity_type, const Vec2& position, const std::string& owner_id );
+
+private:
+	struct entity_template_t
+	{
+		worker::Entity entity;
+		size_t owner_read_set = 0;		// Read ACL attribute set holding the owner, client class only.
+	};
+
+	const entity_template_t& GetTemplate( EntityTypeId type_id, EntityOwnerClass owner_class );
+
+private:
+	std::unordered_map<uint32_t, entity_template_t> m_templates;	// Type id and owner class.
+};
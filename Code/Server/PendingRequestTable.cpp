@@ -0,0 +1,92 @@
+#include "Server/PendingRequestTable.hpp"
+
+//--------------------------------------------------------------------------
+/**
+* Add
+*/
+void PendingRequestTable::Add( uint64_t request_id, RequestStage stage, worker::EntityId entity_id, double now )
+{
+	pending_request_t& request = m_pending[request_id];
+	request.request_id = request_id;
+	request.stage = stage;
+	request.entity_id = entity_id;
+	request.sent_time = now;
+	request.deadline = now + m_timeout;
+	m_by_deadline.push_back( request_id );
+	++m_stats[stage].sent;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Complete
+*/
+bool PendingRequestTable::Complete( uint64_t request_id, bool success, double now, pending_request_t& request )
+{
+	auto itr = m_pending.find( request_id );
+	if( itr == m_pending.end() )
+	{
+		return false;
+	}
+	request = itr->second;
+	m_pending.erase( itr );
+
+	request_stage_stats_t& stats = m_stats[request.stage];
+	if( success )
+	{
+		++stats.succeeded;
+	}
+	else
+	{
+		++stats.failed;
+	}
+
+	double seconds = now - request.sent_time;
+	stats.total_seconds += seconds;
+	if( seconds > stats.max_seconds )
+	{
+		stats.max_seconds = seconds;
+	}
+
+	int bucket = 0;
+	while( bucket < REQUEST_LATENCY_BUCKET_COUNT - 1 && seconds >= REQUEST_LATENCY_BUCKET_LIMITS[bucket] )
+	{
+		++bucket;
+	}
+	++stats.histogram[bucket];
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* TakeExpired
+*/
+void PendingRequestTable::TakeExpired( double now, std::vector<pending_request_t>& expired )
+{
+	while( !m_by_deadline.empty() )
+	{
+		auto itr = m_pending.find( m_by_deadline.front() );
+		if( itr != m_pending.end() )
+		{
+			if( itr->second.deadline > now )
+			{
+				return;
+			}
+			++m_stats[itr->second.stage].timed_out;
+			expired.push_back( itr->second );
+			m_pending.erase( itr );
+		}
+		m_by_deadline.pop_front();
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* ResetStats
+*/
+void PendingRequestTable::ResetStats()
+{
+	for( request_stage_stats_t& stats : m_stats )
+	{
+		stats = request_stage_stats_t();
+	}
+}
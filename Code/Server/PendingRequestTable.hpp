@@ -0,0 +1,71 @@
+#pragma once
+#include <improbable/worker.h>
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+enum RequestStage
+{
+	REQUEST_STAGE_RESERVE,			// ReserveEntityIds
+	REQUEST_STAGE_CREATE,			// CreateEntity
+	REQUEST_STAGE_DELETE,			// DeleteEntity
+	NUM_REQUEST_STAGES
+};
+
+// Send to response, in seconds.
+constexpr int REQUEST_LATENCY_BUCKET_COUNT = 8;
+constexpr float REQUEST_LATENCY_BUCKET_LIMITS[REQUEST_LATENCY_BUCKET_COUNT - 1] = { 0.005f, 0.01f, 0.025f, 0.05f, 0.1f, 0.25f, 1.0f };
+
+struct request_stage_stats_t
+{
+	uint64_t sent = 0;
+	uint64_t succeeded = 0;
+	uint64_t failed = 0;
+	uint64_t timed_out = 0;			// No response by the deadline, given up on.
+	double total_seconds = 0.0;		// Over succeeded and failed.
+	double max_seconds = 0.0;
+	uint64_t histogram[REQUEST_LATENCY_BUCKET_COUNT] = {};
+};
+
+struct pending_request_t
+{
+	uint64_t request_id = 0;
+	RequestStage stage = REQUEST_STAGE_RESERVE;
+	worker::EntityId entity_id = 0;	// Create and delete.
+	double sent_time = 0.0;
+	double deadline = 0.0;
+};
+
+//--------------------------------------------------------------------------
+// Every entity request the server has in flight, by request id, with the time it
+// was sent so its response can be timed and a deadline for responses that never come.
+// Whoever sent a request owns cleaning up after it fails or expires.
+// Sim thread only.
+//--------------------------------------------------------------------------
+class PendingRequestTable
+{
+public:
+	void SetTimeout( double seconds )	{ m_timeout = seconds; }
+
+	void Add( uint64_t request_id, RequestStage stage, worker::EntityId entity_id, double now );
+
+	// False if the request isn't pending, it expired or was never added.
+	bool Complete( uint64_t request_id, bool success, double now, pending_request_t& request );
+
+	// Removes everything past its deadline into expired, oldest first.
+	void TakeExpired( double now, std::vector<pending_request_t>& expired );
+
+	size_t GetCount() const { return m_pending.size(); }
+	const request_stage_stats_t& GetStats( RequestStage stage ) const { return m_stats[stage]; }
+	void ResetStats();
+
+private:
+	double m_timeout = 10.0;
+
+	std::unordered_map<uint64_t, pending_request_t> m_pending;
+	std::deque<uint64_t> m_by_deadline;		// Same timeout for all, so send order is deadline order. Completed ids are skipped.
+
+	request_stage_stats_t m_stats[NUM_REQUEST_STAGES];
+};
@@ -14,6 +14,10 @@
 #include "Server/WorldSim.hpp"
 
 #include "Shared/Zone.hpp"
+#include "Shared/AbilityBase.hpp"
+#include "Shared/ActorBase.hpp"
+#include "Shared/AIController.hpp"
+#include "Shared/SimController.hpp"
 
 
 
@@ -30,6 +34,7 @@ RNG* g_theRNG = nullptr;
 */
 void ServerApp::Startup()
 {
+	m_startupTime = std::chrono::steady_clock::now();
 	g_theRNG = new RNG();
 
 	g_theEventSystem = new EventSystem();
@@ -39,6 +44,20 @@ void ServerApp::Startup()
 	ClockSystemStartup();
 	m_gameClock = new Clock(&Clock::Master);
 
+	float tick_rate = g_gameConfigBlackboard.GetValue( "tick_rate", 60.0f );
+	if( tick_rate <= 0.0f )
+	{
+		tick_rate = 60.0f;
+	}
+	m_tickSeconds = 1.0f / tick_rate;
+	m_tickPeriod = std::chrono::duration_cast<std::chrono::steady_clock::duration>( std::chrono::duration<double>( 1.0 / (double)tick_rate ) );
+	m_maxCatchUpTicks = (uint32_t) g_gameConfigBlackboard.GetValue( "max_catch_up_ticks", (int) m_maxCatchUpTicks );
+	if( m_maxCatchUpTicks == 0 )
+	{
+		m_maxCatchUpTicks = 1;
+	}
+	std::cout << "Server tick rate: " << tick_rate << " Hz, max catch-up ticks: " << m_maxCatchUpTicks << std::endl;
+
 	std::cout << "Server Zone startup" << std::endl;
 	Zone::Startup();
 
@@ -50,6 +69,9 @@ void ServerApp::Startup()
 	RegisterEvents();
 	std::cout << "Server startup complete" << std::endl;
 
+	// Loading isn't something the first tick should try to catch up on.
+	m_lastRunTime = std::chrono::steady_clock::now();
+
 }
 
 //--------------------------------------------------------------------------
@@ -58,6 +80,13 @@ void ServerApp::Startup()
 */
 void ServerApp::Shutdown()
 {
+	// Picked back up by WorldSim::Startup on the next run.
+	std::string checkpoint_path = g_gameConfigBlackboard.GetValue( "world_checkpoint", std::string() );
+	if( !checkpoint_path.empty() )
+	{
+		SpatialOSServer::SaveWorldCheckpoint( checkpoint_path );
+	}
+
 	g_theSim->Shutdown();
 
 	Zone::Shutdown();
@@ -67,37 +96,92 @@ void ServerApp::Shutdown()
 	SAFE_DELETE(g_theRNG);
 }
 
-static constexpr std::chrono::duration<double> kFramePeriodSeconds{
-	1. / static_cast<double>(60) };
-
 //--------------------------------------------------------------------------
 /**
 * RunFrame
+* Steps the sim in fixed ticks for however much real time has passed, up to
+* m_maxCatchUpTicks at once, then sleeps until the next tick is due.
 */
 void ServerApp::RunFrame()
 {
-	auto start_time = std::chrono::steady_clock::now();
+	float time_scale = 1.0f;
 	if (m_isSlowMo)
 	{
-		m_gameClock->Dilate(0.1f);
+		time_scale = 0.1f;
 	}
 	else if (m_isFastMo)
 	{
-		m_gameClock->Dilate(4.0f);
+		time_scale = 4.0f;
 	}
-	else
+	m_gameClock->Dilate(time_scale);
+
+	auto now = std::chrono::steady_clock::now();
+	m_tickAccumulator += now - m_lastRunTime;
+	m_lastRunTime = now;
+
+	uint32_t steps = 0;
+	while( m_tickAccumulator >= m_tickPeriod && steps < m_maxCatchUpTicks )
 	{
-		m_gameClock->Dilate(1.0f);
+		auto tick_start = std::chrono::steady_clock::now();
+
+		// Unscaled, the send rates are per real tick whatever the dilation.
+		SpatialOSServer::AdvanceTickTime( m_tickSeconds );
+		BeginFrame();
+		Update( m_tickSeconds * time_scale );
+		EndFrame();
+
+		std::chrono::duration<double> tick_duration = std::chrono::steady_clock::now() - tick_start;
+		RecordTick( tick_duration.count() );
+		if( m_tickStats.ticks == 1 )
+		{
+			m_startupToFirstTickSeconds = std::chrono::duration<double>( std::chrono::steady_clock::now() - m_startupTime ).count();
+			std::cout << "Startup to first tick: " << 1000.0 * m_startupToFirstTickSeconds << " ms with "
+				<< SpatialOSServer::GetCreatedEntityCount() << " entities" << std::endl;
+		}
+
+		m_tickAccumulator -= m_tickPeriod;
+		++steps;
 	}
 
+	if( steps > 1 )
+	{
+		++m_tickStats.catch_up_frames;
+	}
 
-	BeginFrame();
-	Update( (float)m_gameClock->GetFrameTime() );
-	EndFrame();
+	// Too far behind to catch up, drop the whole ticks rather than spiral.
+	if( m_tickAccumulator >= m_tickPeriod )
+	{
+		m_tickStats.dropped_ticks += (uint64_t)( m_tickAccumulator / m_tickPeriod );
+		m_tickAccumulator %= m_tickPeriod;
+	}
 
-	auto end_time = std::chrono::steady_clock::now();
-	auto wait_for = kFramePeriodSeconds - (end_time - start_time);
-	std::this_thread::sleep_for(wait_for);
+	std::this_thread::sleep_for( m_tickPeriod - m_tickAccumulator );
+}
+
+//--------------------------------------------------------------------------
+/**
+* RecordTick
+*/
+void ServerApp::RecordTick( double tick_seconds )
+{
+	++m_tickStats.ticks;
+	m_tickStats.total_seconds += tick_seconds;
+	if( tick_seconds > m_tickStats.max_seconds )
+	{
+		m_tickStats.max_seconds = tick_seconds;
+	}
+	if( tick_seconds > (double)m_tickSeconds )
+	{
+		++m_tickStats.overruns;
+	}
+
+	float budget_used = (float)( tick_seconds / (double)m_tickSeconds );
+	int bucket = 0;
+	while( bucket < TICK_HISTOGRAM_BUCKET_COUNT - 1 && budget_used >= TICK_HISTOGRAM_BUCKET_LIMITS[bucket] )
+	{
+		++bucket;
+	}
+	++m_tickStats.histogram[bucket];
 }
 
 //--------------------------------------------------------------------------
@@ -120,6 +204,204 @@ bool ServerApp::QuitEvent( EventArgs& args )
 	return true;
 }
 
+//--------------------------------------------------------------------------
+/**
+* PositionStatsEvent
+*/
+bool ServerApp::PositionStatsEvent( EventArgs& args )
+{
+	UNUSED( args );
+	const position_update_stats_t& stats = SpatialOSServer::GetPositionUpdateStats();
+	std::cout << "Position updates last frame | sent: " << stats.sent << " suppressed: " << stats.suppressed 
+		<< " keyframes: " << stats.keyframes << " with Position: " << stats.coordinates_sent << std::endl;
+	double bytes_per_update = stats.sent > 0 ? (double)stats.sent_bytes / (double)stats.sent : 0.0;
+	double percent_of_coordinates = stats.coordinates_only_bytes > 0 ? 100.0 * (double)stats.sent_bytes / (double)stats.coordinates_only_bytes : 0.0;
+	std::cout << "	bytes: " << stats.sent_bytes << " (" << bytes_per_update << " per update) as Position alone: " << stats.coordinates_only_bytes 
+		<< " (" << percent_of_coordinates << "%)" << std::endl;
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* OpStatsEvent
+*/
+bool ServerApp::OpStatsEvent( EventArgs& args )
+{
+	UNUSED( args );
+	op_coalesce_stats_t stats = SpatialOSServer::GetOpCoalesceStats();
+	std::cout << "State ops | received: " << stats.received << " applied: " << stats.applied 
+		<< " merged: " << stats.merged << " cancelled: " << stats.cancelled << std::endl;
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SpawnStatsEvent
+*/
+bool ServerApp::SpawnStatsEvent( EventArgs& args )
+{
+	UNUSED( args );
+	entity_id_pool_stats_t pool = SpatialOSServer::GetEntityIdPoolStats();
+	const spawn_stats_t& spawns = SpatialOSServer::GetSpawnStats();
+	std::cout << "Entity id pool | available: " << pool.available << " requested: " << pool.requested 
+		<< " blocks: " << pool.blocks_received << " failed: " << pool.requests_failed << " taken: " << pool.taken << std::endl;
+	double average_ms = spawns.created > 0 ? 1000.0 * spawns.total_latency_seconds / (double)spawns.created : 0.0;
+	std::cout << "	spawns requested: " << spawns.requested << " from pool: " << spawns.from_pool << " waited: " << spawns.waited 
+		<< " created: " << spawns.created << " latency avg: " << average_ms << "ms max: " << 1000.0 * spawns.max_latency_seconds << "ms" << std::endl;
+	double build_us = spawns.built > 0 ? 1000000.0 * spawns.total_build_seconds / (double)spawns.built : 0.0;
+	std::cout << "	dropped after failing to create: " << spawns.dropped << std::endl;
+	std::cout << "	entities built: " << spawns.built << " from template: " << spawns.from_template 
+		<< " (" << SpatialOSServer::GetEntityTemplateCount() << " cached) avg build: " << build_us << "us" << std::endl;
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RequestStatsEvent
+*/
+bool ServerApp::RequestStatsEvent( EventArgs& args )
+{
+	UNUSED( args );
+	static const char* stage_names[NUM_REQUEST_STAGES] = { "ReserveEntityIds", "CreateEntity", "DeleteEntity" };
+	std::cout << "Entity requests in flight: " << SpatialOSServer::GetPendingRequestCount() << std::endl;
+	for( int stage = 0; stage < NUM_REQUEST_STAGES; ++stage )
+	{
+		request_stage_stats_t stats = SpatialOSServer::GetRequestStats( (RequestStage) stage );
+		uint64_t responses = stats.succeeded + stats.failed;
+		double average_ms = responses > 0 ? 1000.0 * stats.total_seconds / (double)responses : 0.0;
+		std::cout << stage_names[stage] << " | sent: " << stats.sent << " succeeded: " << stats.succeeded << " failed: " << stats.failed 
+			<< " timed out: " << stats.timed_out << " avg ms: " << average_ms << " max ms: " << 1000.0 * stats.max_seconds << std::endl;
+
+		float lower = 0.0f;
+		for( int bucket = 0; bucket < REQUEST_LATENCY_BUCKET_COUNT; ++bucket )
+		{
+			std::cout << "	" << lower * 1000.0f << "ms";
+			if( bucket < REQUEST_LATENCY_BUCKET_COUNT - 1 )
+			{
+				lower = REQUEST_LATENCY_BUCKET_LIMITS[bucket];
+				std::cout << " - " << lower * 1000.0f << "ms";
+			}
+			else
+			{
+				std::cout << " and up";
+			}
+			std::cout << ": " << stats.histogram[bucket] << std::endl;
+		}
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RequestStatsResetEvent
+*/
+bool ServerApp::RequestStatsResetEvent( EventArgs& args )
+{
+	UNUSED( args );
+	SpatialOSServer::ResetRequestStats();
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* ClientStatsEvent
+*/
+bool ServerApp::ClientStatsEvent( EventArgs& args )
+{
+	UNUSED( args );
+	const client_heartbeat_stats_t& stats = SpatialOSServer::GetClientHeartbeatStats();
+	std::vector<client_link_stats_t> links;
+	SpatialOSServer::GetClientLinks( links );
+	std::cout << "Clients: " << links.size() << " | pings: " << stats.pings << " rejected: " << stats.rejected << " evicted idle: " << stats.evicted << std::endl;
+	for( const client_link_stats_t& link : links )
+	{
+		std::cout << "	" << link.worker_id << " entity " << link.id << " | pings: " << link.pings << " rtt: " << link.rtt_ms << "ms jitter: " << link.jitter_ms
+			<< "ms last heartbeat: " << link.seconds_since_heartbeat << "s ago longest gap: " << link.max_heartbeat_gap << "s" << std::endl;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* PrintPoolStats
+*/
+static void PrintPoolStats( const char* name, const pool_stats_t& stats )
+{
+	std::cout << name << " pool | live: " << stats.live << " high water: " << stats.high_water << " capacity: " << stats.capacity 
+		<< " allocations: " << stats.allocations << " heap fallbacks: " << stats.fallbacks << std::endl;
+}
+
+//--------------------------------------------------------------------------
+/**
+* PoolStatsEvent
+*/
+bool ServerApp::PoolStatsEvent( EventArgs& args )
+{
+	UNUSED( args );
+	PrintPoolStats( "Ability", AbilityBase::GetPool().GetStats() );
+	PrintPoolStats( "Actor", ActorBase::GetPool().GetStats() );
+	PrintPoolStats( "AIController", AIController::GetPool().GetStats() );
+	PrintPoolStats( "SimController", SimController::GetPool().GetStats() );
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* TickStatsEvent
+*/
+bool ServerApp::TickStatsEvent( EventArgs& args )
+{
+	UNUSED( args );
+	const tick_stats_t& stats = g_theServerApp->GetTickStats();
+	double average_ms = stats.ticks > 0 ? 1000.0 * stats.total_seconds / (double)stats.ticks : 0.0;
+	std::cout << "Ticks | count: " << stats.ticks << " overruns: " << stats.overruns << " catch-up frames: " << stats.catch_up_frames 
+		<< " dropped: " << stats.dropped_ticks << " avg ms: " << average_ms << " max ms: " << 1000.0 * stats.max_seconds << std::endl;
+
+	float lower = 0.0f;
+	for( int bucket = 0; bucket < TICK_HISTOGRAM_BUCKET_COUNT; ++bucket )
+	{
+		std::cout << "	" << (int)( lower * 100.0f ) << "%";
+		if( bucket < TICK_HISTOGRAM_BUCKET_COUNT - 1 )
+		{
+			lower = TICK_HISTOGRAM_BUCKET_LIMITS[bucket];
+			std::cout << " - " << (int)( lower * 100.0f ) << "%";
+		}
+		else
+		{
+			std::cout << " and up";
+		}
+		std::cout << " of budget: " << stats.histogram[bucket] << std::endl;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* TickStatsResetEvent
+*/
+bool ServerApp::TickStatsResetEvent( EventArgs& args )
+{
+	UNUSED( args );
+	g_theServerApp->m_tickStats = tick_stats_t();
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* CheckpointEvent
+* Saves to path= or the configured world_checkpoint.
+*/
+bool ServerApp::CheckpointEvent( EventArgs& args )
+{
+	std::string path = args.GetValue( "path", g_gameConfigBlackboard.GetValue( "world_checkpoint", std::string() ) );
+	if( path.empty() )
+	{
+		std::cout << "Checkpoint | no path given and no world_checkpoint configured" << std::endl;
+		return true;
+	}
+	std::cout << "Checkpoint | " << ( SpatialOSServer::SaveWorldCheckpoint( path ) ? "saved to " : "failed to save to " ) << path << std::endl;
+	return true;
+}
 
 //--------------------------------------------------------------------------
 /**
@@ -160,5 +442,15 @@ void ServerApp::EndFrame()
 void ServerApp::RegisterEvents()
 {
 	g_theEventSystem->SubscribeEventCallbackFunction( "quit", QuitEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "position_stats", PositionStatsEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "op_stats", OpStatsEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "spawn_stats", SpawnStatsEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "request_stats", RequestStatsEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "request_stats_reset", RequestStatsResetEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "client_stats", ClientStatsEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "pool_stats", PoolStatsEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "tick_stats", TickStatsEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "tick_stats_reset", TickStatsResetEvent );
+	g_theEventSystem->SubscribeEventCallbackFunction( "checkpoint", CheckpointEvent );
 }
 
@@ -1,8 +1,26 @@
 #pragma once
 #include "Engine/Core/EventSystem.hpp"
 
+#include <chrono>
+#include <cstdint>
+
 class Clock;
 
+// Tick durations bucketed by how much of the tick budget they used.
+constexpr int TICK_HISTOGRAM_BUCKET_COUNT = 6;
+constexpr float TICK_HISTOGRAM_BUCKET_LIMITS[TICK_HISTOGRAM_BUCKET_COUNT - 1] = { 0.25f, 0.5f, 0.75f, 1.0f, 2.0f };
+
+struct tick_stats_t
+{
+	uint64_t ticks = 0;
+	uint64_t overruns = 0;				// Ticks that took longer than the tick period.
+	uint64_t catch_up_frames = 0;		// RunFrame calls that had to step more than once.
+	uint64_t dropped_ticks = 0;			// Steps given up on after hitting the catch-up limit.
+	double total_seconds = 0.0;
+	double max_seconds = 0.0;
+	uint64_t histogram[TICK_HISTOGRAM_BUCKET_COUNT] = {};
+};
+
 //--------------------------------------------------------------------------
 class ServerApp
 {
@@ -17,12 +35,26 @@ public:
 	bool IsQuitting() const { return m_isQuitting; }
 
 	static bool QuitEvent( EventArgs& args );
+	static bool PositionStatsEvent( EventArgs& args );
+	static bool OpStatsEvent( EventArgs& args );
+	static bool SpawnStatsEvent( EventArgs& args );
+	static bool RequestStatsEvent( EventArgs& args );
+	static bool RequestStatsResetEvent( EventArgs& args );
+	static bool ClientStatsEvent( EventArgs& args );
+	static bool PoolStatsEvent( EventArgs& args );
+	static bool TickStatsEvent( EventArgs& args );
+	static bool TickStatsResetEvent( EventArgs& args );
+	static bool CheckpointEvent( EventArgs& args );
+
+	const tick_stats_t& GetTickStats() const { return m_tickStats; }
+	double GetStartupToFirstTickSeconds() const { return m_startupToFirstTickSeconds; }
 
 private:
 	void BeginFrame();
 	void Update( float deltaSeconds );
 	void EndFrame();
 	void RegisterEvents();
+	void RecordTick( double tick_seconds );
 
 private:
 	bool m_isQuitting = false;
@@ -33,4 +65,15 @@ private:
 
 	Clock* m_gameClock = nullptr;
 
+	// Fixed step, configured from tick_rate and max_catch_up_ticks in GameConfig.
+	std::chrono::steady_clock::duration m_tickPeriod = std::chrono::steady_clock::duration::zero();
+	float m_tickSeconds = 1.0f / 60.0f;
+	uint32_t m_maxCatchUpTicks = 5;
+	std::chrono::steady_clock::time_point m_lastRunTime;
+	std::chrono::steady_clock::duration m_tickAccumulator = std::chrono::steady_clock::duration::zero();
+	tick_stats_t m_tickStats;
+
+	std::chrono::steady_clock::time_point m_startupTime;
+	double m_startupToFirstTickSeconds = 0.0;
+
 };
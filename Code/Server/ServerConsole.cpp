@@ -0,0 +1,96 @@
+#include "Server/ServerConsole.hpp"
+
+#include "Engine/Core/EventSystem.hpp"
+
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+std::mutex ServerConsole::s_lock;
+std::deque<std::string> ServerConsole::s_lines;
+bool ServerConsole::s_started = false;
+
+//--------------------------------------------------------------------------
+/**
+* Startup
+* The reader is never joined, it can sit in getline until the process exits.
+*/
+void ServerConsole::Startup()
+{
+	if( s_started )
+	{
+		return;
+	}
+	s_started = true;
+	std::thread( ReadLoop ).detach();
+}
+
+//--------------------------------------------------------------------------
+/**
+* Pump
+*/
+void ServerConsole::Pump()
+{
+	std::deque<std::string> lines;
+	{
+		std::lock_guard<std::mutex> lg( s_lock );
+		if( s_lines.empty() )
+		{
+			return;
+		}
+		lines.swap( s_lines );
+	}
+
+	for( const std::string& line : lines )
+	{
+		FireCommand( line );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* ReadLoop
+*/
+void ServerConsole::ReadLoop()
+{
+	std::string line;
+	while( std::getline( std::cin, line ) )
+	{
+		if( line.find_first_not_of( " \t\r" ) == std::string::npos )
+		{
+			continue;
+		}
+		std::lock_guard<std::mutex> lg( s_lock );
+		s_lines.push_back( line );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* FireCommand
+* Arguments without an '=' are flags and read as true.
+*/
+void ServerConsole::FireCommand( const std::string& line )
+{
+	std::istringstream tokens( line );
+	std::string name;
+	tokens >> name;
+
+	EventArgs args;
+	std::string token;
+	while( tokens >> token )
+	{
+		size_t split = token.find( '=' );
+		if( split == std::string::npos )
+		{
+			args.SetValue( token, "true" );
+		}
+		else
+		{
+			args.SetValue( token.substr( 0, split ), token.substr( split + 1 ) );
+		}
+	}
+
+	std::cout << "> " << line << std::endl;
+	g_theEventSystem->FireEvent( name, args );
+}
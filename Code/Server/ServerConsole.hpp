@@ -0,0 +1,29 @@
+#pragma once
+
+#include <deque>
+#include <mutex>
+#include <string>
+
+//--------------------------------------------------------------------------
+// Console commands for a worker without a window. Lines are read off stdin by a
+// detached thread so the sim never blocks waiting on input, and fired through the
+// EventSystem from the sim thread in Pump. A line is an event name followed by
+// key=value arguments, "checkpoint path=world.wckp". Stops reading at end of input.
+//--------------------------------------------------------------------------
+class ServerConsole
+{
+public:
+	static void Startup();
+
+	// Sim thread, after the EventSystem has started.
+	static void Pump();
+
+private:
+	static void ReadLoop();
+	static void FireCommand( const std::string& line );
+
+private:
+	static std::mutex s_lock;
+	static std::deque<std::string> s_lines;
+	static bool s_started;
+};
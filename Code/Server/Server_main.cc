@@ -2,6 +2,9 @@
 #include "Server/SpatialOSServer.hpp"
 #include "Server/ServerApp.hpp"
 #include "Server/ServerCommon.hpp"
+#include "Server/ServerConsole.hpp"
+
+#include "Shared/AsyncLog.hpp"
 
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/Strings/NamedStrings.hpp"
@@ -12,6 +15,7 @@
 //-----------------------------------------------------------------------------------------------
 void RunFrame()
 {
+	ServerConsole::Pump();
 	g_theServerApp->RunFrame();
 }
 
@@ -29,6 +33,9 @@ void Startup()
 	g_theServerApp = new ServerApp();
 	g_theServerApp->Startup();
 	std::cout << "After ServerApp Startup" << std::endl;
+
+	// tick_stats, spawn_stats and the rest of ServerApp's events, typed into the worker's stdin.
+	ServerConsole::Startup();
 }
 
 //-----------------------------------------------------------------------------------------------
@@ -45,6 +52,7 @@ void Shutdown()
 // Entry point
 int main( int argc, char** argv ) 
 {
+	AsyncLog::Startup();
 	std::cout << "MAIN BEGIN" << std::endl;
 	std::vector<std::string> arguments;
 
@@ -83,6 +91,7 @@ int main( int argc, char** argv )
 	SpatialOSServer::Shutdown();
 
 	std::cout << "SHUTDOWN COMPLETE" << std::endl;
+	AsyncLog::Shutdown();
 
     return 0;
 }
@@ -10,7 +10,9 @@
 #include <algorithm>
 #include <chrono>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
+#include <memory>
 
 #include "Server/WorldSim.hpp"
 
@@ -19,33 +21,28 @@
 
 #include "Server/View.hpp"
 #include "Server/ServerCommon.hpp"
+#include "Server/WorldCheckpoint.hpp"
 
-typedef unsigned int uint;
-
+#include "Shared/AsyncLog.hpp"
+#include "Shared/SpatialOSConnection.hpp"
+#include "Shared/LocalWorkerBus.hpp"
 
-
-using ComponentRegistry 
-	= worker::Components<
-	improbable::Position,
-	improbable::EntityAcl,
-	improbable::Metadata,
-	improbable::Persistence,
-	improbable::Interest,
-	siren::PlayerControls,
-	siren::ServerAPI
-	>;
+typedef unsigned int uint;
 
 // Constants and parameters
 const int ErrorExitStatus = 1;
 const std::string kLoggerName = "SpatialOSServer.cpp";
-const std::uint32_t kGetOpListTimeoutInMilliseconds = 100;
+const std::uint32_t kNetworkPumpTimeoutInMilliseconds = 2;	// Longest the network thread sits on GetOpList before sending again.
+const size_t kInboundQueueCapacity = 4096;
+const size_t kOutboundQueueCapacity = 1024;
+const uint32_t kMaxEntityCreationAttempts = 3;
 
 worker::Connection ConnectWithReceptionist(const std::string hostname,
 	const std::uint16_t port,
 	const std::string& worker_id,
 	const worker::ConnectionParameters& connection_parameters) {
 	std::cout << "Connecting to host: " << hostname <<  " port: " << port << " id: " << worker_id << std::endl;
-	auto future = worker::Connection::ConnectAsync(ComponentRegistry{}, hostname, port, worker_id, connection_parameters);
+	auto future = worker::Connection::ConnectAsync(WorkerComponentRegistry{}, hostname, port, worker_id, connection_parameters);
 	return future.Get();
 }
 
@@ -63,6 +60,34 @@ std::string get_random_characters(size_t count) {
 	return str;
 }
 
+//--------------------------------------------------------------------------
+/**
+* PushInOrder
+* Pushes onto the queue unless it's full or older items are still waiting, then it waits with them.
+*/
+template <typename T>
+static void PushInOrder( SpscQueue<T>& queue, std::deque<T>& backlog, T&& item )
+{
+	if( backlog.empty() && queue.TryPush( std::move( item ) ) )
+	{
+		return;
+	}
+	backlog.push_back( std::move( item ) );
+}
+
+//--------------------------------------------------------------------------
+/**
+* RetryBacklog
+*/
+template <typename T>
+static void RetryBacklog( SpscQueue<T>& queue, std::deque<T>& backlog )
+{
+	while( !backlog.empty() && queue.TryPush( std::move( backlog.front() ) ) )
+	{
+		backlog.pop_front();
+	}
+}
+
 
 //--------------------------------------------------------------------------
 /**
@@ -70,6 +95,7 @@ std::string get_random_characters(size_t count) {
 */
 void SpatialOSServer::Startup( const std::vector<std::string>& arguments )
 {
+	Zone::GetZone()->SetEntityDestroyedCallback( EntityDestroyed );
 	GetInstance()->server_thread = std::thread( Run, arguments );
 	while (!GetInstance()->IsRunning())
 	{
@@ -90,42 +116,67 @@ void SpatialOSServer::Shutdown()
 //--------------------------------------------------------------------------
 /**
 * Process
+* Applies whatever the network thread decoded since last frame. Anything it pushes
+* while we drain waits for the next frame so the frame length stays bounded.
 */
 void SpatialOSServer::Process()
 {
-	auto op_list = GetInstance()->connection->GetOpList(0);
-	GetInstance()->view->Process( op_list );
+	SpatialOSServer* server = GetInstance();
+	size_t count = server->inbound_changes.GetSize();
+	inbound_change_t change;
+	for( size_t idx = 0; idx < count && server->inbound_changes.TryPop( change ); ++idx )
+	{
+		server->ApplyChange( change );
+	}
+
+	RetryBacklog( server->outbound_messages, server->outbound_backlog );
+	ExpireRequests();
+	EvictIdleClients();
 
-	GetInstance()->Update();
+	// Fills the pool before the first spawn asks for an id.
+	if( IsRunning() )
+	{
+		RefillEntityIds();
+	}
 }
 
 //--------------------------------------------------------------------------
 /**
 * RequestEntityCreation
 */
-void SpatialOSServer::RequestEntityCreation( EntityBase* entity_to_create )
+void SpatialOSServer::RequestEntityCreation( EntityBase* entity_to_create, const std::string& owner_id, uint64_t command_response_id )
 {
-	std::cout << "Inside RequestEntityCreation" << std::endl;
 	if( !IsRunning() )
 	{
-		std::cout << "Server not running, (SpatialOSServer::RequestEntityCreation)" << std::endl;
+		LOG_WARNING( "Server", "RequestEntityCreation while the server isn't running" );
 		return;
 	}
-	std::cout << "Server running, (SpatialOSServer::RequestEntityCreation)" << std::endl;
-	GetInstance()->entity_info_list_lock.lock();
+	SpatialOSServer* server = GetInstance();
+	server->entity_info_list_lock.lock();
 
 	entity_info_t info;
-	// Reserve an entity ID.
-	std::cout << "Requesting (Entity Creation)" << std::endl;
-	info.entity_id_reservation_request_id = GetInstance()->connection->SendReserveEntityIdsRequest(1, {}).Id;
-
-	GetInstance()->connection->SendLogMessage(worker::LogLevel::kInfo, kLoggerName, Stringf( "RequestEntityCreation successfully with ID: %u", info.entity_id_reservation_request_id ) );
-
-	std::cout << "Request Sent (Entity Creation) With ResponseID: " << info.entity_id_reservation_request_id << std::endl;
 	info.game_entity = entity_to_create;
-
-	GetInstance()->entity_info_list.push_back( info );
-	GetInstance()->entity_info_list_lock.unlock();
+	info.owner_id = owner_id;
+	info.command_response_id = command_response_id;
+	info.creation_requested_time = GetCurrentTimeSeconds();
+	info.last_heartbeat_time = info.creation_requested_time;
+	entity_info_t* added = server->entity_info_list.Add( info );
+	server->entity_info_list_lock.unlock();
+
+	// Straight from the pool when it has an id, behind anything already waiting otherwise.
+	++server->spawn_stats.requested;
+	worker::EntityId id;
+	if( server->entities_waiting_for_ids.empty() && server->entity_id_pool.TryTake( id ) )
+	{
+		++server->spawn_stats.from_pool;
+		SendEntityCreation( added, id );
+	}
+	else
+	{
+		++server->spawn_stats.waited;
+		server->entities_waiting_for_ids.push_back( entity_to_create );
+	}
+	RefillEntityIds();
 }
 
 //--------------------------------------------------------------------------
@@ -134,30 +185,338 @@ void SpatialOSServer::RequestEntityCreation( EntityBase* entity_to_create )
 */
 void SpatialOSServer::RequestEntityDeletion( const worker::EntityId entity )
 {
-	GetInstance()->connection->SendDeleteEntityRequest( entity, 5000 );
+	outbound_message_t message;
+	message.type = OUTBOUND_DELETE_ENTITY;
+	message.id = entity;
+	GetInstance()->PushOutbound( std::move( message ) );
+}
+
+//--------------------------------------------------------------------------
+/**
+* MakeCoordinatesUpdate
+* The game is flat, y is always 0.
+*/
+static improbable::Position::Update MakeCoordinatesUpdate( const Vec2& position )
+{
+	improbable::Position::Update update;
+	update.set_coords( improbable::Coordinates( position.x, 0.0, position.y ) );
+	return update;
 }
 
 //--------------------------------------------------------------------------
 /**
 * UpdatePosition
+* Queues the entity's position for the end of frame flush if it moved enough since the last send.
 */
 void SpatialOSServer::UpdatePosition( EntityBase* entity )
 {
-//	std::cout << "SpatialOSServer::UpdatePosition" << std::endl;
+	UpdatePosition( entity, entity->GetPosition() );
+}
+
+//--------------------------------------------------------------------------
+/**
+* UpdatePosition
+* Same as above with the position already at hand, e.g. read out of the Zone's EntityStore.
+*/
+void SpatialOSServer::UpdatePosition( EntityBase* entity, const Vec2& position )
+{
 	entity_info_t* info = GetInfoWithEnity( entity );
+	if( !info || !info->created )
+	{
+		return;
+	}
+
+	// The ack doesn't wait on the throttle, a held back position would hold back the client's reconcile too.
+	bool sent = QueuePosition( info, position );
+	bool input_unacked = info->has_input && ( !info->has_acked_input || info->acked_input_sequence != info->input_sequence );
+	if( info->has_input && ( sent || input_unacked ) )
+	{
+		GetInstance()->pending_movement_updates.push_back( { info->id, info->input_sequence, position, entity->GetVelocity() } );
+		info->acked_input_sequence = info->input_sequence;
+		info->has_acked_input = true;
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* QueuePosition
+* The epsilon and rate throttles, true if the position itself went out.
+*/
+bool SpatialOSServer::QueuePosition( entity_info_t* info, const Vec2& position )
+{
+	SpatialOSServer* server = GetInstance();
+	const position_update_settings_t& settings = server->position_update_settings;
+	position_update_stats_t& stats = server->position_update_stats;
+	double now = server->tick_time;
+	bool coordinates_due = !info->has_sent_coordinates || settings.coordinates_rate_hz <= 0.0f 
+		|| ( now - info->last_coordinates_time ) >= 1.0 / (double)settings.coordinates_rate_hz;
+
+	pending_position_t pending;
+	pending.id = info->id;
+	pending.position = position;
+
+	if( info->has_sent_position )
+	{
+		Vec2 moved = position - info->last_sent_position;
+		bool too_small = moved.GetLengthSquared() <= settings.epsilon * settings.epsilon;
+		bool too_soon = settings.max_rate_hz > 0.0f && ( now - info->last_sent_time ) < 1.0 / (double)settings.max_rate_hz;
+		if( too_small || too_soon )
+		{
+			++stats.suppressed;
+
+			// Position trails PlanePosition, let it catch up once the entity settles.
+			bool coordinates_behind = ( info->last_sent_position - info->last_sent_coordinates ).GetLengthSquared() > 0.0f;
+			if( !too_soon && coordinates_due && coordinates_behind )
+			{
+				pending.position = info->last_sent_position;
+				pending.send_coordinates = true;
+				info->last_sent_coordinates = info->last_sent_position;
+				info->last_coordinates_time = now;
+				++stats.coordinates_sent;
+				stats.sent_bytes += GetSerializedSize( MakeCoordinatesUpdate( pending.position ) );
+				server->pending_position_updates.push_back( std::move( pending ) );
+			}
+			return false;
+		}
+	}
+
+	pending.send_plane_position = EncodePlanePosition( info->plane_position, position, settings.plane_position, pending.plane_position );
+	pending.send_coordinates = coordinates_due;
+	if( !pending.send_plane_position && !pending.send_coordinates )
+	{
+		// Moved less than a PlanePosition step.
+		++stats.suppressed;
+		return false;
+	}
+
+	size_t coordinates_bytes = GetSerializedSize( MakeCoordinatesUpdate( position ) );
+	stats.coordinates_only_bytes += coordinates_bytes;
+	if( pending.send_plane_position )
+	{
+		stats.sent_bytes += GetSerializedSize( pending.plane_position );
+		if( info->plane_position.updates_since_keyframe == 0 )
+		{
+			++stats.keyframes;
+		}
+	}
+	if( pending.send_coordinates )
+	{
+		stats.sent_bytes += coordinates_bytes;
+		++stats.coordinates_sent;
+		info->last_sent_coordinates = position;
+		info->last_coordinates_time = now;
+		info->has_sent_coordinates = true;
+	}
+
+	info->last_sent_position = position;
+	info->last_sent_time = now;
+	info->has_sent_position = true;
+	server->pending_position_updates.push_back( std::move( pending ) );
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* FlushPositionUpdates
+* Hands everything UpdatePosition queued this frame to the network thread as one message
+* and rolls the frame counters over.
+*/
+void SpatialOSServer::FlushPositionUpdates()
+{
+	SpatialOSServer* server = GetInstance();
+	if( IsRunning() && ( !server->pending_position_updates.empty() || !server->pending_movement_updates.empty() ) )
+	{
+		server->position_update_stats.sent = (uint32_t) server->pending_position_updates.size();
+
+		outbound_message_t message;
+		message.type = OUTBOUND_POSITION_UPDATES;
+		message.positions.swap( server->pending_position_updates );
+		message.movements.swap( server->pending_movement_updates );
+		server->PushOutbound( std::move( message ) );
+	}
+	server->pending_position_updates.clear();
+	server->pending_movement_updates.clear();
+
+	server->last_frame_position_update_stats = server->position_update_stats;
+	server->position_update_stats = position_update_stats_t();
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetPositionUpdateSettings
+*/
+void SpatialOSServer::SetPositionUpdateSettings( const position_update_settings_t& settings )
+{
+	GetInstance()->position_update_settings = settings;
+}
+
+//--------------------------------------------------------------------------
+/**
+* AdvanceTickTime
+* Once per sim tick, so catch-up ticks in one frame are spaced out like any others.
+*/
+void SpatialOSServer::AdvanceTickTime( double seconds )
+{
+	GetInstance()->tick_time += seconds;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetPositionUpdateStats
+*/
+const position_update_stats_t& SpatialOSServer::GetPositionUpdateStats()
+{
+	return GetInstance()->last_frame_position_update_stats;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetEntityIdPoolSettings
+*/
+void SpatialOSServer::SetEntityIdPoolSettings( const entity_id_pool_settings_t& settings )
+{
+	GetInstance()->entity_id_pool.SetSettings( settings );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetEntityIdPoolStats
+*/
+entity_id_pool_stats_t SpatialOSServer::GetEntityIdPoolStats()
+{
+	return GetInstance()->entity_id_pool.GetStats();
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetSpawnStats
+*/
+const spawn_stats_t& SpatialOSServer::GetSpawnStats()
+{
+	return GetInstance()->spawn_stats;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetEntityTemplatesEnabled
+* Builds the templates for every definition loaded so far.
+*/
+void SpatialOSServer::SetEntityTemplatesEnabled( bool enabled )
+{
+	SpatialOSServer* server = GetInstance();
+	server->use_entity_templates = enabled;
+	if( enabled )
+	{
+		server->entity_templates.Build();
+	}
+	else
+	{
+		server->entity_templates.Clear();
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetEntityTemplateCount
+*/
+size_t SpatialOSServer::GetEntityTemplateCount()
+{
+	return GetInstance()->entity_templates.GetCount();
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetRequestTimeout
+*/
+void SpatialOSServer::SetRequestTimeout( double seconds )
+{
+	GetInstance()->pending_requests.SetTimeout( seconds );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetRequestStats
+*/
+request_stage_stats_t SpatialOSServer::GetRequestStats( RequestStage stage )
+{
+	return GetInstance()->pending_requests.GetStats( stage );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetPendingRequestCount
+*/
+size_t SpatialOSServer::GetPendingRequestCount()
+{
+	return GetInstance()->pending_requests.GetCount();
+}
+
+//--------------------------------------------------------------------------
+/**
+* ResetRequestStats
+*/
+void SpatialOSServer::ResetRequestStats()
+{
+	GetInstance()->pending_requests.ResetStats();
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetClientIdleTimeout
+* 0 never evicts.
+*/
+void SpatialOSServer::SetClientIdleTimeout( double seconds )
+{
+	GetInstance()->client_idle_timeout = seconds;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetClientHeartbeatStats
+*/
+const client_heartbeat_stats_t& SpatialOSServer::GetClientHeartbeatStats()
+{
+	return GetInstance()->client_heartbeat_stats;
+}
 
-	if( info && info->created )
+//--------------------------------------------------------------------------
+/**
+* GetClientLinks
+* Every player entity with an owning client.
+*/
+void SpatialOSServer::GetClientLinks( std::vector<client_link_stats_t>& links )
+{
+	SpatialOSServer* server = GetInstance();
+	double now = GetCurrentTimeSeconds();
+	std::lock_guard<std::mutex> lg( server->entity_info_list_lock );
+	for( const entity_info_t* info : server->entity_info_list.GetAll() )
 	{
-		improbable::Position::Update posUpdate;
-		Vec2 position = entity->GetPosition();
-		improbable::Coordinates coords( position.x, 0.0f,  position.y );
-		posUpdate.set_coords( coords );
-		worker::UpdateParameters params;
-//		std::cout << "sending update with: " << position.x << ", " << position.y << "with entityID: " << info->id << std::endl;  
-		GetInstance()->connection->SendComponentUpdate<improbable::Position>( info->id, posUpdate, params );
+		if( info->owner_id.empty() )
+		{
+			continue;
+		}
+		client_link_stats_t link;
+		link.worker_id = info->owner_id;
+		link.id = info->id;
+		link.pings = info->pings;
+		link.rtt_ms = info->client_rtt_ms;
+		link.jitter_ms = info->client_jitter_ms;
+		link.seconds_since_heartbeat = now - info->last_heartbeat_time;
+		link.max_heartbeat_gap = info->max_heartbeat_gap;
+		links.push_back( link );
 	}
 }
 
+//--------------------------------------------------------------------------
+/**
+* GetOpCoalesceStats
+*/
+op_coalesce_stats_t SpatialOSServer::GetOpCoalesceStats()
+{
+	std::lock_guard<std::mutex> lg( GetInstance()->op_coalesce_stats_lock );
+	return GetInstance()->op_coalesce_stats;
+}
+
 //--------------------------------------------------------------------------
 /**
 * IsRunning
@@ -183,8 +542,9 @@ void SpatialOSServer::Run( const std::vector<std::string> arguments )
 
 	auto print_usage = [&]() {
 		std::cout << "Usage: Managed receptionist <hostname> <port> <worker_id>" << std::endl;
+		std::cout << "       Managed local [<worker_id>]" << std::endl;
 		std::cout << std::endl;
-		std::cout << "Connects to SpatialOS" << std::endl;
+		std::cout << "Connects to SpatialOS, or runs against an in-process LocalWorkerBus" << std::endl;
 		std::cout << "    <hostname>      - hostname of the receptionist or locator to connect to.";
 		std::cout << std::endl;
 		std::cout << "    <port>          - port to use if connecting through the receptionist.";
@@ -193,7 +553,8 @@ void SpatialOSServer::Run( const std::vector<std::string> arguments )
 		std::cout << std::endl;
 	};
 
-	if ( arguments.size() < 3 ) {
+	bool is_local = !arguments.empty() && arguments[0] == "local";
+	if ( !is_local && arguments.size() < 3 ) {
 		print_usage();
 		return;
 	}
@@ -207,14 +568,15 @@ void SpatialOSServer::Run( const std::vector<std::string> arguments )
 
 	// When running as an external worker using 'spatial local worker launch'
 	// The WorkerId isn't passed, so we generate a random one
-	if (arguments.size() >= 4) {
-		workerId = arguments[3];
+	size_t worker_id_arg = is_local ? 1 : 3;
+	if (arguments.size() > worker_id_arg) {
+		workerId = arguments[worker_id_arg];
 	}
 	else {
 		workerId = parameters.WorkerType + "_" + get_random_characters(4);
 	}
 
-	std::cout << "[local] Connecting to SpatialOS as " << workerId << "..." << std::endl;
+	std::cout << "[local] Connecting to " << ( is_local ? "local worker bus" : "SpatialOS" ) << " as " << workerId << "..." << std::endl;
 	std::cout << "Printing: ";
 
 	for (uint argIdx = 0; argIdx < arguments.size(); ++argIdx)
@@ -225,22 +587,32 @@ void SpatialOSServer::Run( const std::vector<std::string> arguments )
 	std::cout << std::endl;
 
 
-	// Connect with receptionist
-	worker::Connection connection = ConnectWithReceptionist(arguments[1], atoi(arguments[2].c_str()), workerId, parameters);
-	GetInstance()->connection = &connection;
-	connection.SendLogMessage(worker::LogLevel::kInfo, kLoggerName, "Connected successfully");
+	// Connect with receptionist, or stand up a local bus with what the snapshot would have had.
+	std::unique_ptr<LocalWorkerBus> local_bus;
+	std::unique_ptr<WorkerConnection> connection;
+	if ( is_local ) {
+		local_bus = std::make_unique<LocalWorkerBus>();
+		SeedLocalBus( *local_bus );
+		connection.reset( local_bus->Connect( parameters.WorkerType, workerId ) );
+		GetInstance()->local_bus = local_bus.get();
+	}
+	else {
+		connection = std::make_unique<SpatialOSConnection>( ConnectWithReceptionist(arguments[1], atoi(arguments[2].c_str()), workerId, parameters) );
+	}
+	GetInstance()->connection = connection.get();
+	connection->SendLogMessage(worker::LogLevel::kInfo, kLoggerName, "Connected successfully");
 
 	std::cout << "connection done" << std::endl;
 
 	// Register callbacks and run the worker main loop.
-	View view( ComponentRegistry{} );
+	View view;
 	GetInstance()->view = &view;
-	bool is_connected = connection.IsConnected();
+	bool is_connected = connection->IsConnected();
 
 	std::cout << "Dispatcher done" << std::endl;
 
-	view.OnDisconnect([&](const worker::DisconnectOp& op) {
-		std::cerr << "[disconnect] " << op.Reason << std::endl;
+	view.OnDisconnect([&](const std::string& reason) {
+		std::cerr << "[disconnect] " << reason << std::endl;
 		is_connected = false;
 		GetInstance()->isRunning = false;
 		});
@@ -249,21 +621,29 @@ void SpatialOSServer::Run( const std::vector<std::string> arguments )
 	RegisterCallbacks( view );
 
 	if (is_connected) {
-		std::cout << "[local] Connected successfully to SpatialOS, listening to ops... " << std::endl;
+		std::cout << "[local] Connected successfully, listening to ops... " << std::endl;
 		GetInstance()->isRunning = true;
 	}
 
-	constexpr unsigned kFramesPerSecond = 60;
-	constexpr std::chrono::duration<double> kFramePeriodSeconds{
-		1. / static_cast<double>(kFramesPerSecond) };
-
+	// Pump ops for the sim thread and send what it queued, independent of the frame rate.
 	std::cout << "Begin running loop" << std::endl;
 	GetInstance()->isRunning = true;
 	while (is_connected && IsRunning())
 	{
-		std::this_thread::sleep_for( kFramePeriodSeconds );
+		GetInstance()->SendOutboundMessages();
+
+		connection->Process( view, kNetworkPumpTimeoutInMilliseconds );
+		GetInstance()->GatherEntityChanges();
+		{
+			std::lock_guard<std::mutex> lg( GetInstance()->op_coalesce_stats_lock );
+			GetInstance()->op_coalesce_stats = connection->GetOpCoalesceStats();
+		}
+
+		RetryBacklog( GetInstance()->inbound_changes, GetInstance()->inbound_backlog );
 	}
 
+	// Whatever the last frame queued still goes out.
+	GetInstance()->SendOutboundMessages();
 	
 	std::cout << "Finish Running" << std::endl;
 
@@ -271,401 +651,945 @@ void SpatialOSServer::Run( const std::vector<std::string> arguments )
 	GetInstance()->isRunning = false;
 	GetInstance()->connection = nullptr;
 	GetInstance()->view = nullptr;
+	GetInstance()->local_bus = nullptr;
+
+	// Connection goes before the bus it's on.
+	connection.reset();
+	local_bus.reset();
 }
 
 //--------------------------------------------------------------------------
 /**
-* RegisterCallbacks
+* SeedLocalBus
+* The API entity clients send ServerAPI commands to, normally loaded from the snapshot.
 */
-void SpatialOSServer::RegisterCallbacks( worker::Dispatcher& dispatcher )
+void SpatialOSServer::SeedLocalBus( LocalWorkerBus& bus )
 {
-	// Print log messages received from SpatialOS
-	dispatcher.OnLogMessage([&](const worker::LogMessageOp& op) {
-		if (op.Level == worker::LogLevel::kFatal) {
-			std::cerr << "Fatal error: " << op.Message << std::endl;
-			std::terminate();
-		}
-		std::cout << "[remote] " << op.Message << std::endl;
-		});
- 
-	// When the reservation succeeds, create an entity with the reserved ID.
-	dispatcher.OnReserveEntityIdsResponse( ReserveEntityIdsResponse );
-
-	// When the creation succeeds, delete the entity.
-	dispatcher.OnCreateEntityResponse( CreateEntityResponse );
-
-	// When the deletion succeeds, we're done.
-	dispatcher.OnDeleteEntityResponse( DeleteEntityResponse );
+	worker::List<std::string> simulationWorkerAttributeSet{ "simulation" };
+	worker::List<std::string> clientWorkerAttributeSet{ "client" };
+	improbable::WorkerRequirementSet simulationWorkerRequirementSet{ worker::List<improbable::WorkerAttributeSet>{ {simulationWorkerAttributeSet} } };
+	improbable::WorkerRequirementSet clientOrSimRequirementSet{ worker::List<improbable::WorkerAttributeSet>{ simulationWorkerAttributeSet, clientWorkerAttributeSet } };
+
+	worker::Map<worker::ComponentId, improbable::WorkerRequirementSet> componentAcl;
+	componentAcl[improbable::Position::ComponentId] = simulationWorkerRequirementSet;
+	componentAcl[improbable::EntityAcl::ComponentId] = simulationWorkerRequirementSet;
+	componentAcl[improbable::Metadata::ComponentId] = simulationWorkerRequirementSet;
+	componentAcl[siren::ServerAPI::ComponentId] = simulationWorkerRequirementSet;
+
+	worker::Entity api_entity;
+	api_entity.Add<improbable::Position>( { { 0.0, 0.0, 0.0 } } );
+	api_entity.Add<improbable::EntityAcl>( improbable::EntityAcl::Data{ clientOrSimRequirementSet, componentAcl } );
+	improbable::Metadata::Data metadata;
+	metadata.set_entity_type( "API" );
+	api_entity.Add<improbable::Metadata>( metadata );
+	api_entity.Add<improbable::Persistence>( {} );
+	api_entity.Add<siren::ServerAPI>( {} );
+	bus.AddEntity( 1, api_entity );
+}
 
-	// For requesting an entity to be created, used for client to enter.
-	dispatcher.OnCommandRequest<CreateClientEntity>( PlayerCreation );
-	dispatcher.OnCommandRequest<DeleteClientEntity>( PlayerDeletion );
+//--------------------------------------------------------------------------
+/**
+* GetLocalBus
+*/
+LocalWorkerBus* SpatialOSServer::GetLocalBus()
+{
+	return GetInstance()->local_bus;
 }
 
 //--------------------------------------------------------------------------
 /**
-* Update
+* SaveWorldCheckpoint
 */
-void SpatialOSServer::Update()
+bool SpatialOSServer::SaveWorldCheckpoint( const std::string& path )
 {
-	for( auto& ent_pair : view->m_entities )
+	SpatialOSServer* server = GetInstance();
+	std::vector<world_checkpoint_source_t> sources;
 	{
-		View::entity_tracker_t& tracker = ent_pair.second;
-		if (!tracker.updated)
-		{
-			// Entity wasn't updated so there's nothing to tell the client
-			continue;
-		}
-
-		entity_info_t* info = GetInfoWithEnityId(ent_pair.first);
-		if (info)
-		{
-			if (info->game_entity && info->created)
-			{
-				UpdateEntityWithWorkerEntity(*(info->game_entity), tracker.worker_entity, view->m_component_authority[ent_pair.first]);
-			}
-			else
-			{
-				if (info->created)
-				{
-					std::cout << "Waiting: SpatialOSServer::Update - info found but not created yet| entity ID:" << ent_pair.first << std::endl;
-				}
-				else
-				{
-					// should never get here.
-					std::cout << "ERROR: SpatialOSServer::Update - info and worker entity found but no game entity to update| entity ID:" << ent_pair.first << std::endl;
-				}
-			}
-		}
-		else
+		std::lock_guard<std::mutex> lg( server->entity_info_list_lock );
+		sources.reserve( server->entity_info_list.GetCount() );
+		for( entity_info_t* info : server->entity_info_list.GetAll() )
 		{
-			// Game doesn't know about the instance from the server yet.
-
-			//	Working on getting an entity into the game from the server
-			std::cout << "SpatialOSServer::Update can't find info for id: " << ent_pair.first << std::endl;
-			std::cout << "	Thread: " << std::this_thread::get_id() << std::endl;
-			worker::Option<improbable::MetadataData&> data = tracker.worker_entity.Get<improbable::Metadata>();
-			if (data)
+			if( info->created && info->id != 0 && info->game_entity && info->game_entity->IsAlive() )
 			{
-				std::string name = data->entity_type();
-				std::cout << "	SpatialOSServer::Update Making from data: " << name.c_str() << std::endl;
-				entity_info_t new_info;
-				new_info.game_entity = g_theSim->CreateSimulatedEntity(name);
-				if (new_info.game_entity)
-				{
-					InitEntityWithWorkerEntity(*(new_info.game_entity), tracker.worker_entity );
-					new_info.id = ent_pair.first;
-					new_info.created = true;
-					GetInstance()->entity_info_list.push_back( new_info );
-					std::cout << "	SpatialOSServer::Update Success in creation of entity| ID: " << ent_pair.first << std::endl;
-				}
+				sources.push_back( { info->id, info->game_entity, info->owner_id } );
 			}
 		}
-		tracker.updated = false;
 	}
 
-	// Check for deleted entities
-	for ( uint idx = 0; idx < entity_info_list.size(); )
+	// Same world, same file.
+	std::sort( sources.begin(), sources.end(), []( const world_checkpoint_source_t& lhs, const world_checkpoint_source_t& rhs ) { return lhs.id < rhs.id; } );
+	if( !WorldCheckpoint::Write( path, sources ) )
 	{
-		entity_info_t& info = entity_info_list[idx];
-		// See if we can no longer see an entity that has been created
-		auto itr = view->m_entities.find(info.id);
-		bool entity_in_view_list = itr != view->m_entities.end();
-
-		if( entity_in_view_list )
-		{
-			if( itr->second.garbage )
-			{
-				// Tell the entity to die and then erase knowledge of entity
-				std::cout << "Killing entity with ID: " << info.id << std::endl;
-				info.game_entity->Die();
-				entity_info_list.erase( entity_info_list.begin() + idx );
-				continue;
-			}
-		}
-		++idx;
+		return false;
 	}
-
-	view->CleanupGarbage();
+	LOG_INFO( "Checkpoint", "Saved %zu entities to %s", sources.size(), path.c_str() );
+	return true;
 }
 
 //--------------------------------------------------------------------------
 /**
-* UpdateEntityWithWorkerEntity
+* LoadWorldCheckpoint
 */
-void SpatialOSServer::UpdateEntityWithWorkerEntity( EntityBase& entity, worker::Entity& worker_entity, worker::Map<worker::ComponentId, worker::Authority>& entity_auth )
+uint32_t SpatialOSServer::LoadWorldCheckpoint( const std::string& path )
 {
-	worker::Option<improbable::PositionData&> pos = worker_entity.Get<improbable::Position>();
-	
-	if ( pos )
+	WorldCheckpoint checkpoint;
+	if( !checkpoint.Open( path ) )
 	{
-		// Only update the position if I don't have authority over it's position.
-		const auto& pos_auth_itr = entity_auth.find( improbable::Position::ComponentId );
-		worker::Authority& pos_auth = pos_auth_itr->second;
-		if( pos_auth == worker::Authority::kNotAuthoritative )
-		{
-			entity.SetPosition((float)pos->coords().x(), (float)pos->coords().z());
-		}
+		return 0;
+	}
+
+	// Names are only looked up once per type.
+	std::vector<EntityTypeId> type_ids( checkpoint.GetTypeCount() );
+	for( uint32_t idx = 0; idx < checkpoint.GetTypeCount(); ++idx )
+	{
+		const char* name = checkpoint.GetTypes()[idx].name;
+		type_ids[idx] = EntityTypeRegistry::Find( std::string( name, strnlen( name, WORLD_CHECKPOINT_TYPE_NAME_SIZE ) ) );
 	}
-	worker::Option<siren::PlayerControlsData&> input_from_player = worker_entity.Get<siren::PlayerControls>();
-	if( input_from_player )
+
+	SpatialOSServer* server = GetInstance();
+	double now = GetCurrentTimeSeconds();
+	uint32_t loaded = 0;
+
+	std::lock_guard<std::mutex> lg( server->entity_info_list_lock );
+	server->entity_info_list.Clear();
+	const world_checkpoint_entity_t* records = checkpoint.GetEntities();
+	for( uint32_t idx = 0; idx < checkpoint.GetEntityCount(); ++idx )
 	{
-		// If I have authority over the position of the entity, update it's movement.
-		const auto& pos_auth_itr = entity_auth.find(improbable::Position::ComponentId);
-		worker::Authority& pos_auth = pos_auth_itr->second;
-		if (pos_auth == worker::Authority::kAuthoritative || pos_auth == worker::Authority::kAuthorityLossImminent )
+		const world_checkpoint_entity_t& record = records[idx];
+		EntityTypeId type_id = record.type < type_ids.size() ? type_ids[record.type] : INVALID_ENTITY_TYPE_ID;
+		EntityBase* entity = type_id != INVALID_ENTITY_TYPE_ID ? g_theSim->CreateSimulatedEntity( type_id, (ControllerKind)record.controller ) : nullptr;
+		if( !entity )
 		{
-			( (SimController*)( (ActorBase*) &entity )->GetController() )->SetMoveDirection( 
-					Vec2( input_from_player->x_move(), input_from_player->y_move() )
-				);
+			continue;
 		}
+
+		Vec2 position( record.position[0], record.position[1] );
+		entity->SetPosition( position );
+		entity->SetVelocity( Vec2( record.velocity[0], record.velocity[1] ) );
+
+		entity_info_t info;
+		info.game_entity = entity;
+		info.id = record.id;
+		info.created = true;
+
+		// So the owning client's pings are accepted again, and it gets the idle timeout to come back.
+		info.owner_id = checkpoint.GetOwner( record );
+		info.last_heartbeat_time = now;
+
+		// SpatialOS still has the position it was checkpointed at.
+		info.last_sent_position = position;
+		info.last_sent_time = server->tick_time;
+		info.has_sent_position = true;
+		info.last_sent_coordinates = position;
+		info.last_coordinates_time = server->tick_time;
+		info.has_sent_coordinates = true;
+		server->entity_info_list.Add( info );
+		++loaded;
 	}
+
+	LOG_INFO( "Checkpoint", "Loaded %u of %u entities from %s", loaded, checkpoint.GetEntityCount(), path.c_str() );
+	return loaded;
 }
 
 //--------------------------------------------------------------------------
 /**
-* InitEntityWithWorkerEntity
+* GetCreatedEntityCount
 */
-void SpatialOSServer::InitEntityWithWorkerEntity( EntityBase& entity, worker::Entity& worker_entity )
+uint32_t SpatialOSServer::GetCreatedEntityCount()
 {
-	worker::Option<improbable::PositionData&> pos = worker_entity.Get<improbable::Position>();
-
-	if (pos)
+	std::lock_guard<std::mutex> lg( GetInstance()->entity_info_list_lock );
+	uint32_t count = 0;
+	for( entity_info_t* info : GetInstance()->entity_info_list.GetAll() )
 	{
-		entity.SetPosition((float)pos->coords().x(), (float)pos->coords().z());
-	}
-	worker::Option<siren::PlayerControlsData&> input_from_player = worker_entity.Get<siren::PlayerControls>();
-	if (input_from_player)
-	{
-		((SimController*)((ActorBase*)&entity)->GetController())->SetMoveDirection(
-			Vec2(input_from_player->x_move(), input_from_player->y_move())
-		);
+		count += info->created ? 1 : 0;
 	}
+	return count;
 }
 
 //--------------------------------------------------------------------------
 /**
-* DeleteEntityResponse
+* RegisterCallbacks
 */
-uint64_t SpatialOSServer::DeleteEntityResponse( const worker::DeleteEntityResponseOp& op )
+void SpatialOSServer::RegisterCallbacks( WorkerDispatcher& dispatcher )
 {
-	entity_info_t* entity_info;
-	if ( ( entity_info = GetInfoWithDeleteEnityRequest( op.RequestId.Id ) ) != nullptr  &&
-		op.StatusCode == worker::StatusCode::kSuccess ) 
-	{
-		entity_info->created = false;
-		entity_info->game_entity->Die();
+	// Print log messages received from SpatialOS
+	dispatcher.OnLogMessage([&](worker::LogLevel level, const std::string& message) {
+		if (level == worker::LogLevel::kFatal) {
+			std::cerr << "Fatal error: " << message << std::endl;
+			std::terminate();
+		}
+		LOG_INFO( "Remote", "%s", message.c_str() );
+		});
+ 
+	// Everything below touches game state, so it's only decoded here and applied on the sim thread.
+
+	// When the reservation succeeds, create an entity with the reserved ID.
+	dispatcher.OnReserveEntityIdsResponse([](const reserve_entity_ids_response_t& op) {
+		bool success = op.status_code == worker::StatusCode::kSuccess;
+		LOG_DEBUG( "Server", "ReserveEntityIds response %llu: %s", (unsigned long long)op.request_id, op.message.c_str() );
+		GetInstance()->connection->SendLogMessage(worker::LogLevel::kInfo, kLoggerName, Stringf("Connected %s", success ? "successfully" : "with fault" ) );
+
+		inbound_change_t change;
+		change.type = INBOUND_RESERVE_RESPONSE;
+		change.request_id = op.request_id;
+		change.success = success;
+		change.id = success ? *op.first_entity_id : 0; // Optional but can assume there is an id because the status was successful.
+		GetInstance()->PushInbound( std::move( change ) );
+		});
+
+	// When the creation succeeds, track the entity.
+	dispatcher.OnCreateEntityResponse([](const create_entity_response_t& op) {
+		inbound_change_t change;
+		change.type = INBOUND_CREATE_RESPONSE;
+		change.request_id = op.request_id;
+		change.success = op.status_code == worker::StatusCode::kSuccess;
+		change.id = change.success ? *op.entity_id : 0;
+		GetInstance()->PushInbound( std::move( change ) );
+		});
+
+	// When the deletion succeeds, we're done.
+	dispatcher.OnDeleteEntityResponse([](const delete_entity_response_t& op) {
+		inbound_change_t change;
+		change.type = INBOUND_DELETE_RESPONSE;
+		change.request_id = op.request_id;
+		change.success = op.status_code == worker::StatusCode::kSuccess;
+		GetInstance()->PushInbound( std::move( change ) );
+		});
+
+	// For requesting an entity to be created, used for client to enter.
+	dispatcher.OnCreateClientEntityRequest([](const command_request_t<CreateClientEntity>& op) {
+		inbound_change_t change;
+		change.type = INBOUND_PLAYER_CREATION;
+		change.request_id = op.request_id;
+		change.id = op.request.id_to_create();
+		change.caller_worker_id = op.caller_worker_id;
+		GetInstance()->PushInbound( std::move( change ) );
+		});
+	dispatcher.OnDeleteClientEntityRequest([](const command_request_t<DeleteClientEntity>& op) {
+		inbound_change_t change;
+		change.type = INBOUND_PLAYER_DELETION;
+		change.id = op.request.id_to_delete();
+		GetInstance()->PushInbound( std::move( change ) );
+		});
+
+	// Answered straight away so the client's RTT is the network's, the sim thread records the heartbeat.
+	dispatcher.OnClientPingRequest([](const command_request_t<ClientPing>& op) {
+		int64_t heartbeat = std::chrono::duration_cast<std::chrono::milliseconds>( std::chrono::system_clock::now().time_since_epoch() ).count();
+		ClientPing::Response response;
+		response.set_server_heartbeat( heartbeat );
+		GetInstance()->connection->SendCommandResponse( op.request_id, response );
+
+		inbound_change_t change;
+		change.type = INBOUND_CLIENT_PING;
+		change.id = op.request.client_entity_id();
+		change.caller_worker_id = op.caller_worker_id;
+		change.heartbeat = heartbeat;
+		change.rtt_ms = op.request.rtt_ms();
+		change.jitter_ms = op.request.jitter_ms();
+		GetInstance()->PushInbound( std::move( change ) );
+		});
+}
+
+//--------------------------------------------------------------------------
+/**
+* GatherEntityChanges
+* Network thread. Decodes every entity the View touched into an inbound change.
+*/
+void SpatialOSServer::GatherEntityChanges()
+{
+	// Removals first, an entity checked out again this frame is then recreated by its change.
+	for( worker::EntityId id : view->GetGarbageEntities() )
+	{
+		inbound_change_t change;
+		change.type = INBOUND_ENTITY_REMOVED;
+		change.id = id;
+		PushInbound( std::move( change ) );
+	}
+
+	for( worker::EntityId id : view->GetDirtyEntities() )
+	{
+		uint32_t slot = view->FindLiveSlot( id );
+		if( slot == ViewComponentStore::INVALID_SLOT || view->GetEntityState( slot ).changed == 0 )
+		{
+			// Removed after it changed, or already listed earlier this frame.
+			continue;
+		}
+		const ViewComponentStore& components = view->m_components;
+
+		inbound_change_t change;
+		change.type = INBOUND_ENTITY_CHANGED;
+		change.id = id;
+
+		const improbable::PositionData* pos = components.Get<improbable::Position>( slot );
+		if( pos )
+		{
+			change.has_position = true;
+			change.position = Vec2( (float)pos->coords().x(), (float)pos->coords().z() );
+		}
+		change.position_authority = components.GetAuthority<improbable::Position>( slot );
+
+		const siren::PlayerControlsData* input_from_player = components.Get<siren::PlayerControls>( slot );
+		if( input_from_player )
+		{
+			change.has_controls = true;
+			change.move_direction = Vec2( input_from_player->x_move(), input_from_player->y_move() );
+			change.input_sequence = input_from_player->sequence();
+		}
+
+		const improbable::MetadataData* data = components.Get<improbable::Metadata>( slot );
+		if( data )
+		{
+			change.entity_type = data->entity_type();
+		}
+
+		PushInbound( std::move( change ) );
+		view->GetEntityState( slot ).changed = 0;
 	}
-	return op.RequestId.Id;
+
+	view->CleanupGarbage();
 }
 
 //--------------------------------------------------------------------------
 /**
-* CreateEntityResponse
+* SendOutboundMessages
+* Network thread. Sends everything the sim thread queued so far.
 */
-uint64_t SpatialOSServer::CreateEntityResponse( const worker::CreateEntityResponseOp& op )
+void SpatialOSServer::SendOutboundMessages()
 {
-	entity_info_t* entity_info;
-	std::cout << "SpatialOSServer::CreateEntityResponse" << std::endl;
-	entity_info = GetInfoWithCreateEnityRequest( op.RequestId.Id );
-	bool success = op.StatusCode == worker::StatusCode::kSuccess;
+	outbound_message_t message;
+	while( outbound_messages.TryPop( message ) )
+	{
+		SendOutboundMessage( message );
+	}
+}
 
-	if ( entity_info && success ) 
+//--------------------------------------------------------------------------
+/**
+* SendOutboundMessage
+* Requests that need their id on the sim thread echo it back ahead of any response.
+*/
+void SpatialOSServer::SendOutboundMessage( outbound_message_t& message )
+{
+	switch( message.type )
 	{
-		if( entity_info->id != 0 )
+	case OUTBOUND_RESERVE_ENTITY_ID:
+	{
+		inbound_change_t change;
+		change.type = INBOUND_RESERVE_SENT;
+		change.count = message.count;
+		change.request_id = connection->SendReserveEntityIdsRequest( message.count );
+		LOG_DEBUG( "Server", "ReserveEntityIds request %llu sent for %u ids", (unsigned long long)change.request_id, message.count );
+		PushInbound( std::move( change ) );
+		break;
+	}
+	case OUTBOUND_CREATE_ENTITY:
+	{
+		auto result = connection->SendCreateEntityRequest( message.worker_entity, message.id );
+		// Check no errors occurred, the connection already logged why.
+		if( !result )
+		{
+			std::terminate();
+		}
+		inbound_change_t change;
+		change.type = INBOUND_CREATE_SENT;
+		change.id = message.id;
+		change.request_id = *result;
+		PushInbound( std::move( change ) );
+		break;
+	}
+	case OUTBOUND_DELETE_ENTITY:
+	{
+		inbound_change_t change;
+		change.type = INBOUND_DELETE_SENT;
+		change.id = message.id;
+		change.request_id = connection->SendDeleteEntityRequest( message.id );
+		PushInbound( std::move( change ) );
+		break;
+	}
+	case OUTBOUND_CREATE_CLIENT_ENTITY_RESPONSE:
+	{
+		LOG_DEBUG( "Server", "CreateClientEntity response to request %llu", (unsigned long long)message.request_id );
+		CreateClientEntity::Response response;
+		response.set_id_created( message.id );
+		connection->SendCommandResponse( message.request_id, response );
+		break;
+	}
+	case OUTBOUND_CLIENT_HEARTBEAT:
+	{
+		siren::ClientHeartbeat::Update update;
+		update.set_last_server_heartbeat( message.heartbeat );
+		connection->SendComponentUpdate( message.id, update );
+		break;
+	}
+	case OUTBOUND_POSITION_UPDATES:
+	{
+		for( const pending_position_t& pending : message.positions )
 		{
-			if( entity_info->id != *(op.EntityId) )
+			if( pending.send_plane_position )
 			{
-				std::cout << "	ID: " << entity_info->id << " assigned to entity was not the ID: " << *(op.EntityId) <<" returned in the callback." << std::endl;
+				connection->SendComponentUpdate( pending.id, pending.plane_position );
+			}
+			if( pending.send_coordinates )
+			{
+				connection->SendComponentUpdate( pending.id, MakeCoordinatesUpdate( pending.position ) );
 			}
 		}
-		entity_info->id = *(op.EntityId); 
-		entity_info->created = true;
-		std::cout << "	Entity creation successful with id " << entity_info->id << std::endl;
+		for( const pending_movement_t& pending : message.movements )
+		{
+			siren::PlayerMovement::Update movement_update;
+			movement_update.set_input_sequence( pending.input_sequence );
+			movement_update.set_position( siren::Vector2( pending.position.x, pending.position.y ) );
+			movement_update.set_velocity( siren::Vector2( pending.velocity.x, pending.velocity.y ) );
+			connection->SendComponentUpdate( pending.id, movement_update );
+		}
+		break;
+	}
 	}
-	return op.RequestId.Id;
 }
 
 //--------------------------------------------------------------------------
 /**
-* ReserveEntityIdsResponse
+* PushInbound
+* Network thread.
 */
-uint64_t SpatialOSServer::ReserveEntityIdsResponse( const worker::ReserveEntityIdsResponseOp& op )
+void SpatialOSServer::PushInbound( inbound_change_t&& change )
 {
-	entity_info_t* entity_info;
-	std::cout << "ReserveEntity begin with response ID: " << op.RequestId.Id << std::endl;
-	std::cout << "    Additionally: " << op.Message << " with id: " << op.RequestId.Id << std::endl;
+	PushInOrder( inbound_changes, inbound_backlog, std::move( change ) );
+}
 
-	GetInstance()->connection->SendLogMessage(worker::LogLevel::kInfo, kLoggerName, Stringf("Connected %s", op.StatusCode == worker::StatusCode::kSuccess ? "successfully" : "with fault" ) );
-	
-	if ( ( entity_info = GetInfoWithReserveEnityIdsRequest( op.RequestId.Id ) ) != nullptr &&
-		op.StatusCode == worker::StatusCode::kSuccess ) 
-	{
-		// Send response back to however sent the command if triggered by a command.
-		if( entity_info->command_response_id != (uint64_t)-1 )
-		{
-			std::cout << "		Sending back response with ID: " << entity_info->command_response_id << std::endl;
-			worker::RequestId<worker::IncomingCommandRequest< CreateClientEntity > > command_response;
-			CreateClientEntity::Response response;
-			worker::EntityId id = *(op.FirstEntityId); // Optional but can assume there is an id because the status was successful.
-			response.set_id_created( id );
-			command_response.Id = entity_info->command_response_id;
-			GetInstance()->connection->SendCommandResponse<CreateClientEntity>( command_response, response );
-		}
-
-		worker::Entity clientEntity;
-
-		Vec2 position = entity_info->game_entity->GetPosition();
-		clientEntity.Add<improbable::Position>({ { position.x,  0.0f, position.y } });
-
-
-		worker::List<std::string> callerWorkerAttributeSet{ "workerId:" + entity_info->owner_id };
-		worker::List<std::string> simulationWorkerAttributeSet{ "simulation" };
-		worker::List<std::string> clientWorkerAttributeSet{ "client" };
-
-		improbable::WorkerRequirementSet clientWorkerRequirementSet{ worker::List<improbable::WorkerAttributeSet>{ {clientWorkerAttributeSet} } };
-		improbable::WorkerRequirementSet simulationWorkerRequirementSet{ worker::List<improbable::WorkerAttributeSet>{ {simulationWorkerAttributeSet} } };
-		improbable::WorkerRequirementSet callerWorkerRequirementSet{ worker::List<improbable::WorkerAttributeSet>{ {callerWorkerAttributeSet} } };
-		improbable::WorkerRequirementSet clientOrSimRequirementSet
-		{
-			worker::List<improbable::WorkerAttributeSet>
-		{
-			simulationWorkerAttributeSet,
-				clientWorkerAttributeSet,
-				callerWorkerAttributeSet
-		}
-		};
-
-		worker::Map<worker::ComponentId, improbable::WorkerRequirementSet> componentAcl;
-		componentAcl[improbable::Position::ComponentId] = simulationWorkerRequirementSet;
-		componentAcl[improbable::EntityAcl::ComponentId] = simulationWorkerRequirementSet;
-		componentAcl[improbable::Metadata::ComponentId] = simulationWorkerRequirementSet;
-		componentAcl[siren::PlayerControls::ComponentId] = callerWorkerRequirementSet;
-
-		clientEntity.Add<improbable::EntityAcl>(
-			improbable::EntityAcl::Data{/* read */ clientOrSimRequirementSet, /* write */ componentAcl });
-
-		improbable::Metadata::Data metadata;
-		metadata.set_entity_type( entity_info->game_entity->GetName() );
-		clientEntity.Add<improbable::Metadata>(metadata);
-
-		siren::PlayerControls::Data client_data;
-		clientEntity.Add<siren::PlayerControls>(client_data);
-
-		improbable::ComponentInterest::QueryConstraint relativeConstraint;
-		relativeConstraint.set_relative_box_constraint({ {{20.5, 9999, 20.5}} });
-		improbable::ComponentInterest::Query relativeQuery;
-		relativeQuery.set_constraint(relativeConstraint);
-		relativeQuery.set_full_snapshot_result({ true });
-		improbable::ComponentInterest interest{ {relativeQuery} };
-		clientEntity.Add<improbable::Interest>({ {{siren::Client::ComponentId, interest}} });
-		
-		entity_info->id = *op.FirstEntityId;
-		auto result = GetInstance()->connection->SendCreateEntityRequest( clientEntity, op.FirstEntityId, kGetOpListTimeoutInMilliseconds );
-		// Check no errors occurred.
-		if (result) {
-			entity_info->entity_creation_request_id = (*result).Id;
-			std::cout << "		Creating entity with id: " << entity_info->id << " with requestID: " << entity_info->entity_creation_request_id << std::endl;
-			std::cout << "		ReserveEntity Success with id: " << entity_info->entity_creation_request_id << std::endl;
-		}
-		else {
-			GetInstance()->connection->SendLogMessage(worker::LogLevel::kError, "ReserveEntityIdsResponse Error",
-				result.GetErrorMessage());
-			std::terminate();
+//--------------------------------------------------------------------------
+/**
+* PushOutbound
+* Sim thread, never blocks the frame.
+*/
+void SpatialOSServer::PushOutbound( outbound_message_t&& message )
+{
+	PushInOrder( outbound_messages, outbound_backlog, std::move( message ) );
+}
+
+//--------------------------------------------------------------------------
+/**
+* ApplyChange
+* Sim thread.
+*/
+void SpatialOSServer::ApplyChange( const inbound_change_t& change )
+{
+	switch( change.type )
+	{
+	case INBOUND_ENTITY_CHANGED:
+		ApplyEntityChange( change );
+		break;
+	case INBOUND_ENTITY_REMOVED:
+		ApplyEntityRemoval( change );
+		break;
+	case INBOUND_RESERVE_SENT:
+		entity_id_pool.OnRequestSent( change.request_id, change.count );
+		pending_requests.Add( change.request_id, REQUEST_STAGE_RESERVE, 0, GetCurrentTimeSeconds() );
+		break;
+	case INBOUND_CREATE_SENT:
+	{
+		std::lock_guard<std::mutex> lg( entity_info_list_lock );
+		entity_info_t* info = entity_info_list.FindWithEntityId( change.id );
+		if( info )
+		{
+			entity_info_list.SetCreationRequestId( info, change.request_id );
+			LOG_DEBUG( "Server", "Creating entity %lld with request %llu", (long long)info->id, (unsigned long long)info->entity_creation_request_id );
 		}
+		pending_requests.Add( change.request_id, REQUEST_STAGE_CREATE, change.id, GetCurrentTimeSeconds() );
+		break;
+	}
+	case INBOUND_DELETE_SENT:
+	{
+		std::lock_guard<std::mutex> lg( entity_info_list_lock );
+		entity_info_t* info = entity_info_list.FindWithEntityId( change.id );
+		if( info )
+		{
+			entity_info_list.SetDeletionRequestId( info, change.request_id );
+		}
+		pending_requests.Add( change.request_id, REQUEST_STAGE_DELETE, change.id, GetCurrentTimeSeconds() );
+		break;
+	}
+	case INBOUND_RESERVE_RESPONSE:
+		ReserveEntityIdsResponse( change );
+		break;
+	case INBOUND_CREATE_RESPONSE:
+		CreateEntityResponse( change );
+		break;
+	case INBOUND_DELETE_RESPONSE:
+		DeleteEntityResponse( change );
+		break;
+	case INBOUND_PLAYER_CREATION:
+		PlayerCreation( change );
+		break;
+	case INBOUND_PLAYER_DELETION:
+		PlayerDeletion( change );
+		break;
+	case INBOUND_CLIENT_PING:
+		ClientPingReceived( change );
+		break;
 	}
-	return op.RequestId.Id;
 }
 
 //--------------------------------------------------------------------------
 /**
-* GetInfoFromCreateEnityRequest
+* ApplyEntityChange
 */
-entity_info_t* SpatialOSServer::GetInfoWithCreateEnityRequest( uint64_t entity_creation_request_id )
+void SpatialOSServer::ApplyEntityChange( const inbound_change_t& change )
 {
-	std::lock_guard<std::mutex> lg(  GetInstance()->entity_info_list_lock );
-	for( entity_info_t& entity : GetInstance()->entity_info_list )
+	entity_info_t* info = GetInfoWithEnityId( change.id );
+	if (info)
 	{
-		std::cout << "GetInfoFromCreateEnityRequest: " << entity.entity_creation_request_id << " with " << entity_creation_request_id << std::endl;
-
-		if( entity.entity_creation_request_id == entity_creation_request_id )
+		if (info->game_entity && info->created)
 		{
-			return &entity;
+			UpdateEntityWithChange( *(info->game_entity), change );
+			if( change.has_controls )
+			{
+				info->input_sequence = change.input_sequence;
+				info->has_input = true;
+			}
+		}
+		else
+		{
+			if (info->created)
+			{
+				LOG_DEBUG( "Server", "Entity %lld changed before it was created", (long long)change.id );
+			}
+			else
+			{
+				// should never get here.
+				LOG_ERROR( "Server", "Entity %lld has info but no game entity to update", (long long)change.id );
+			}
 		}
 	}
+	else
+	{
+		// Game doesn't know about the instance from the server yet.
 
-	return nullptr;
+		//	Working on getting an entity into the game from the server
+		if (!change.entity_type.empty())
+		{
+			LOG_DEBUG( "Server", "Making a %s for entity %lld", change.entity_type.c_str(), (long long)change.id );
+			entity_info_t new_info;
+			new_info.game_entity = g_theSim->CreateSimulatedEntity(change.entity_type);
+			if (new_info.game_entity)
+			{
+				InitEntityWithChange(*(new_info.game_entity), change );
+				new_info.id = change.id;
+				new_info.created = true;
+				std::lock_guard<std::mutex> lg( entity_info_list_lock );
+				entity_info_list.Add( new_info );
+			}
+		}
+	}
 }
 
 //--------------------------------------------------------------------------
 /**
-* GetInfoFromDeleteEnityRequest
+* ApplyEntityRemoval
 */
-entity_info_t* SpatialOSServer::GetInfoWithDeleteEnityRequest( uint64_t entity_deletion_request_id )
+void SpatialOSServer::ApplyEntityRemoval( const inbound_change_t& change )
 {
-	std::lock_guard<std::mutex> lg(GetInstance()->entity_info_list_lock);
-	for (entity_info_t& entity : GetInstance()->entity_info_list)
+	// We can no longer see an entity that has been created
+	entity_info_t* info = GetInfoWithEnityId( change.id );
+	if( info )
 	{
-		if  ( entity.entity_deletion_request_id == entity_deletion_request_id )
+		// Tell the entity to die and then erase knowledge of entity
+		LOG_DEBUG( "Server", "Killing entity %lld", (long long)info->id );
+		if( info->game_entity )
 		{
-			return &entity;
+			info->game_entity->Die();
 		}
+		std::lock_guard<std::mutex> lg( entity_info_list_lock );
+		entity_info_list.Remove( info );
 	}
+}
 
-	return nullptr;
+//--------------------------------------------------------------------------
+/**
+* UpdateEntityWithChange
+*/
+void SpatialOSServer::UpdateEntityWithChange( EntityBase& entity, const inbound_change_t& change )
+{
+	// Only update the position if I don't have authority over it's position.
+	if ( change.has_position && change.position_authority == worker::Authority::kNotAuthoritative )
+	{
+		entity.SetPosition( change.position );
+	}
+
+	// If I have authority over the position of the entity, update it's movement.
+	if( change.has_controls &&
+		( change.position_authority == worker::Authority::kAuthoritative || change.position_authority == worker::Authority::kAuthorityLossImminent ) )
+	{
+		( (SimController*)( (ActorBase*) &entity )->GetController() )->SetMoveDirection( change.move_direction );
+	}
 }
 
 //--------------------------------------------------------------------------
 /**
-* GetInfoFromReserveEnityIdsRequest
+* InitEntityWithChange
 */
-entity_info_t* SpatialOSServer::GetInfoWithReserveEnityIdsRequest( uint64_t entity_id_reservation_request_id )
+void SpatialOSServer::InitEntityWithChange( EntityBase& entity, const inbound_change_t& change )
 {
-	std::lock_guard<std::mutex> lg(GetInstance()->entity_info_list_lock);
-	for (entity_info_t& entity : GetInstance()->entity_info_list)
+	if (change.has_position)
+	{
+		entity.SetPosition( change.position );
+	}
+	if (change.has_controls)
+	{
+		((SimController*)((ActorBase*)&entity)->GetController())->SetMoveDirection( change.move_direction );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DeleteEntityResponse
+*/
+void SpatialOSServer::DeleteEntityResponse( const inbound_change_t& change )
+{
+	pending_request_t request;
+	if( !GetInstance()->pending_requests.Complete( change.request_id, change.success, GetCurrentTimeSeconds(), request ) )
+	{
+		// Already given up on.
+		return;
+	}
+
+	entity_info_t* entity_info;
+	if ( ( entity_info = GetInfoWithDeleteEnityRequest( change.request_id ) ) != nullptr  &&
+		change.success )
 	{
-		if ( entity.entity_id_reservation_request_id == entity_id_reservation_request_id )
+		entity_info->created = false;
+		if( entity_info->game_entity )
 		{
-			return &entity;
+			entity_info->game_entity->Die();
 		}
 	}
-	return nullptr;
+	else if( entity_info )
+	{
+		LOG_WARNING( "Server", "DeleteEntity request for %lld failed", (long long)entity_info->id );
+		std::lock_guard<std::mutex> lg( GetInstance()->entity_info_list_lock );
+		GetInstance()->entity_info_list.SetDeletionRequestId( entity_info, 0 );
+	}
 }
 
 //--------------------------------------------------------------------------
 /**
-* GetInfoFromEnityId
+* CreateEntityResponse
 */
-entity_info_t* SpatialOSServer::GetInfoWithEnityId(const worker::EntityId& entity_id )
+void SpatialOSServer::CreateEntityResponse( const inbound_change_t& change )
 {
-	std::lock_guard<std::mutex> lg(GetInstance()->entity_info_list_lock);
-	for (entity_info_t& entity : GetInstance()->entity_info_list)
+	SpatialOSServer* server = GetInstance();
+	pending_request_t request;
+	entity_info_t* entity_info = nullptr;
+	if( server->pending_requests.Complete( change.request_id, change.success, GetCurrentTimeSeconds(), request ) )
+	{
+		entity_info = GetInfoWithCreateEnityRequest( change.request_id );
+	}
+	else
 	{
-		if ( entity.id == entity_id )
+		// Given up on and sent again, but the runtime still went ahead with it.
+		auto expired = server->expired_creation_requests.find( change.request_id );
+		if( expired == server->expired_creation_requests.end() )
 		{
-			return &entity;
+			return;
+		}
+		worker::EntityId id = expired->second;
+		server->expired_creation_requests.erase( expired );
+		entity_info = GetInfoWithEnityId( id );
+		if( !entity_info && change.success )
+		{
+			LOG_WARNING( "Server", "Late CreateEntity for %lld succeeded after it was dropped, deleting it", (long long)change.id );
+			RequestEntityDeletion( change.id );
 		}
 	}
 
-	return nullptr;
+	if( !entity_info )
+	{
+		return;
+	}
+	if( entity_info->creation_unanswered > 0 )
+	{
+		--entity_info->creation_unanswered;
+	}
+
+	if( !change.success )
+	{
+		// With an attempt that already took the id or may still take it, retries only fail as already in use.
+		if( !entity_info->created && entity_info->creation_unanswered == 0 )
+		{
+			RetryEntityCreation( entity_info );
+		}
+	}
+	else if( !entity_info->created )
+	{
+		if( entity_info->id != 0 )
+		{
+			if( entity_info->id != change.id )
+			{
+				LOG_WARNING( "Server", "Entity was assigned %lld but created as %lld", (long long)entity_info->id, (long long)change.id );
+			}
+		}
+		std::lock_guard<std::mutex> lg( GetInstance()->entity_info_list_lock );
+		GetInstance()->entity_info_list.SetEntityId( entity_info, change.id );
+		entity_info->created = true;
+		LOG_DEBUG( "Server", "Entity %lld created", (long long)entity_info->id );
+
+		spawn_stats_t& stats = GetInstance()->spawn_stats;
+		double latency = GetCurrentTimeSeconds() - entity_info->creation_requested_time;
+		++stats.created;
+		stats.total_latency_seconds += latency;
+		if( latency > stats.max_latency_seconds )
+		{
+			stats.max_latency_seconds = latency;
+		}
+	}
 }
 
 //--------------------------------------------------------------------------
 /**
-* GetInfoFromEnity
+* ReserveEntityIdsResponse
+* Ids for the pool, spawns that found it empty go first.
 */
-entity_info_t* SpatialOSServer::GetInfoWithEnity( EntityBase* entity_id )
+void SpatialOSServer::ReserveEntityIdsResponse( const inbound_change_t& change )
 {
-	std::lock_guard<std::mutex> lg(GetInstance()->entity_info_list_lock);
-	for ( entity_info_t& entity : GetInstance()->entity_info_list )
+	pending_request_t request;
+	if( !GetInstance()->pending_requests.Complete( change.request_id, change.success, GetCurrentTimeSeconds(), request ) )
+	{
+		// Already given up on, the pool asked again.
+		return;
+	}
+	if( !GetInstance()->entity_id_pool.OnResponse( change.request_id, change.success, change.id ) )
+	{
+		return;
+	}
+	if( !change.success )
+	{
+		LOG_WARNING( "Server", "ReserveEntityIds request %llu failed", (unsigned long long)change.request_id );
+	}
+
+	CreateWaitingEntities();
+	RefillEntityIds();
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendEntityCreation
+*/
+void SpatialOSServer::SendEntityCreation( entity_info_t* entity_info, worker::EntityId id )
+{
+	// Send response back to however sent the command if triggered by a command, once.
+	if( entity_info->command_response_id != (uint64_t)-1 && entity_info->creation_attempts == 0 )
+	{
+		outbound_message_t command_response;
+		command_response.type = OUTBOUND_CREATE_CLIENT_ENTITY_RESPONSE;
+		command_response.id = id;
+		command_response.request_id = entity_info->command_response_id;
+		GetInstance()->PushOutbound( std::move( command_response ) );
+	}
+
+	SpatialOSServer* server = GetInstance();
+	EntityBase* entity = entity_info->game_entity;
+	double build_start = GetCurrentTimeSeconds();
+	worker::Entity clientEntity;
+	if( server->use_entity_templates && entity->GetTypeId() != INVALID_ENTITY_TYPE_ID )
+	{
+		clientEntity = server->entity_templates.Make( entity->GetTypeId(), entity->GetPosition(), entity_info->owner_id );
+		++server->spawn_stats.from_template;
+	}
+	else
+	{
+		clientEntity = EntityTemplateCache::BuildEntity( entity->GetName(), entity->GetPosition(), entity_info->owner_id );
+	}
+	server->spawn_stats.total_build_seconds += GetCurrentTimeSeconds() - build_start;
+	++server->spawn_stats.built;
+	++entity_info->creation_attempts;
+	++entity_info->creation_unanswered;
+
+	{
+		std::lock_guard<std::mutex> lg( GetInstance()->entity_info_list_lock );
+		GetInstance()->entity_info_list.SetEntityId( entity_info, id );
+	}
+
+	// The creation request id comes back as INBOUND_CREATE_SENT.
+	outbound_message_t create_request;
+	create_request.type = OUTBOUND_CREATE_ENTITY;
+	create_request.id = id;
+	create_request.worker_entity = std::move( clientEntity );
+	GetInstance()->PushOutbound( std::move( create_request ) );
+	LOG_DEBUG( "Server", "Creating entity %lld", (long long)id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* RetryEntityCreation
+* After a CreateEntity request failed or expired. The id is still reserved, so it's
+* sent again with it until it runs out of attempts. Then the entity is dropped, once
+* no expired attempt is left that could still have created it.
+*/
+void SpatialOSServer::RetryEntityCreation( entity_info_t* entity_info )
+{
+	SpatialOSServer* server = GetInstance();
+	{
+		std::lock_guard<std::mutex> lg( server->entity_info_list_lock );
+		server->entity_info_list.SetCreationRequestId( entity_info, 0 );
+	}
+
+	if( entity_info->game_entity && entity_info->creation_attempts < kMaxEntityCreationAttempts )
+	{
+		LOG_WARNING( "Server", "CreateEntity for %lld failed, sending again", (long long)entity_info->id );
+		SendEntityCreation( entity_info, entity_info->id );
+		return;
+	}
+	if( entity_info->creation_unanswered > 0 )
+	{
+		return;
+	}
+
+	++server->spawn_stats.dropped;
+	if( entity_info->game_entity )
+	{
+		LOG_WARNING( "Server", "CreateEntity for %lld failed %u times, dropping the entity", (long long)entity_info->id, entity_info->creation_attempts );
+		entity_info->game_entity->Die();
+	}
+	else
+	{
+		LOG_WARNING( "Server", "CreateEntity for %lld failed after its entity was destroyed, dropping it", (long long)entity_info->id );
+	}
+	std::lock_guard<std::mutex> lg( server->entity_info_list_lock );
+	server->entity_info_list.Remove( entity_info );
+}
+
+//--------------------------------------------------------------------------
+/**
+* ExpireRequests
+* Requests past their deadline are treated as failed.
+*/
+void SpatialOSServer::ExpireRequests()
+{
+	SpatialOSServer* server = GetInstance();
+	std::vector<pending_request_t> expired;
+	server->pending_requests.TakeExpired( GetCurrentTimeSeconds(), expired );
+	for( const pending_request_t& request : expired )
+	{
+		LOG_WARNING( "Server", "Request %llu got no response in time", (unsigned long long)request.request_id );
+		switch( request.stage )
+		{
+		case REQUEST_STAGE_RESERVE:
+			server->entity_id_pool.OnResponse( request.request_id, false, 0 );
+			break;
+		case REQUEST_STAGE_CREATE:
+		{
+			entity_info_t* entity_info = GetInfoWithCreateEnityRequest( request.request_id );
+			if( entity_info )
+			{
+				server->expired_creation_requests[request.request_id] = request.entity_id;
+				RetryEntityCreation( entity_info );
+			}
+			break;
+		}
+		case REQUEST_STAGE_DELETE:
+		{
+			entity_info_t* entity_info = GetInfoWithDeleteEnityRequest( request.request_id );
+			if( entity_info )
+			{
+				std::lock_guard<std::mutex> lg( server->entity_info_list_lock );
+				server->entity_info_list.SetDeletionRequestId( entity_info, 0 );
+			}
+			break;
+		}
+		default:
+			break;
+		}
+	}
+
+	if( !expired.empty() )
+	{
+		CreateWaitingEntities();
+		RefillEntityIds();
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* CreateWaitingEntities
+* In the order they were requested. Entities deleted while waiting are skipped.
+*/
+void SpatialOSServer::CreateWaitingEntities()
+{
+	SpatialOSServer* server = GetInstance();
+	while( !server->entities_waiting_for_ids.empty() )
 	{
-		if ( entity.game_entity == entity_id )
+		entity_info_t* entity_info = GetInfoWithEnity( server->entities_waiting_for_ids.front() );
+		if( entity_info && entity_info->id == 0 )
 		{
-			return &entity;
+			worker::EntityId id;
+			if( !server->entity_id_pool.TryTake( id ) )
+			{
+				return;
+			}
+			SendEntityCreation( entity_info, id );
 		}
+		server->entities_waiting_for_ids.pop_front();
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* RefillEntityIds
+* The request id comes back as INBOUND_RESERVE_SENT ahead of the response.
+*/
+void SpatialOSServer::RefillEntityIds()
+{
+	SpatialOSServer* server = GetInstance();
+	uint32_t count = server->entity_id_pool.TakeRefillCount( (uint32_t) server->entities_waiting_for_ids.size() );
+	if( count == 0 )
+	{
+		return;
 	}
 
-	return nullptr;
+	outbound_message_t message;
+	message.type = OUTBOUND_RESERVE_ENTITY_ID;
+	message.count = count;
+	server->PushOutbound( std::move( message ) );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetInfoFromCreateEnityRequest
+*/
+entity_info_t* SpatialOSServer::GetInfoWithCreateEnityRequest( uint64_t entity_creation_request_id )
+{
+	std::lock_guard<std::mutex> lg( GetInstance()->entity_info_list_lock );
+	return GetInstance()->entity_info_list.FindWithCreationRequest( entity_creation_request_id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetInfoFromDeleteEnityRequest
+*/
+entity_info_t* SpatialOSServer::GetInfoWithDeleteEnityRequest( uint64_t entity_deletion_request_id )
+{
+	std::lock_guard<std::mutex> lg( GetInstance()->entity_info_list_lock );
+	return GetInstance()->entity_info_list.FindWithDeletionRequest( entity_deletion_request_id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetInfoFromEnityId
+*/
+entity_info_t* SpatialOSServer::GetInfoWithEnityId(const worker::EntityId& entity_id )
+{
+	std::lock_guard<std::mutex> lg( GetInstance()->entity_info_list_lock );
+	return GetInstance()->entity_info_list.FindWithEntityId( entity_id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetInfoFromEnity
+*/
+entity_info_t* SpatialOSServer::GetInfoWithEnity( EntityBase* entity_id )
+{
+	std::lock_guard<std::mutex> lg( GetInstance()->entity_info_list_lock );
+	return GetInstance()->entity_info_list.FindWithEntity( entity_id );
 }
 
 //--------------------------------------------------------------------------
@@ -678,11 +1602,11 @@ void SpatialOSServer::PrintAllEntityinfos()
 	std::cout << "Print all Entities in spatial server" << std::endl;
 	std::cout << "	Thread: " << std::this_thread::get_id() << std::endl;
 
-	for( entity_info_t& info : GetInstance()->entity_info_list )
+	for( entity_info_t* info : GetInstance()->entity_info_list.GetAll() )
 	{
-		std::cout << "	Info id: " << info.id << std::endl;
-		std::cout << "		created: " << ( info.created ? "Yes" : "No" ) << std::endl;
-		std::cout << "		updated: " << ( info.updated ? "Yes" : "No" ) << std::endl;
+		std::cout << "	Info id: " << info->id << std::endl;
+		std::cout << "		created: " << ( info->created ? "Yes" : "No" ) << std::endl;
+		std::cout << "		updated: " << ( info->updated ? "Yes" : "No" ) << std::endl;
 	}
 }
 
@@ -690,44 +1614,132 @@ void SpatialOSServer::PrintAllEntityinfos()
 /**
 * EntityCreation
 */
-void SpatialOSServer::PlayerCreation( const worker::CommandRequestOp<CreateClientEntity>& op )
+void SpatialOSServer::PlayerCreation( const inbound_change_t& change )
 {
 	// ID reservation was successful - create an entity with the reserved ID.
 	//--------------------------------------------------------------------------
-	std::cout << "Received a command request from: " << op.CallerWorkerId << std::endl;
+	LOG_INFO( "Server", "Player creation requested by %s", change.caller_worker_id.c_str() );
 	
 	EntityBase* base = g_theSim->CreateSimulatedEntity( "player" );
-	base->SetPosition( Vec2( -1.0f, 0.0f ) );
-	SpatialOSServer::RequestEntityCreation( base );
+	base->SetPosition( 1.0f, 1.0f );
 
-	entity_info_t* info = GetInfoWithEnity( base );
+	// The command is answered once the player has an entity id, often straight away from the pool.
+	SpatialOSServer::RequestEntityCreation( base, change.caller_worker_id, change.request_id );
+}
 
-	if( info )
+//--------------------------------------------------------------------------
+/**
+* PlayerDeletion
+*/
+void SpatialOSServer::PlayerDeletion( const inbound_change_t& change )
+{
+	LOG_INFO( "Server", "Deleting player entity %lld", (long long)change.id );
+	SpatialOSServer::RequestEntityDeletion( change.id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* ClientPingReceived
+*/
+void SpatialOSServer::ClientPingReceived( const inbound_change_t& change )
+{
+	SpatialOSServer* server = GetInstance();
+	double now = GetCurrentTimeSeconds();
 	{
-		info->owner_id = op.CallerWorkerId;
-		info->id = op.Request.id_to_create();
-		info->game_entity->SetPosition( 1.0f, 1.0f );
+		// Under the lock since client_stats reads these from the console.
+		std::lock_guard<std::mutex> lg( server->entity_info_list_lock );
+		entity_info_t* info = server->entity_info_list.FindWithEntityId( change.id );
+		if( !info || info->owner_id != change.caller_worker_id )
+		{
+			LOG_DEBUG( "Server", "Ping from %s for entity %lld it doesn't own", change.caller_worker_id.c_str(), (long long)change.id );
+			++server->client_heartbeat_stats.rejected;
+			return;
+		}
 
-		std::cout << "entity sent successfully" << std::endl;
+		if( info->pings > 0 )
+		{
+			info->max_heartbeat_gap = std::max( info->max_heartbeat_gap, now - info->last_heartbeat_time );
+		}
+		info->last_heartbeat_time = now;
+		info->client_rtt_ms = change.rtt_ms;
+		info->client_jitter_ms = change.jitter_ms;
+		++info->pings;
+		++server->client_heartbeat_stats.pings;
+	}
 
-		// For responding to the command when an ID has been obtained.
-		info->command_response_id = op.RequestId.Id;
-		std::cout << "player creation command response id: " << op.RequestId.Id << std::endl;
+	outbound_message_t message;
+	message.type = OUTBOUND_CLIENT_HEARTBEAT;
+	message.id = change.id;
+	message.heartbeat = change.heartbeat;
+	server->PushOutbound( std::move( message ) );
+}
+
+//--------------------------------------------------------------------------
+/**
+* EvictIdleClients
+* Players whose client stopped pinging go the same way as a DeleteClientEntity.
+* Checked once a second, and again a timeout later if the deletion didn't take.
+*/
+void SpatialOSServer::EvictIdleClients()
+{
+	SpatialOSServer* server = GetInstance();
+	double now = GetCurrentTimeSeconds();
+	if( server->client_idle_timeout <= 0.0 || now < server->next_idle_check_time )
+	{
+		return;
 	}
-	else
+	server->next_idle_check_time = now + 1.0;
+
+	std::vector<worker::EntityId> idle;
 	{
-		std::cout << "Warning: SpatialOSServer::PlayerCreation failed to create the info for the player." << std::endl;
+		std::lock_guard<std::mutex> lg( server->entity_info_list_lock );
+		for( entity_info_t* info : server->entity_info_list.GetAll() )
+		{
+			if( info->owner_id.empty() || !info->created || info->entity_deletion_request_id != 0
+				|| now - info->last_heartbeat_time < server->client_idle_timeout
+				|| now - info->eviction_time < server->client_idle_timeout )
+			{
+				continue;
+			}
+			info->eviction_time = now;
+			idle.push_back( info->id );
+		}
+	}
+
+	for( worker::EntityId id : idle )
+	{
+		LOG_WARNING( "Server", "Player entity %lld hasn't pinged in %.1fs, evicting it", (long long)id, server->client_idle_timeout );
+		++server->client_heartbeat_stats.evicted;
+
+		inbound_change_t change;
+		change.type = INBOUND_PLAYER_DELETION;
+		change.id = id;
+		PlayerDeletion( change );
 	}
 }
 
 //--------------------------------------------------------------------------
 /**
-* PlayerDeletion
+* EntityDestroyed
+* From ~EntityBase. Actors and abilities go back to their pools, so the info drops the
+* pointer before a new entity can turn up at the same address. An entity still waiting
+* for an id never reached SpatialOS and its info goes with it.
 */
-void SpatialOSServer::PlayerDeletion(const worker::CommandRequestOp<DeleteClientEntity>& op)
+void SpatialOSServer::EntityDestroyed( EntityBase* entity )
 {
-	std::cout << "SpatialOSServer::PlayerDeletion | Deleting ID: " << op.Request.id_to_delete() << std::endl;
-	SpatialOSServer::RequestEntityDeletion( op.Request.id_to_delete() );
+	SpatialOSServer* server = GetInstance();
+	std::lock_guard<std::mutex> lg( server->entity_info_list_lock );
+	entity_info_t* info = server->entity_info_list.FindWithEntity( entity );
+	if( !info )
+	{
+		return;
+	}
+	if( info->id == 0 )
+	{
+		server->entity_info_list.Remove( info );
+		return;
+	}
+	server->entity_info_list.SetGameEntity( info, nullptr );
 }
 
 //--------------------------------------------------------------------------
@@ -745,6 +1757,8 @@ SpatialOSServer* SpatialOSServer::GetInstance()
 * SpatialOSSystem
 */
 SpatialOSServer::SpatialOSServer()
+	: inbound_changes( kInboundQueueCapacity )
+	, outbound_messages( kOutboundQueueCapacity )
 {
 
 }
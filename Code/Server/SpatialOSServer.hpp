@@ -6,29 +6,156 @@
 
 #include "ClientServer.h"
 
+#include "Server/EntityIdPool.hpp"
+#include "Server/EntityInfoRegistry.hpp"
+#include "Server/EntityTemplateCache.hpp"
+#include "Server/PendingRequestTable.hpp"
+
+#include "Shared/SpscQueue.hpp"
+#include "Shared/WorkerConnection.hpp"
+
+#include <atomic>
+#include <deque>
 #include <thread>
+#include <unordered_map>
 #include <mutex>
 
 class EntityBase;
 class View;
+class LocalWorkerBus;
+
+struct position_update_settings_t
+{
+	float epsilon = 0.01f;			// Smallest move worth sending.
+	float max_rate_hz = 60.0f;		// Per entity, 0 or less for no limit.
+	float coordinates_rate_hz = 2.0f;	// improbable::Position, only load balancing and interest read it. 0 or less sends it with every update.
+	plane_position_settings_t plane_position;
+};
+
+struct position_update_stats_t
+{
+	uint32_t sent = 0;
+	uint32_t suppressed = 0;
+	uint32_t keyframes = 0;
+	uint32_t coordinates_sent = 0;
+	uint64_t sent_bytes = 0;			// PlanePosition and Position fields that went out.
+	uint64_t coordinates_only_bytes = 0;	// What the same updates would have cost as Position alone.
+};
+
+struct spawn_stats_t
+{
+	uint64_t requested = 0;
+	uint64_t from_pool = 0;				// Sent their CreateEntity the frame they were requested.
+	uint64_t waited = 0;				// Found the pool empty and waited on a reservation.
+	uint64_t created = 0;
+	double total_latency_seconds = 0.0;	// RequestEntityCreation to the CreateEntity response, over created.
+	double max_latency_seconds = 0.0;
+	uint64_t dropped = 0;				// CreateEntity failed every attempt.
+
+	uint64_t built = 0;					// worker::Entity put together for CreateEntity.
+	uint64_t from_template = 0;			// Of those, copied from a cached template.
+	double total_build_seconds = 0.0;
+};
+
+struct client_heartbeat_stats_t
+{
+	uint64_t pings = 0;
+	uint64_t rejected = 0;				// For an entity the caller doesn't own.
+	uint64_t evicted = 0;				// Players deleted for going client_idle_timeout without a ping.
+};
+
+struct client_link_stats_t
+{
+	std::string worker_id;
+	worker::EntityId id = 0;
+	uint64_t pings = 0;
+	float rtt_ms = 0.0f;
+	float jitter_ms = 0.0f;
+	double seconds_since_heartbeat = 0.0;
+	double max_heartbeat_gap = 0.0;
+};
+
+struct pending_position_t
+{
+	worker::EntityId id = 0;
+	Vec2 position = Vec2::ZERO;
+	bool send_coordinates = false;
+	bool send_plane_position = false;
+	siren::PlanePosition::Update plane_position;
+};
 
-using CreateClientEntity = siren::ServerAPI::Commands::CreateClientEntity;
-using DeleteClientEntity = siren::ServerAPI::Commands::DeleteClientEntity;
+struct pending_movement_t
+{
+	worker::EntityId id;
+	uint32_t input_sequence;
+	Vec2 position;
+	Vec2 velocity;
+};
 
+// What the network thread hands the sim thread after decoding an op list.
+enum InboundChangeType
+{
+	INBOUND_ENTITY_CHANGED,
+	INBOUND_ENTITY_REMOVED,
+	INBOUND_RESERVE_SENT,
+	INBOUND_CREATE_SENT,
+	INBOUND_DELETE_SENT,
+	INBOUND_RESERVE_RESPONSE,
+	INBOUND_CREATE_RESPONSE,
+	INBOUND_DELETE_RESPONSE,
+	INBOUND_PLAYER_CREATION,
+	INBOUND_PLAYER_DELETION,
+	INBOUND_CLIENT_PING
+};
 
-struct entity_info_t
+struct inbound_change_t
 {
-	EntityBase* game_entity = nullptr;
+	InboundChangeType type = INBOUND_ENTITY_CHANGED;
 	worker::EntityId id = 0;
-	uint64_t entity_creation_request_id = 0;
-	uint64_t entity_deletion_request_id = 0;
-	uint64_t entity_id_reservation_request_id = 0;
-	uint64_t command_response_id = (uint64_t)-1;
-	std::string owner_id = "";
-	bool created = false;
-	bool updated = false;
+	uint64_t request_id = 0;
+	bool success = false;
+	uint32_t count = 0;						// Ids asked for, echoed back for INBOUND_RESERVE_SENT.
+	std::string caller_worker_id;
+
+	// INBOUND_ENTITY_CHANGED, decoded out of the View's worker::Entity.
+	bool has_position = false;
+	Vec2 position = Vec2::ZERO;
+	worker::Authority position_authority = worker::Authority::kNotAuthoritative;
+	bool has_controls = false;
+	Vec2 move_direction = Vec2::ZERO;
+	uint32_t input_sequence = 0;
+	std::string entity_type;				// Empty when there's no Metadata.
+
+	// INBOUND_CLIENT_PING, already answered by the network thread.
+	int64_t heartbeat = 0;
+	float rtt_ms = 0.0f;
+	float jitter_ms = 0.0f;
 };
 
+// What the sim thread wants sent, the network thread owns the connection.
+enum OutboundMessageType
+{
+	OUTBOUND_RESERVE_ENTITY_ID,
+	OUTBOUND_CREATE_ENTITY,
+	OUTBOUND_DELETE_ENTITY,
+	OUTBOUND_CREATE_CLIENT_ENTITY_RESPONSE,
+	OUTBOUND_CLIENT_HEARTBEAT,
+	OUTBOUND_POSITION_UPDATES
+};
+
+struct outbound_message_t
+{
+	OutboundMessageType type = OUTBOUND_POSITION_UPDATES;
+	worker::EntityId id = 0;
+	uint64_t request_id = 0;
+	uint32_t count = 0;					// OUTBOUND_RESERVE_ENTITY_ID
+	int64_t heartbeat = 0;				// OUTBOUND_CLIENT_HEARTBEAT
+	worker::Entity worker_entity;
+	std::vector<pending_position_t> positions;
+	std::vector<pending_movement_t> movements;			// Players', sent alongside their positions.
+};
+
+
 class SpatialOSServer
 {
 public:
@@ -38,28 +165,75 @@ public:
 	static void Process();
 
 public:
-	static void RequestEntityCreation( EntityBase* entity );
+	// Owner and command response are for player entities created through CreateClientEntity.
+	static void RequestEntityCreation( EntityBase* entity, const std::string& owner_id = "", uint64_t command_response_id = (uint64_t)-1 );
 	static void RequestEntityDeletion( const worker::EntityId entity );
 	static void UpdatePosition( EntityBase *entity );
+	static void UpdatePosition( EntityBase *entity, const Vec2& position );
+	static void FlushPositionUpdates();
 	static bool IsRunning();
 
+	static void SetPositionUpdateSettings( const position_update_settings_t& settings );
+	static void AdvanceTickTime( double seconds );
+	static const position_update_stats_t& GetPositionUpdateStats();
+	static void SetEntityIdPoolSettings( const entity_id_pool_settings_t& settings );
+	static entity_id_pool_stats_t GetEntityIdPoolStats();
+	static const spawn_stats_t& GetSpawnStats();
+	static void SetEntityTemplatesEnabled( bool enabled );
+	static size_t GetEntityTemplateCount();
+	static void SetRequestTimeout( double seconds );
+	static request_stage_stats_t GetRequestStats( RequestStage stage );
+	static void SetClientIdleTimeout( double seconds );
+	static const client_heartbeat_stats_t& GetClientHeartbeatStats();
+	static void GetClientLinks( std::vector<client_link_stats_t>& links );
+	static size_t GetPendingRequestCount();
+	static void ResetRequestStats();
+	static op_coalesce_stats_t GetOpCoalesceStats();
+
+	// Only set when started with "local", for harnesses that connect more workers in process.
+	static LocalWorkerBus* GetLocalBus();
+
+	// Sim thread. Saves every created entity with its entity id, loading replaces the
+	// entity infos with the checkpoint's so checkouts find their entities already there.
+	// Load before the first tick, returns how many entities came back.
+	static bool SaveWorldCheckpoint( const std::string& path );
+	static uint32_t LoadWorldCheckpoint( const std::string& path );
+	static uint32_t GetCreatedEntityCount();
+
 private:
 	static void Run( const std::vector<std::string> arguments );
-	static void RegisterCallbacks( worker::Dispatcher& dispatcher );
+	static void RegisterCallbacks( WorkerDispatcher& dispatcher );
+	static void SeedLocalBus( LocalWorkerBus& bus );
 
 private:
-	void Update();
-	static void UpdateEntityWithWorkerEntity( EntityBase& entity, worker::Entity& worker_entity, worker::Map<worker::ComponentId, worker::Authority>& auth );
-	static void InitEntityWithWorkerEntity( EntityBase& entity, worker::Entity& worker_entity );
+	// Network thread
+	void GatherEntityChanges();
+	void SendOutboundMessages();
+	void SendOutboundMessage( outbound_message_t& message );
+	void PushInbound( inbound_change_t&& change );
 
 private:
-	static uint64_t DeleteEntityResponse( const worker::DeleteEntityResponseOp& op );
-	static uint64_t CreateEntityResponse( const worker::CreateEntityResponseOp& op );
-	static uint64_t ReserveEntityIdsResponse( const worker::ReserveEntityIdsResponseOp& op );
+	// Sim thread
+	void ApplyChange( const inbound_change_t& change );
+	void ApplyEntityChange( const inbound_change_t& change );
+	void ApplyEntityRemoval( const inbound_change_t& change );
+	void PushOutbound( outbound_message_t&& message );
+	static void UpdateEntityWithChange( EntityBase& entity, const inbound_change_t& change );
+	static void InitEntityWithChange( EntityBase& entity, const inbound_change_t& change );
+
+private:
+	static void DeleteEntityResponse( const inbound_change_t& change );
+	static void CreateEntityResponse( const inbound_change_t& change );
+	static void ReserveEntityIdsResponse( const inbound_change_t& change );
+	static void SendEntityCreation( entity_info_t* entity_info, worker::EntityId id );
+	static bool QueuePosition( entity_info_t* entity_info, const Vec2& position );
+	static void CreateWaitingEntities();
+	static void RefillEntityIds();
+	static void RetryEntityCreation( entity_info_t* entity_info );
+	static void ExpireRequests();
 
 	static entity_info_t* GetInfoWithCreateEnityRequest( uint64_t entity_creation_request_id );
 	static entity_info_t* GetInfoWithDeleteEnityRequest( uint64_t entity_deletion_request_id );
-	static entity_info_t* GetInfoWithReserveEnityIdsRequest( uint64_t entity_id_reservation_request_id );
 	static entity_info_t* GetInfoWithEnityId( const worker::EntityId& entity_id );
 	static entity_info_t* GetInfoWithEnity( EntityBase* entity_id );
 
@@ -67,8 +241,11 @@ private:
 
 private:
 	// Component Updating
-	static void PlayerCreation( const worker::CommandRequestOp<CreateClientEntity>& op ); 
-	static void PlayerDeletion( const worker::CommandRequestOp<DeleteClientEntity>& op ); 
+	static void PlayerCreation( const inbound_change_t& change ); 
+	static void PlayerDeletion( const inbound_change_t& change ); 
+	static void ClientPingReceived( const inbound_change_t& change );
+	static void EvictIdleClients();
+	static void EntityDestroyed( EntityBase* entity );
 
 private:
 	static SpatialOSServer* GetInstance();
@@ -76,14 +253,45 @@ private:
 	~SpatialOSServer();
 
 private:
-	bool isRunning = false;
+	std::atomic<bool> isRunning{ false };
 	std::thread server_thread;
 
-	View* view;
+	std::atomic<LocalWorkerBus*> local_bus{ nullptr };	// Owned by the network thread.
+
+	// Only touched by the network thread.
+	View* view = nullptr;
+	WorkerConnection* connection = nullptr;
 
-	worker::Connection* connection;
+	// Network thread -> sim thread and back. Whatever doesn't fit waits in the
+	// backlog of the pushing side so nothing gets dropped or reordered.
+	SpscQueue<inbound_change_t> inbound_changes;
+	SpscQueue<outbound_message_t> outbound_messages;
+	std::deque<inbound_change_t> inbound_backlog;			// Network thread only.
+	std::deque<outbound_message_t> outbound_backlog;		// Sim thread only.
 
 	std::mutex entity_info_list_lock;
 
-	std::vector<entity_info_t> entity_info_list;
+	std::mutex op_coalesce_stats_lock;
+	op_coalesce_stats_t op_coalesce_stats;					// Copied from the connection by the network thread.
+
+	EntityInfoRegistry entity_info_list;
+
+	std::vector<pending_position_t> pending_position_updates;
+	std::vector<pending_movement_t> pending_movement_updates;
+	position_update_settings_t position_update_settings;
+	double tick_time = 0.0;										// Sim seconds so far, what the send throttles run on.
+	position_update_stats_t position_update_stats;				// Frame being gathered.
+	position_update_stats_t last_frame_position_update_stats;	// Last flushed frame.
+
+	// Sim thread.
+	EntityIdPool entity_id_pool;
+	std::deque<EntityBase*> entities_waiting_for_ids;
+	spawn_stats_t spawn_stats;
+	EntityTemplateCache entity_templates;
+	bool use_entity_templates = false;
+	PendingRequestTable pending_requests;
+	std::unordered_map<uint64_t, worker::EntityId> expired_creation_requests;	// Given up on and sent again, by request id. A late success still counts.
+	double client_idle_timeout = 15.0;
+	double next_idle_check_time = 0.0;
+	client_heartbeat_stats_t client_heartbeat_stats;
 };
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "Server/View.hpp"
 
+#include "Shared/AsyncLog.hpp"
+
 
 //--------------------------------------------------------------------------
 /**
@@ -7,16 +9,112 @@
 */
 void View::CleanupGarbage()
 {
-	auto itr = m_entities.begin();
-	while( itr != m_entities.end() )
+	for( worker::EntityId id : m_garbage )
 	{
-		if( itr->second.garbage )
+		uint32_t slot = m_components.FindSlot( id );
+		if( slot != ViewComponentStore::INVALID_SLOT && m_entity_states[slot].garbage )
 		{
-			itr = m_entities.erase( itr );
+			m_entity_states[slot] = entity_state_t();
+			m_components.RemoveEntity( id );
 		}
-		else
+	}
+	for( worker::EntityId id : m_dirty )
+	{
+		uint32_t slot = m_components.FindSlot( id );
+		if( slot != ViewComponentStore::INVALID_SLOT )
 		{
-			++itr;
+			m_entity_states[slot].changed = 0;
 		}
 	}
+	m_garbage.clear();
+	m_dirty.clear();
+}
+
+//--------------------------------------------------------------------------
+/**
+* FindLiveSlot
+*/
+uint32_t View::FindLiveSlot( worker::EntityId id ) const
+{
+	uint32_t slot = m_components.FindSlot( id );
+	if( slot != ViewComponentStore::INVALID_SLOT && !m_entity_states[slot].garbage )
+	{
+		return slot;
+	}
+	return ViewComponentStore::INVALID_SLOT;
+}
+
+//--------------------------------------------------------------------------
+/**
+* AddEntity
+* Checked out again before the removal was consumed, start over with an empty slot.
+*/
+void View::AddEntity( worker::EntityId id )
+{
+	uint32_t slot = m_components.AddEntity( id );
+	if( slot >= m_entity_states.size() )
+	{
+		m_entity_states.resize( slot + 1 );
+	}
+	if( m_entity_states[slot].garbage )
+	{
+		m_components.ClearSlot( slot );
+		m_entity_states[slot] = entity_state_t();
+	}
+	MarkChanged( id, slot, VIEW_CHANGED_ADDED );
+	LOG_DEBUG( "View", "AddEntity: %lld", (long long)id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* RemoveEntity
+*/
+void View::RemoveEntity( worker::EntityId id )
+{
+	uint32_t slot = FindLiveSlot( id );
+	if( slot != ViewComponentStore::INVALID_SLOT )
+	{
+		m_entity_states[slot].garbage = true;
+		m_garbage.push_back( id );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* RemoveComponent
+*/
+void View::RemoveComponent( worker::EntityId id, worker::ComponentId component_id )
+{
+	uint32_t slot = FindLiveSlot( id );
+	if( slot != ViewComponentStore::INVALID_SLOT && m_components.RemoveComponent( slot, component_id ) )
+	{
+		MarkChanged( id, slot, GetViewChangeBit( component_id ) );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* ChangeAuthority
+*/
+void View::ChangeAuthority( worker::EntityId id, worker::ComponentId component_id, worker::Authority authority )
+{
+	uint32_t slot = FindLiveSlot( id );
+	if( slot != ViewComponentStore::INVALID_SLOT && m_components.SetAuthority( slot, component_id, authority ) )
+	{
+		MarkChanged( id, slot, VIEW_CHANGED_AUTHORITY );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* MarkChanged
+*/
+void View::MarkChanged( worker::EntityId id, uint32_t slot, uint32_t bits )
+{
+	entity_state_t& state = m_entity_states[slot];
+	if( state.changed == 0 )
+	{
+		m_dirty.push_back( id );
+	}
+	state.changed |= bits;
 }
@@ -1,15 +1,16 @@
 #pragma once
-#include <improbable/worker.h>
-#include <improbable/standard_library.h>
+#include "Shared/WorkerDispatcher.hpp"
+#include "Shared/ViewComponentStore.hpp"
+
 #include <iostream>
+#include <vector>
 
 
 class View 
-	: public worker::Dispatcher
+	: public WorkerDispatcher
 {
 public:
-	template <typename... T>
-	View(const worker::Components<T...>& components);
+	View() {};
 	~View() {};
 
 	// Not copyable or movable.
@@ -20,84 +21,63 @@ public:
 
 
 public:
-	struct entity_tracker_t
+	struct entity_state_t
 	{
-		worker::Entity worker_entity;
-		bool updated = false;
+		uint32_t changed = 0;			// ViewChangeBits, non zero while the entity is on the dirty list.
 		bool garbage = false;
 	};
 
-	void CleanupGarbage();
-
-	worker::Map<worker::EntityId, entity_tracker_t> m_entities;
-	worker::Map<worker::EntityId, worker::Map<worker::ComponentId, worker::Authority>> m_component_authority;
+	// Consumers walk these instead of every entity. An id can be on both if it was removed
+	// and checked out again in the same frame, the removal comes first.
+	const std::vector<worker::EntityId>& GetDirtyEntities() const		{ return m_dirty; }
+	const std::vector<worker::EntityId>& GetGarbageEntities() const		{ return m_garbage; }
 
-private:	
+	// Erases what was removed, clears what changed and empties both lists, call once the changes have been consumed.
+	void CleanupGarbage();
 
-	struct track_component_handler {
-		View& view_reference;
+	// Slot of an entity that's still in view, ViewComponentStore::INVALID_SLOT otherwise.
+	uint32_t FindLiveSlot( worker::EntityId id ) const;
+	entity_state_t& GetEntityState( uint32_t slot )						{ return m_entity_states[slot]; }
 
-		template <typename T>
-		void Accept() const 
-		{
-			View& view = this->view_reference;
+	ViewComponentStore m_components;
 
-			view.OnAddComponent<T>([&view](const worker::AddComponentOp<T>& op) 
-			{
-				auto it = view.m_entities.find(op.EntityId);
-				if ( it != view.m_entities.end() && !it->second.garbage ) {
-					entity_tracker_t& tracker = it->second;
-					tracker.worker_entity.Add<T>(op.Data);
-					tracker.updated = true;
-				}
-			});
+public:
+	// WorkerDispatcher
+	void AddEntity( worker::EntityId id ) override;
+	void RemoveEntity( worker::EntityId id ) override;
+	void AddComponent( worker::EntityId id, const improbable::PositionData& data ) override				{ TrackAdd<improbable::Position>( id, data ); }
+	void AddComponent( worker::EntityId id, const improbable::MetadataData& data ) override				{ TrackAdd<improbable::Metadata>( id, data ); }
+	void AddComponent( worker::EntityId id, const siren::PlayerControlsData& data ) override			{ TrackAdd<siren::PlayerControls>( id, data ); }
+	void UpdateComponent( worker::EntityId id, const improbable::Position::Update& update ) override	{ TrackUpdate<improbable::Position>( id, update ); }
+	void UpdateComponent( worker::EntityId id, const improbable::Metadata::Update& update ) override	{ TrackUpdate<improbable::Metadata>( id, update ); }
+	void UpdateComponent( worker::EntityId id, const siren::PlayerControls::Update& update ) override	{ TrackUpdate<siren::PlayerControls>( id, update ); }
+	void RemoveComponent( worker::EntityId id, worker::ComponentId component_id ) override;
+	void ChangeAuthority( worker::EntityId id, worker::ComponentId component_id, worker::Authority authority ) override;
 
-			view.OnRemoveComponent<T>([&view](const worker::RemoveComponentOp& op) 
-			{
-				auto it = view.m_entities.find(op.EntityId);
-				if ( it != view.m_entities.end() && !it->second.garbage ) {
-					entity_tracker_t& tracker = it->second;
-					tracker.worker_entity.Remove<T>();
-					tracker.updated = true;
-				}
-			});
+private:
+	void MarkChanged( worker::EntityId id, uint32_t slot, uint32_t bits );
 
-			view.OnAuthorityChange<T>([&view](const worker::AuthorityChangeOp& op) 
-			{
-				view.m_component_authority[op.EntityId][T::ComponentId] = op.Authority;
-			});
+	template <typename T>
+	void TrackAdd( worker::EntityId id, const typename T::Data& data )
+	{
+		uint32_t slot = FindLiveSlot( id );
+		if( slot != ViewComponentStore::INVALID_SLOT ) {
+			m_components.Set<T>( slot, data );
+			MarkChanged( id, slot, GetViewChangeBit( T::ComponentId ) );
+		}
+	}
 
-			view.OnComponentUpdate<T>([&view](const worker::ComponentUpdateOp<T>& op) 
-			{
-				auto it = view.m_entities.find(op.EntityId);
-				if (it != view.m_entities.end() && !it->second.garbage ) {
-					entity_tracker_t& tracker = it->second;
-					if (tracker.worker_entity.Get<T>()) {
-						tracker.worker_entity.Update<T>(op.Update);
-						tracker.updated = true;
-					}
-				}
-			});
+	template <typename T>
+	void TrackUpdate( worker::EntityId id, const typename T::Update& update )
+	{
+		uint32_t slot = FindLiveSlot( id );
+		if( slot != ViewComponentStore::INVALID_SLOT && m_components.Update<T>( slot, update ) ) {
+			MarkChanged( id, slot, GetViewChangeBit( T::ComponentId ) );
 		}
-	};
-};
+	}
 
-//--------------------------------------------------------------------------
-/**
-* View
-*/
-template <typename... T>
-View::View(const worker::Components<T...>& components)
-	: worker::Dispatcher{components}
-{
-	OnAddEntity([this](const worker::AddEntityOp& op) {
-		m_entities[op.EntityId];
-		m_component_authority[op.EntityId];
-		std::cout << "AddEntity: " << op.EntityId << std::endl;
-		});
-	OnRemoveEntity([this](const worker::RemoveEntityOp& op) {
-		m_entities[op.EntityId].garbage = true;
-		m_component_authority.erase(op.EntityId);
-		});
-	ForEachComponent(components, track_component_handler{ *this });
-}
+private:
+	std::vector<entity_state_t> m_entity_states;		// Indexed by slot
+	std::vector<worker::EntityId> m_dirty;
+	std::vector<worker::EntityId> m_garbage;
+};
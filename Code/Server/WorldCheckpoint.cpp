@@ -0,0 +1,173 @@
+#include "Server/WorldCheckpoint.hpp"
+
+#include "Shared/ActorBase.hpp"
+#include "Shared/AsyncLog.hpp"
+#include "Shared/ControllerBase.hpp"
+#include "Shared/EntityBase.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+
+static const char kCheckpointMagic[4] = { 'W', 'C', 'K', 'P' };
+
+static_assert( std::is_trivially_copyable<world_checkpoint_entity_t>::value, "Checkpoint records are read in place" );
+static_assert( sizeof( world_checkpoint_header_t ) % alignof( world_checkpoint_entity_t ) == 0, "Records after the header must stay aligned" );
+static_assert( sizeof( world_checkpoint_type_t ) % alignof( world_checkpoint_entity_t ) == 0, "Records after the type table must stay aligned" );
+
+//--------------------------------------------------------------------------
+/**
+* Write
+*/
+bool WorldCheckpoint::Write( const std::string& path, const std::vector<world_checkpoint_source_t>& sources )
+{
+	std::vector<world_checkpoint_type_t> types;
+	std::vector<world_checkpoint_entity_t> entities;
+	std::unordered_map<EntityTypeId, uint16_t> type_indices;
+	std::vector<char> owners( 1, '\0' );
+	std::unordered_map<std::string, uint32_t> owner_offsets;
+	entities.reserve( sources.size() );
+
+	for( const world_checkpoint_source_t& source : sources )
+	{
+		EntityTypeId type_id = source.entity->GetTypeId();
+		auto found = type_indices.find( type_id );
+		if( found == type_indices.end() )
+		{
+			const std::string& name = EntityTypeRegistry::GetName( type_id );
+			if( name.empty() || name.size() >= WORLD_CHECKPOINT_TYPE_NAME_SIZE )
+			{
+				LOG_WARNING( "Checkpoint", "Leaving out entity %lld, its type name doesn't fit", (long long)source.id );
+				continue;
+			}
+			world_checkpoint_type_t type = {};
+			memcpy( type.name, name.c_str(), name.size() );
+			found = type_indices.emplace( type_id, (uint16_t)types.size() ).first;
+			types.push_back( type );
+		}
+
+		const ActorBase* actor = dynamic_cast<const ActorBase*>( source.entity );
+		const ControllerBase* controller = actor ? actor->GetController() : nullptr;
+		Vec2 position = source.entity->GetPosition();
+		Vec2 velocity = source.entity->GetVelocity();
+
+		world_checkpoint_entity_t record = {};
+		record.id = source.id;
+		record.position[0] = position.x;
+		record.position[1] = position.y;
+		record.velocity[0] = velocity.x;
+		record.velocity[1] = velocity.y;
+		record.type = found->second;
+		record.controller = controller ? controller->GetKind() : CONTROLLER_NONE;
+		if( !source.owner_id.empty() )
+		{
+			auto owner = owner_offsets.emplace( source.owner_id, (uint32_t)owners.size() );
+			if( owner.second )
+			{
+				owners.insert( owners.end(), source.owner_id.c_str(), source.owner_id.c_str() + source.owner_id.size() + 1 );
+			}
+			record.owner = owner.first->second;
+		}
+		entities.push_back( record );
+	}
+
+	world_checkpoint_header_t header = {};
+	memcpy( header.magic, kCheckpointMagic, sizeof( header.magic ) );
+	header.version = WORLD_CHECKPOINT_VERSION;
+	header.entity_size = sizeof( world_checkpoint_entity_t );
+	header.type_count = (uint32_t)types.size();
+	header.entity_count = (uint32_t)entities.size();
+	header.owners_size = (uint32_t)owners.size();
+	header.types_offset = sizeof( header );
+	header.entities_offset = header.types_offset + types.size() * sizeof( world_checkpoint_type_t );
+	header.owners_offset = header.entities_offset + entities.size() * sizeof( world_checkpoint_entity_t );
+
+	std::string temp_path = path + ".tmp";
+	FILE* file = fopen( temp_path.c_str(), "wb" );
+	if( !file )
+	{
+		LOG_ERROR( "Checkpoint", "Couldn't open %s for writing", temp_path.c_str() );
+		return false;
+	}
+	bool written = fwrite( &header, sizeof( header ), 1, file ) == 1
+		&& fwrite( types.data(), sizeof( world_checkpoint_type_t ), types.size(), file ) == types.size()
+		&& fwrite( entities.data(), sizeof( world_checkpoint_entity_t ), entities.size(), file ) == entities.size()
+		&& fwrite( owners.data(), 1, owners.size(), file ) == owners.size();
+	written = fclose( file ) == 0 && written;
+
+	if( !written || !MappedFile::MoveOver( temp_path, path ) )
+	{
+		LOG_ERROR( "Checkpoint", "Couldn't write %s", path.c_str() );
+		remove( temp_path.c_str() );
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Open
+*/
+bool WorldCheckpoint::Open( const std::string& path )
+{
+	Close();
+	if( !m_file.Open( path ) )
+	{
+		return false;
+	}
+
+	const uint8_t* data = m_file.GetData();
+	size_t size = m_file.GetSize();
+	const world_checkpoint_header_t* header = (const world_checkpoint_header_t*)data;
+	bool valid = size >= sizeof( world_checkpoint_header_t )
+		&& memcmp( header->magic, kCheckpointMagic, sizeof( header->magic ) ) == 0
+		&& header->version == WORLD_CHECKPOINT_VERSION
+		&& header->entity_size == sizeof( world_checkpoint_entity_t )
+		&& header->types_offset % alignof( world_checkpoint_type_t ) == 0
+		&& header->entities_offset % alignof( world_checkpoint_entity_t ) == 0
+		&& header->types_offset + (uint64_t)header->type_count * sizeof( world_checkpoint_type_t ) <= size
+		&& header->entities_offset + (uint64_t)header->entity_count * sizeof( world_checkpoint_entity_t ) <= size
+		&& header->owners_size > 0
+		&& header->owners_offset + header->owners_size <= size
+		&& data[header->owners_offset + header->owners_size - 1] == '\0';
+	if( !valid )
+	{
+		LOG_WARNING( "Checkpoint", "%s isn't a version %u checkpoint", path.c_str(), WORLD_CHECKPOINT_VERSION );
+		Close();
+		return false;
+	}
+
+	m_header = header;
+	m_types = (const world_checkpoint_type_t*)( data + header->types_offset );
+	m_entities = (const world_checkpoint_entity_t*)( data + header->entities_offset );
+	m_owners = (const char*)( data + header->owners_offset );
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetOwner
+* Empty for an offset outside the owner strings. They end with a terminator, Open checks.
+*/
+const char* WorldCheckpoint::GetOwner( const world_checkpoint_entity_t& entity ) const
+{
+	if( !m_header || entity.owner >= m_header->owners_size )
+	{
+		return "";
+	}
+	return m_owners + entity.owner;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Close
+*/
+void WorldCheckpoint::Close()
+{
+	m_file.Close();
+	m_header = nullptr;
+	m_types = nullptr;
+	m_entities = nullptr;
+	m_owners = nullptr;
+}
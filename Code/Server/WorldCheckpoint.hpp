@@ -0,0 +1,85 @@
+#pragma once
+#include <improbable/worker.h>
+
+#include "Shared/MappedFile.hpp"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+class EntityBase;
+
+constexpr uint32_t WORLD_CHECKPOINT_VERSION = 2;
+constexpr size_t WORLD_CHECKPOINT_TYPE_NAME_SIZE = 32;
+
+//--------------------------------------------------------------------------
+// Layout on disk, all native byte order since a checkpoint is only read back by
+// the same build on the same machine. The header is followed by the type table,
+// the entity records and the owner strings, each starting at the offset the header gives.
+//--------------------------------------------------------------------------
+struct world_checkpoint_header_t
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t entity_size;			// sizeof(world_checkpoint_entity_t) when written, catches layout changes.
+	uint32_t type_count;
+	uint32_t entity_count;
+	uint32_t owners_size;			// Bytes of null terminated owner worker ids, starting with an empty one.
+	uint64_t types_offset;
+	uint64_t entities_offset;
+	uint64_t owners_offset;
+};
+
+struct world_checkpoint_type_t
+{
+	char name[WORLD_CHECKPOINT_TYPE_NAME_SIZE];		// Null terminated.
+};
+
+struct world_checkpoint_entity_t
+{
+	worker::EntityId id;
+	float position[2];
+	float velocity[2];
+	uint16_t type;					// Index into the type table, EntityTypeIds aren't stable across runs.
+	uint8_t controller;				// ControllerKind
+	uint8_t reserved;
+	uint32_t owner;					// Offset into the owner strings, 0 for entities no client owns.
+};
+
+// What goes into a checkpoint for one entity, gathered by the caller.
+struct world_checkpoint_source_t
+{
+	worker::EntityId id;
+	const EntityBase* entity;
+	std::string owner_id;
+};
+
+//--------------------------------------------------------------------------
+// Binary snapshot of the simulated entities and the entity ids they have in
+// SpatialOS, so a restarted Managed worker can pick its Zone back up without
+// going through reserve, create and checkout again.
+// Open maps the file and checks the header, the records are then read in place.
+//--------------------------------------------------------------------------
+class WorldCheckpoint
+{
+public:
+	// Writes next to the path and moves it over, so a crash mid write leaves the old checkpoint.
+	static bool Write( const std::string& path, const std::vector<world_checkpoint_source_t>& sources );
+
+public:
+	bool Open( const std::string& path );
+	void Close();
+
+	uint32_t GetTypeCount() const								{ return m_header ? m_header->type_count : 0; }
+	const world_checkpoint_type_t* GetTypes() const				{ return m_types; }
+	uint32_t GetEntityCount() const								{ return m_header ? m_header->entity_count : 0; }
+	const world_checkpoint_entity_t* GetEntities() const		{ return m_entities; }
+	const char* GetOwner( const world_checkpoint_entity_t& entity ) const;
+
+private:
+	MappedFile m_file;
+	const world_checkpoint_header_t* m_header = nullptr;
+	const world_checkpoint_type_t* m_types = nullptr;
+	const world_checkpoint_entity_t* m_entities = nullptr;
+	const char* m_owners = nullptr;
+};
@@ -1,5 +1,6 @@
 #include "Engine/Core/Debug/DevConsole.hpp"
 #include "Engine/Core/EventSystem.hpp"
+#include "Engine/Core/Strings/NamedStrings.hpp"
 
 #include "Engine/Physics/PhysicsSystem.hpp"
 #include "Engine/Input/InputSystem.hpp"
@@ -51,6 +52,10 @@ void WorldSim::Startup()
 {
 	Zone* zone = Zone::GetZone();
 	zone->m_physics_system->SetGravity( Vec2::ZERO );
+	zone->SetSpatialHashCellSize( g_gameConfigBlackboard.GetValue( "spatial_hash_cell_size", 5.0f ) );
+	zone->SetEntityStoreEnabled( g_gameConfigBlackboard.GetValue( "use_entity_store", false ) );
+	zone->SetThreadCount( (uint32_t) g_gameConfigBlackboard.GetValue( "zone_thread_count", 0 ) );
+	AbilityBase::GetPool().Reserve( (uint32_t) g_gameConfigBlackboard.GetValue( "ability_pool_reserve", 0 ) );
 	
 	std::cout << "Registering from XML" << std::endl;
 
@@ -59,6 +64,29 @@ void WorldSim::Startup()
 
 	std::cout << "Finished registering" << std::endl;
 
+	position_update_settings_t position_settings;
+	position_settings.epsilon = g_gameConfigBlackboard.GetValue( "position_update_epsilon", position_settings.epsilon );
+	position_settings.max_rate_hz = g_gameConfigBlackboard.GetValue( "position_update_max_rate", position_settings.max_rate_hz );
+	position_settings.coordinates_rate_hz = g_gameConfigBlackboard.GetValue( "position_coordinates_rate", position_settings.coordinates_rate_hz );
+	position_settings.plane_position.keyframe_interval = (uint32_t) g_gameConfigBlackboard.GetValue( "plane_position_keyframe_interval", (int) position_settings.plane_position.keyframe_interval );
+	position_settings.plane_position.max_delta_steps = g_gameConfigBlackboard.GetValue( "plane_position_max_delta", position_settings.plane_position.max_delta_steps );
+	SpatialOSServer::SetPositionUpdateSettings( position_settings );
+
+	entity_id_pool_settings_t id_pool_settings;
+	id_pool_settings.block_size = (uint32_t) g_gameConfigBlackboard.GetValue( "entity_id_block_size", (int) id_pool_settings.block_size );
+	id_pool_settings.low_water = (uint32_t) g_gameConfigBlackboard.GetValue( "entity_id_low_water", (int) id_pool_settings.low_water );
+	SpatialOSServer::SetEntityIdPoolSettings( id_pool_settings );
+	SpatialOSServer::SetRequestTimeout( g_gameConfigBlackboard.GetValue( "request_timeout", 10.0f ) );
+	SpatialOSServer::SetClientIdleTimeout( g_gameConfigBlackboard.GetValue( "client_idle_timeout", 15.0f ) );
+	SpatialOSServer::SetEntityTemplatesEnabled( g_gameConfigBlackboard.GetValue( "entity_templates", true ) );
+
+	// Left by the last run's shutdown, saves re-creating everything through SpatialOS.
+	std::string checkpoint_path = g_gameConfigBlackboard.GetValue( "world_checkpoint", std::string() );
+	if( !checkpoint_path.empty() )
+	{
+		SpatialOSServer::LoadWorldCheckpoint( checkpoint_path );
+	}
+
 
 // 	std::cout << "world setup" << std::endl;
 // 	
@@ -94,13 +122,28 @@ void WorldSim::UpdateWorldSim( float deltaSeconds )
 {
 	Zone::UpdateZones( deltaSeconds );
 
-	for( EntityBase* entity : Zone::GetZone()->m_entities )
+	Zone* zone = Zone::GetZone();
+	if( const EntityStore* store = zone->GetEntityStore() )
+	{
+		// Positions were gathered after the physics step, no need to touch the entities for them.
+		const Vec2* positions = store->GetPositions();
+		EntityBase* const* entities = store->GetEntities();
+		for( uint32_t idx = 0; idx < store->GetCount(); ++idx )
+		{
+			SpatialOSServer::UpdatePosition( entities[idx], positions[idx] );
+		}
+	}
+	else
 	{
-		if( entity )
+		for( EntityBase* entity : zone->m_entities )
 		{
-			SpatialOSServer::UpdatePosition( entity );
+			if( entity )
+			{
+				SpatialOSServer::UpdatePosition( entity );
+			}
 		}
 	}
+	SpatialOSServer::FlushPositionUpdates();
 }
 
 //--------------------------------------------------------------------------
@@ -109,18 +152,30 @@ void WorldSim::UpdateWorldSim( float deltaSeconds )
 */
 EntityBase* WorldSim::CreateSimulatedEntity( const std::string& name )
 {
-	if (AbilityBaseDefinition::DoesDefExist(name))
+	static const EntityTypeId player_type = EntityTypeRegistry::Intern( "player" );
+	EntityTypeId type_id = EntityTypeRegistry::Find( name );
+	return CreateSimulatedEntity( type_id, type_id == player_type ? CONTROLLER_SIM : CONTROLLER_AI );
+}
+
+//--------------------------------------------------------------------------
+/**
+* CreateSimulatedEntity
+* The controller only applies to actors.
+*/
+EntityBase* WorldSim::CreateSimulatedEntity( EntityTypeId type_id, ControllerKind controller )
+{
+	if (AbilityBaseDefinition::DoesDefExist(type_id))
 	{
-		return new AbilityBase(name);
+		return new AbilityBase(type_id);
 	}
-	else if (ActorBaseDefinition::DoesDefExist(name))
+	else if (ActorBaseDefinition::DoesDefExist(type_id))
 	{
-		ActorBase* actor = new ActorBase(name);
-		if (name == "player")
+		ActorBase* actor = new ActorBase(type_id);
+		if (controller == CONTROLLER_SIM)
 		{
 			actor->Possess(new SimController());
 		}
-		else
+		else if (controller == CONTROLLER_AI)
 		{
 			actor->Possess(new AIController());
 		}
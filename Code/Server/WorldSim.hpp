@@ -3,6 +3,9 @@
 
 #include "Engine/Renderer/Camera.hpp"
 
+#include "Shared/ControllerBase.hpp"
+#include "Shared/EntityTypeRegistry.hpp"
+
 class ActorBase;
 class EntityBase;
 class PlayerController;
@@ -21,6 +24,7 @@ public:
 	void UpdateWorldSim( float deltaSeconds );
 	
 	EntityBase* CreateSimulatedEntity( const std::string& name );
+	EntityBase* CreateSimulatedEntity( EntityTypeId type_id, ControllerKind controller );
 
 private:
 	void ResetWorldSim();
@@ -51,21 +51,8 @@ ActorBase* AIController::FindClosestPlayer()
 	Zone* zone = Zone::GetZone();
 	if( zone )
 	{
-		float closestDist = m_searchRange;
-		EntityBase* toRet = nullptr;
-		for( EntityBase* entity : zone->m_entities )
-		{
-			if( entity && entity->GetName() == "player" )
-			{
-				Vec2 disp = entity->GetPosition() - m_controlled->GetPosition();
-				float dist = disp.GetLength();
-				if( dist < closestDist )
-				{
-					toRet = entity;
-					closestDist = dist;
-				}
-			}
-		}
+		static const EntityTypeId player_type = EntityTypeRegistry::Intern( "player" );
+		EntityBase* toRet = zone->GetSpatialHash().FindNearest( m_controlled->GetPosition(), m_searchRange, player_type, m_controlled );
 		return ( ActorBase* ) toRet;
 	}
 	return nullptr;
@@ -96,3 +83,31 @@ void AIController::AttackPlayerIfCan( ActorBase* player )
 		m_attack_timer->Reset();
 	}
 }
+
+//--------------------------------------------------------------------------
+/**
+* operator new
+*/
+void* AIController::operator new( size_t size )
+{
+	return GetPool().Allocate( size );
+}
+
+//--------------------------------------------------------------------------
+/**
+* operator delete
+*/
+void AIController::operator delete( void* ptr, size_t size )
+{
+	GetPool().Free( ptr, size );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetPool
+*/
+ObjectPool<AIController>& AIController::GetPool()
+{
+	static ObjectPool<AIController> pool;
+	return pool;
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include "Shared/ObjectPool.hpp"
 #include "Shared/ControllerBase.hpp"
 
 class StopWatch;
@@ -10,6 +11,12 @@ public:
 	virtual ~AIController();
 
 	virtual void Update( float deltaTime );
+	virtual ControllerKind GetKind() const { return CONTROLLER_AI; }
+
+	// Allocations come out of the class pool, delete hands them back.
+	static void* operator new( size_t size );
+	static void operator delete( void* ptr, size_t size );
+	static ObjectPool<AIController>& GetPool();
 
 protected:
 	ActorBase* FindClosestPlayer();
@@ -1,6 +1,7 @@
 #include "Shared/AbilityBase.hpp"
 #include "Shared/AbilityBaseDefinition.hpp"
 #include "Shared/ActorBase.hpp"
+#include "Shared/Zone.hpp"
 
 #include "Engine/Physics/Collision2D.hpp"
 
@@ -9,13 +10,28 @@
 * AbilityBase
 */
 AbilityBase::AbilityBase( const std::string& name )
-	: EntityBase( name )
+	: AbilityBase( EntityTypeRegistry::Find( name ) )
 {
-	const AbilityBaseDefinition* def = AbilityBaseDefinition::GetAbilityDefinitionByName(name);
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* AbilityBase
+*/
+AbilityBase::AbilityBase( EntityTypeId type_id )
+	: EntityBase( type_id )
+{
+	const AbilityBaseDefinition* def = AbilityBaseDefinition::GetAbilityDefinition( type_id );
 	m_collider->SetTrigger(def->m_isTrigger);
 	m_life_time = def->m_life_time;
 	m_speed = def->m_speed;
-	m_type = def->m_type;
+	SetType( def->m_type );
+
+	if( IsInEntityStore() )
+	{
+		Zone::GetZone()->GetEntityStore()->SetLifeTime( m_store_handle, m_life_time );
+	}
 }
 
 //--------------------------------------------------------------------------
@@ -34,6 +50,13 @@ AbilityBase::~AbilityBase()
 void AbilityBase::Update(float deltaSeconds)
 {
 	EntityBase::Update(deltaSeconds);
+
+	// Moved and aged by the Zone in one pass over the store instead.
+	if( IsInEntityStore() )
+	{
+		return;
+	}
+
 	m_time_alive += deltaSeconds;
 	if( m_life_time < m_time_alive )
 	{
@@ -50,6 +73,28 @@ void AbilityBase::Update(float deltaSeconds)
 void AbilityBase::SetDirection( const Vec2& dir )
 {
 	m_direction = dir;
+	if( IsInEntityStore() )
+	{
+		Zone::GetZone()->GetEntityStore()->SetVelocity( m_store_handle, m_direction * m_speed );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetVelocity
+*/
+Vec2 AbilityBase::GetVelocity() const
+{
+	return m_direction * m_speed;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetVelocity
+*/
+void AbilityBase::SetVelocity( const Vec2& velocity )
+{
+	SetDirection( m_speed > 0.0f ? velocity * ( 1.0f / m_speed ) : Vec2::ZERO );
 }
 
 //--------------------------------------------------------------------------
@@ -60,3 +105,31 @@ void AbilityBase::SetOwner(ActorBase* owner)
 {
 	m_owner = owner;
 }
+
+//--------------------------------------------------------------------------
+/**
+* operator new
+*/
+void* AbilityBase::operator new( size_t size )
+{
+	return GetPool().Allocate( size );
+}
+
+//--------------------------------------------------------------------------
+/**
+* operator delete
+*/
+void AbilityBase::operator delete( void* ptr, size_t size )
+{
+	GetPool().Free( ptr, size );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetPool
+*/
+ObjectPool<AbilityBase>& AbilityBase::GetPool()
+{
+	static ObjectPool<AbilityBase> pool;
+	return pool;
+}
\ No newline at end of file
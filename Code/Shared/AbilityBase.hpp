@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/Core/EngineCommon.hpp"
+#include "Shared/ObjectPool.hpp"
 #include "Shared/EntityBase.hpp"
 
 class ActorBase;
@@ -9,11 +10,21 @@ class AbilityBase : public EntityBase
 {
 public:
 	AbilityBase( const std::string& name );
+	AbilityBase( EntityTypeId type_id );
 	virtual ~AbilityBase();
 
 	virtual void Update( float deltaSeconds );
+
+	// Allocations come out of the class pool, delete hands them back.
+	static void* operator new( size_t size );
+	static void operator delete( void* ptr, size_t size );
+	static ObjectPool<AbilityBase>& GetPool();
 	
 	void SetDirection( const Vec2& dir );
+
+	// Abilities move themselves at a fixed speed, the velocity is their direction.
+	virtual Vec2 GetVelocity() const;
+	virtual void SetVelocity( const Vec2& velocity );
 	void SetOwner( ActorBase* owner );
 
 	float m_life_time = 0.1f;
@@ -1,6 +1,6 @@
 #include "Shared/AbilityBaseDefinition.hpp"
 
-std::map< std::string, AbilityBaseDefinition* > AbilityBaseDefinition::s_abilityDefs;
+std::vector< AbilityBaseDefinition* > AbilityBaseDefinition::s_abilityDefs;
 
 //--------------------------------------------------------------------------
 /**
@@ -16,6 +16,20 @@ AbilityBaseDefinition::AbilityBaseDefinition(const XmlElement& element)
 	m_type = ENTITY_ABILITY;
 }
 
+//--------------------------------------------------------------------------
+/**
+* AbilityBaseDefinition
+*/
+AbilityBaseDefinition::AbilityBaseDefinition( const definition_cache_ability_t& record, const DefinitionCache& cache )
+	: EntityBaseDefinition( cache.GetString( record.name ) )
+{
+	m_ranged = record.ranged != 0;
+	m_speed = record.speed;
+	m_isTrigger = record.trigger != 0;
+	m_life_time = record.life_time;
+	m_type = ENTITY_ABILITY;
+}
+
 //--------------------------------------------------------------------------
 /**
 * ~AbilityBaseDefinition
@@ -31,21 +45,57 @@ AbilityBaseDefinition::~AbilityBaseDefinition()
 */
 void AbilityBaseDefinition::AddAbilityDefinition( const XmlElement& element )
 {
-	std::string name = ParseXmlAttribute( element, "name", "none" );
-	s_abilityDefs[name] = new AbilityBaseDefinition(element);
+	StoreAbilityDefinition( new AbilityBaseDefinition( element ) );
 }
 
 //--------------------------------------------------------------------------
 /**
-* GetAbilityDefinitionByName
+* AddAbilityDefinition
 */
-const AbilityBaseDefinition* AbilityBaseDefinition::GetAbilityDefinitionByName( const std::string& name )
+void AbilityBaseDefinition::AddAbilityDefinition( const definition_cache_ability_t& record, const DefinitionCache& cache )
 {
-	if( s_abilityDefs.find( name ) != s_abilityDefs.end() )
+	StoreAbilityDefinition( new AbilityBaseDefinition( record, cache ) );
+}
+
+//--------------------------------------------------------------------------
+/**
+* StoreAbilityDefinition
+*/
+void AbilityBaseDefinition::StoreAbilityDefinition( AbilityBaseDefinition* def )
+{
+	if( def->m_type_id >= s_abilityDefs.size() )
 	{
-		return s_abilityDefs[name];
+		s_abilityDefs.resize( def->m_type_id + 1, nullptr );
 	}
-	return nullptr;
+	delete s_abilityDefs[def->m_type_id];
+	s_abilityDefs[def->m_type_id] = def;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetAbilityDefinition
+*/
+const AbilityBaseDefinition* AbilityBaseDefinition::GetAbilityDefinition( EntityTypeId type_id )
+{
+	return type_id < s_abilityDefs.size() ? s_abilityDefs[type_id] : nullptr;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetAbilityDefinitionByName
+*/
+const AbilityBaseDefinition* AbilityBaseDefinition::GetAbilityDefinitionByName( const std::string& name )
+{
+	return GetAbilityDefinition( EntityTypeRegistry::Find( name ) );
+}
+
+//--------------------------------------------------------------------------
+/**
+* DoesDefExist
+*/
+bool AbilityBaseDefinition::DoesDefExist( EntityTypeId type_id )
+{
+	return GetAbilityDefinition( type_id ) != nullptr;
 }
 
 //--------------------------------------------------------------------------
@@ -54,5 +104,5 @@ const AbilityBaseDefinition* AbilityBaseDefinition::GetAbilityDefinitionByName(
 */
 bool AbilityBaseDefinition::DoesDefExist( const std::string& name )
 {
-	return s_abilityDefs.find( name ) != s_abilityDefs.end();
+	return DoesDefExist( EntityTypeRegistry::Find( name ) );
 }
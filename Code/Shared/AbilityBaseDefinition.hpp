@@ -1,27 +1,36 @@
 #pragma once
 
 #include "Shared/EntityBaseDefinition.hpp"
+#include "Shared/DefinitionCache.hpp"
 
-#include <map>
+#include <vector>
 
 class AbilityBaseDefinition
 	: public EntityBaseDefinition
 {
 	friend class AbilityBase;
+	friend class DefinitionCache;
 protected:
 	AbilityBaseDefinition( const XmlElement& element );
+	AbilityBaseDefinition( const definition_cache_ability_t& record, const DefinitionCache& cache );
 	~AbilityBaseDefinition();
 
-	static std::map< std::string, AbilityBaseDefinition* > s_abilityDefs;
+	static void StoreAbilityDefinition( AbilityBaseDefinition* def );
 
-	bool m_ranged;
+	// Indexed by EntityTypeId, null where the id belongs to another kind of definition.
+	static std::vector< AbilityBaseDefinition* > s_abilityDefs;
+
+	bool m_ranged = false;
 	bool m_isTrigger = true;
 	float m_speed = 0.0f;
 	float m_life_time = 0.1f;
 
 public:
 	static void AddAbilityDefinition(const XmlElement& element);
+	static void AddAbilityDefinition( const definition_cache_ability_t& record, const DefinitionCache& cache );
+	static const AbilityBaseDefinition* GetAbilityDefinition( EntityTypeId type_id );
 	static const AbilityBaseDefinition* GetAbilityDefinitionByName( const std::string& name );
+	static bool DoesDefExist( EntityTypeId type_id );
 	static bool DoesDefExist( const std::string& name );
 
 };
\ No newline at end of file
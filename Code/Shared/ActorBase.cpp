@@ -5,8 +5,6 @@
 #include "Shared/ControllerBase.hpp"
 #include "Shared/Zone.hpp"
 
-#include <iostream>
-
 //--------------------------------------------------------------------------
 /**
 * ActorBase
@@ -14,7 +12,7 @@
 ActorBase::ActorBase( const std::string& name )
 	: EntityBase( name )
 {
-	DefineThroughName(name);
+	DefineThroughTypeId();
 }
 
 //--------------------------------------------------------------------------
@@ -25,7 +23,17 @@ ActorBase::ActorBase(const std::string& name, const Vec2& position)
 	: EntityBase( name )
 {
 	m_transform.m_position = position;
-	DefineThroughName(name);
+	DefineThroughTypeId();
+}
+
+//--------------------------------------------------------------------------
+/**
+* ActorBase
+*/
+ActorBase::ActorBase( EntityTypeId type_id )
+	: EntityBase( type_id )
+{
+	DefineThroughTypeId();
 }
 
 //--------------------------------------------------------------------------
@@ -105,7 +113,12 @@ float ActorBase::GetSpeed() const
 */
 void ActorBase::BasicAttack( const Vec2& input_position )
 {
-	if( m_basic_attack == "none" )
+	if( m_basic_attack == INVALID_ENTITY_TYPE_ID )
+	{
+		return;
+	}
+	// Spawning touches the zone and physics system, wait for the commit.
+	if( Zone::DeferIfInPhase( [this, input_position]() { BasicAttack( input_position ); } ) )
 	{
 		return;
 	}
@@ -119,19 +132,45 @@ void ActorBase::BasicAttack( const Vec2& input_position )
 
 //--------------------------------------------------------------------------
 /**
-* DefineThroughName
+* DefineThroughTypeId
 */
-void ActorBase::DefineThroughName(const std::string& name)
+void ActorBase::DefineThroughTypeId()
 {
-	const ActorBaseDefinition* def = ActorBaseDefinition::GetActorDefinitionByName(name);
-	std::cout << "Actor base" << std::endl;
+	const ActorBaseDefinition* def = ActorBaseDefinition::GetActorDefinition( m_type_id );
 	if (def)
 	{
-		std::cout << "Def found" << std::endl;
-		m_basic_attack = def->m_basic_attack;
+		m_basic_attack = def->m_basic_attack_id;
 		m_possessable = def->m_possessable;
 		m_speed = def->m_speed;
 
-		m_type = def->m_type;
+		SetType( def->m_type );
 	}
 }
+
+//--------------------------------------------------------------------------
+/**
+* operator new
+*/
+void* ActorBase::operator new( size_t size )
+{
+	return GetPool().Allocate( size );
+}
+
+//--------------------------------------------------------------------------
+/**
+* operator delete
+*/
+void ActorBase::operator delete( void* ptr, size_t size )
+{
+	GetPool().Free( ptr, size );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetPool
+*/
+ObjectPool<ActorBase>& ActorBase::GetPool()
+{
+	static ObjectPool<ActorBase> pool;
+	return pool;
+}
\ No newline at end of file
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "Engine/Core/EngineCommon.hpp"
+#include "Shared/ObjectPool.hpp"
 #include "Shared/EntityBase.hpp"
 
 class ControllerBase;
@@ -10,10 +11,16 @@ class ActorBase : public EntityBase
 public:
 	ActorBase( const std::string& name );
 	ActorBase( const std::string& name, const Vec2& position );
+	ActorBase( EntityTypeId type_id );
 	virtual ~ActorBase();
 
 	virtual void Update( float deltaTime );
 
+	// Allocations come out of the class pool, delete hands them back.
+	static void* operator new( size_t size );
+	static void operator delete( void* ptr, size_t size );
+	static ObjectPool<ActorBase>& GetPool();
+
 public:
 	void PreformAbility( const std::string& ability_name, const Vec2& target_position );
 	bool Possess( ControllerBase* controller );
@@ -26,7 +33,7 @@ protected:
 	void BasicAttack( const Vec2& input_position );
 
 protected:
-	std::string m_basic_attack = "none";
+	EntityTypeId m_basic_attack = INVALID_ENTITY_TYPE_ID;
 	bool m_possessable = false;
 	ControllerBase* m_owner = nullptr;
 
@@ -34,6 +41,6 @@ protected:
 
 private:
 	// Used through creation
-	void DefineThroughName( const std::string& name );
+	void DefineThroughTypeId();
 
 };
\ No newline at end of file
@@ -2,9 +2,9 @@
 
 #include "Engine/Core/EngineCommon.hpp"
 
-std::map< std::string, ActorBaseDefinition* > ActorBaseDefinition::s_actorDefs;
+#include "Shared/AsyncLog.hpp"
 
-#include <iostream>
+std::vector< ActorBaseDefinition* > ActorBaseDefinition::s_actorDefs;
 
 //--------------------------------------------------------------------------
 /**
@@ -14,11 +14,33 @@ ActorBaseDefinition::ActorBaseDefinition(const XmlElement& element)
 	: EntityBaseDefinition( element )
 {
 	m_basic_attack = ParseXmlAttribute( element, "basic_attack", m_basic_attack );
+	if( m_basic_attack != "none" )
+	{
+		// The ability may not be loaded yet, interning reserves its id either way.
+		m_basic_attack_id = EntityTypeRegistry::Intern( m_basic_attack );
+	}
 	m_possessable = ParseXmlAttribute( element, "possess", m_possessable );
 	m_speed = ParseXmlAttribute( element, "speed", m_speed );
 	m_type = ENTITY_ACTOR;
 }
 
+//--------------------------------------------------------------------------
+/**
+* ActorBaseDefinition
+*/
+ActorBaseDefinition::ActorBaseDefinition( const definition_cache_actor_t& record, const DefinitionCache& cache )
+	: EntityBaseDefinition( cache.GetString( record.name ) )
+{
+	m_basic_attack = cache.GetString( record.basic_attack );
+	if( m_basic_attack != "none" )
+	{
+		m_basic_attack_id = EntityTypeRegistry::Intern( m_basic_attack );
+	}
+	m_possessable = record.possessable != 0;
+	m_speed = record.speed;
+	m_type = ENTITY_ACTOR;
+}
+
 //--------------------------------------------------------------------------
 /**
 * ~ActorBaseDefinition
@@ -34,8 +56,39 @@ ActorBaseDefinition::~ActorBaseDefinition()
 */
 void ActorBaseDefinition::AddActorDefinition(const XmlElement& element)
 {
-	std::string name = ParseXmlAttribute( element, "name", "none" );
-	s_actorDefs[name] = new ActorBaseDefinition( element );
+	StoreActorDefinition( new ActorBaseDefinition( element ) );
+}
+
+//--------------------------------------------------------------------------
+/**
+* AddActorDefinition
+*/
+void ActorBaseDefinition::AddActorDefinition( const definition_cache_actor_t& record, const DefinitionCache& cache )
+{
+	StoreActorDefinition( new ActorBaseDefinition( record, cache ) );
+}
+
+//--------------------------------------------------------------------------
+/**
+* StoreActorDefinition
+*/
+void ActorBaseDefinition::StoreActorDefinition( ActorBaseDefinition* def )
+{
+	if( def->m_type_id >= s_actorDefs.size() )
+	{
+		s_actorDefs.resize( def->m_type_id + 1, nullptr );
+	}
+	delete s_actorDefs[def->m_type_id];
+	s_actorDefs[def->m_type_id] = def;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetActorDefinition
+*/
+const ActorBaseDefinition* ActorBaseDefinition::GetActorDefinition( EntityTypeId type_id )
+{
+	return type_id < s_actorDefs.size() ? s_actorDefs[type_id] : nullptr;
 }
 
 //--------------------------------------------------------------------------
@@ -44,13 +97,21 @@ void ActorBaseDefinition::AddActorDefinition(const XmlElement& element)
 */
 const ActorBaseDefinition* ActorBaseDefinition::GetActorDefinitionByName( const std::string& name )
 {
-	if( s_actorDefs.find( name ) != s_actorDefs.end() )
+	const ActorBaseDefinition* def = GetActorDefinition( EntityTypeRegistry::Find( name ) );
+	if( !def )
 	{
-		std::cout << "found a def" << std::endl;
-		return s_actorDefs[name];
+		LOG_WARNING( "Actor", "No definition for %s", name.c_str() );
 	}
-	std::cout << "didn't find a def" << std::endl;
-	return nullptr;
+	return def;
+}
+
+//--------------------------------------------------------------------------
+/**
+* DoesDefExist
+*/
+bool ActorBaseDefinition::DoesDefExist( EntityTypeId type_id )
+{
+	return GetActorDefinition( type_id ) != nullptr;
 }
 
 //--------------------------------------------------------------------------
@@ -59,5 +120,5 @@ const ActorBaseDefinition* ActorBaseDefinition::GetActorDefinitionByName( const
 */
 bool ActorBaseDefinition::DoesDefExist(const std::string& name)
 {
-	return s_actorDefs.find( name ) != s_actorDefs.end();
+	return DoesDefExist( EntityTypeRegistry::Find( name ) );
 }
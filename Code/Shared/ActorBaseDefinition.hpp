@@ -1,27 +1,37 @@
 #pragma once
 #include "Shared/EntityBaseDefinition.hpp"
+#include "Shared/DefinitionCache.hpp"
 
-#include <map>
+#include <vector>
 
 class ActorBaseDefinition
 	: public EntityBaseDefinition
 {
 	friend class ActorBase;
 	friend class AIController;
+	friend class DefinitionCache;
 protected:
 	ActorBaseDefinition( const XmlElement& element );
+	ActorBaseDefinition( const definition_cache_actor_t& record, const DefinitionCache& cache );
 	~ActorBaseDefinition();
 
-	static std::map< std::string, ActorBaseDefinition* > s_actorDefs;
+	static void StoreActorDefinition( ActorBaseDefinition* def );
+
+	// Indexed by EntityTypeId, null where the id belongs to another kind of definition.
+	static std::vector< ActorBaseDefinition* > s_actorDefs;
 	
 	std::string m_basic_attack = "none";
+	EntityTypeId m_basic_attack_id = INVALID_ENTITY_TYPE_ID;
 	bool m_possessable = false;
 
 	float m_speed = 0.0f;
 
 public:
 	static void AddActorDefinition(const XmlElement& element);
+	static void AddActorDefinition( const definition_cache_actor_t& record, const DefinitionCache& cache );
+	static const ActorBaseDefinition* GetActorDefinition( EntityTypeId type_id );
 	static const ActorBaseDefinition* GetActorDefinitionByName( const std::string& name );
+	static bool DoesDefExist( EntityTypeId type_id );
 	static bool DoesDefExist( const std::string& name );
 
 };
\ No newline at end of file
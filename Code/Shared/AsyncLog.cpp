@@ -0,0 +1,205 @@
+#include "Shared/AsyncLog.hpp"
+
+#include <chrono>
+#include <cstdarg>
+#include <cstdio>
+#include <cstring>
+
+static const std::chrono::milliseconds kIdleSleep( 2 );
+static const char* const kLevelNames[] = { "DEBUG", "INFO", "WARNING", "ERROR" };
+
+std::atomic<LogLevel> AsyncLog::s_level{ LOG_LEVEL_DEBUG };
+std::atomic<bool> AsyncLog::s_running{ false };
+std::atomic<uint64_t> AsyncLog::s_dropped{ 0 };
+std::thread AsyncLog::s_drain_thread;
+std::vector<AsyncLog::log_record_t> AsyncLog::s_records;
+size_t AsyncLog::s_mask = 0;
+std::atomic<size_t> AsyncLog::s_tail{ 0 };
+size_t AsyncLog::s_head = 0;
+
+//--------------------------------------------------------------------------
+/**
+* Startup
+*/
+void AsyncLog::Startup( size_t capacity )
+{
+	if( s_running )
+	{
+		return;
+	}
+
+	size_t size = 2;
+	while( size < capacity )
+	{
+		size <<= 1;
+	}
+	std::vector<log_record_t> records( size );
+	for( size_t idx = 0; idx < size; ++idx )
+	{
+		records[idx].sequence.store( idx, std::memory_order_relaxed );
+	}
+	s_records.swap( records );
+	s_mask = size - 1;
+	s_tail = 0;
+	s_head = 0;
+
+	s_running = true;
+	s_drain_thread = std::thread( DrainLoop );
+}
+
+//--------------------------------------------------------------------------
+/**
+* Shutdown
+* Whatever made it into the ring still gets written.
+*/
+void AsyncLog::Shutdown()
+{
+	if( !s_running )
+	{
+		return;
+	}
+
+	s_running = false;
+	s_drain_thread.join();
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetLevel
+*/
+void AsyncLog::SetLevel( LogLevel level )
+{
+	s_level = level;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Write
+* Claims a slot, formats into it, then publishes it to the drain thread.
+*/
+void AsyncLog::Write( LogLevel level, const char* category, const char* format, ... )
+{
+	va_list args;
+	va_start( args, format );
+
+	if( !s_running )
+	{
+		char text[LINE_SIZE];
+		vsnprintf( text, sizeof( text ), format, args );
+		va_end( args );
+		WriteRecord( level, category, text );
+		return;
+	}
+
+	log_record_t* record = nullptr;
+	size_t position = s_tail.load( std::memory_order_relaxed );
+	for( ;; )
+	{
+		log_record_t& candidate = s_records[position & s_mask];
+		intptr_t difference = (intptr_t)candidate.sequence.load( std::memory_order_acquire ) - (intptr_t)position;
+		if( difference == 0 )
+		{
+			if( s_tail.compare_exchange_weak( position, position + 1, std::memory_order_relaxed ) )
+			{
+				record = &candidate;
+				break;
+			}
+		}
+		else if( difference < 0 )
+		{
+			// Still holds a line the drain thread hasn't written.
+			++s_dropped;
+			va_end( args );
+			return;
+		}
+		else
+		{
+			position = s_tail.load( std::memory_order_relaxed );
+		}
+	}
+
+	record->level = level;
+	strncpy( record->category, category, CATEGORY_SIZE - 1 );
+	record->category[CATEGORY_SIZE - 1] = '\0';
+	vsnprintf( record->text, LINE_SIZE, format, args );
+	va_end( args );
+
+	record->sequence.store( position + 1, std::memory_order_release );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetDroppedCount
+*/
+uint64_t AsyncLog::GetDroppedCount()
+{
+	return s_dropped;
+}
+
+//--------------------------------------------------------------------------
+/**
+* DrainLoop
+*/
+void AsyncLog::DrainLoop()
+{
+	uint64_t reported_dropped = 0;
+	while( s_running )
+	{
+		bool wrote = Drain();
+
+		uint64_t dropped = s_dropped;
+		if( dropped != reported_dropped )
+		{
+			fprintf( stdout, "[WARNING][Log] dropped %llu lines, %llu in total\n",
+				(unsigned long long)( dropped - reported_dropped ), (unsigned long long)dropped );
+			reported_dropped = dropped;
+			wrote = true;
+		}
+
+		if( wrote )
+		{
+			fflush( stdout );
+		}
+		else
+		{
+			std::this_thread::sleep_for( kIdleSleep );
+		}
+	}
+
+	// A line still being formatted by a thread that raced Shutdown is lost.
+	Drain();
+	fflush( stdout );
+}
+
+//--------------------------------------------------------------------------
+/**
+* Drain
+* Writes every published line in order, stops at the first one still being formatted.
+*/
+bool AsyncLog::Drain()
+{
+	bool wrote = false;
+	for( ;; )
+	{
+		log_record_t& record = s_records[s_head & s_mask];
+		if( record.sequence.load( std::memory_order_acquire ) != s_head + 1 )
+		{
+			return wrote;
+		}
+
+		WriteRecord( record.level, record.category, record.text );
+		record.sequence.store( s_head + s_mask + 1, std::memory_order_release );
+		++s_head;
+		wrote = true;
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* WriteRecord
+*/
+void AsyncLog::WriteRecord( LogLevel level, const char* category, const char* text )
+{
+	const char* level_name = level < LOG_LEVEL_OFF ? kLevelNames[level] : "";
+	fprintf( stdout, "[%s][%s] %s\n", level_name, category, text );
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+enum LogLevel
+{
+	LOG_LEVEL_DEBUG,
+	LOG_LEVEL_INFO,
+	LOG_LEVEL_WARNING,
+	LOG_LEVEL_ERROR,
+	LOG_LEVEL_OFF
+};
+
+// Anything below this is compiled out. Release builds keep info and up unless the build says otherwise.
+#ifndef LOG_COMPILED_LEVEL
+	#ifdef NDEBUG
+		#define LOG_COMPILED_LEVEL LOG_LEVEL_INFO
+	#else
+		#define LOG_COMPILED_LEVEL LOG_LEVEL_DEBUG
+	#endif
+#endif
+
+// printf style, the category is a short tag like "Server" or "View".
+#define LOG_AT_LEVEL( level, category, ... ) \
+	do { if( (level) >= LOG_COMPILED_LEVEL && AsyncLog::IsEnabled( level ) ) { AsyncLog::Write( level, category, __VA_ARGS__ ); } } while( 0 )
+
+#define LOG_DEBUG( category, ... )		LOG_AT_LEVEL( LOG_LEVEL_DEBUG, category, __VA_ARGS__ )
+#define LOG_INFO( category, ... )		LOG_AT_LEVEL( LOG_LEVEL_INFO, category, __VA_ARGS__ )
+#define LOG_WARNING( category, ... )	LOG_AT_LEVEL( LOG_LEVEL_WARNING, category, __VA_ARGS__ )
+#define LOG_ERROR( category, ... )		LOG_AT_LEVEL( LOG_LEVEL_ERROR, category, __VA_ARGS__ )
+
+//--------------------------------------------------------------------------
+// Log lines are formatted by whichever thread logs them, straight into a slot of a
+// bounded lock-free ring, and written to stdout by a background thread that only
+// flushes once the ring is drained. A full ring drops the line and counts it rather
+// than making the caller wait, the count is reported in the output and by GetDroppedCount.
+// Before Startup and after Shutdown lines are written straight to stdout.
+//--------------------------------------------------------------------------
+class AsyncLog
+{
+public:
+	static constexpr size_t LINE_SIZE = 232;
+	static constexpr size_t CATEGORY_SIZE = 16;
+
+public:
+	// Capacity is in lines and rounded up to a power of two.
+	static void Startup( size_t capacity = 4096 );
+	static void Shutdown();
+
+	// Runtime filter on top of LOG_COMPILED_LEVEL.
+	static void SetLevel( LogLevel level );
+	static bool IsEnabled( LogLevel level )		{ return level >= s_level.load( std::memory_order_relaxed ); }
+
+	static void Write( LogLevel level, const char* category, const char* format, ... )
+#if defined( __GNUC__ )
+		__attribute__( ( format( printf, 3, 4 ) ) )
+#endif
+		;
+
+	static uint64_t GetDroppedCount();
+
+private:
+	struct log_record_t
+	{
+		std::atomic<size_t> sequence{ 0 };
+		LogLevel level = LOG_LEVEL_INFO;
+		char category[CATEGORY_SIZE];
+		char text[LINE_SIZE];
+	};
+
+	static void DrainLoop();
+	static bool Drain();
+	static void WriteRecord( LogLevel level, const char* category, const char* text );
+
+private:
+	static std::atomic<LogLevel> s_level;
+	static std::atomic<bool> s_running;
+	static std::atomic<uint64_t> s_dropped;
+	static std::thread s_drain_thread;
+
+	// Ring, producers claim with s_tail and the drain thread follows with s_head.
+	static std::vector<log_record_t> s_records;
+	static size_t s_mask;
+	static std::atomic<size_t> s_tail;
+	static size_t s_head;
+};
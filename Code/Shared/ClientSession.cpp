@@ -0,0 +1,149 @@
+#include "Shared/ClientSession.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+//--------------------------------------------------------------------------
+/**
+* ClientSession
+*/
+ClientSession::ClientSession( WorkerConnection& connection, WorkerDispatcher& dispatcher )
+	: m_connection( connection )
+{
+	dispatcher.OnEntityQueryResponse( [this]( const entity_query_response_t& op ) {
+		if( op.request_id != m_api_query_request_id || op.entity_ids.empty() )
+		{
+			return;
+		}
+		m_api_entity_id = op.entity_ids.front();
+		m_has_api_entity = true;
+		if( on_api_found )
+		{
+			on_api_found( m_api_entity_id );
+		}
+		});
+
+	dispatcher.OnCreateClientEntityResponse( [this]( const command_response_t<CreateClientEntity>& op ) {
+		bool success = op.status_code == worker::StatusCode::kSuccess && op.response;
+		if( on_client_entity_created )
+		{
+			on_client_entity_created( op.request_id, success, success ? op.response->id_created() : 0 );
+		}
+		});
+
+	dispatcher.OnClientPingResponse( [this]( const command_response_t<ClientPing>& op ) {
+		if( !m_ping_pending || op.request_id != m_ping_request_id )
+		{
+			return;
+		}
+		m_ping_pending = false;
+		if( op.status_code != worker::StatusCode::kSuccess )
+		{
+			++m_ping_stats.failed;
+			return;
+		}
+		AddPingSample( std::chrono::duration<double>( std::chrono::steady_clock::now() - m_ping_sent ).count() );
+		});
+}
+
+//--------------------------------------------------------------------------
+/**
+* FindAPIEntity
+*/
+void ClientSession::FindAPIEntity()
+{
+	m_api_query_request_id = m_connection.SendEntityQueryRequest( siren::ServerAPI::ComponentId );
+}
+
+//--------------------------------------------------------------------------
+/**
+* RequestClientEntity
+*/
+worker::Option<uint64_t> ClientSession::RequestClientEntity()
+{
+	if( !m_has_api_entity )
+	{
+		return {};
+	}
+	return m_connection.SendCommandRequest( m_api_entity_id, CreateClientEntity::Request() );
+}
+
+//--------------------------------------------------------------------------
+/**
+* RequestClientEntityDeletion
+*/
+void ClientSession::RequestClientEntityDeletion( worker::EntityId entity_id )
+{
+	if( !m_has_api_entity )
+	{
+		return;
+	}
+	DeleteClientEntity::Request request;
+	request.set_id_to_delete( entity_id );
+	m_connection.SendCommandRequest( m_api_entity_id, request );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendPlayerControls
+*/
+uint32_t ClientSession::SendPlayerControls( worker::EntityId entity_id, const Vec2& move )
+{
+	siren::PlayerControls::Update update;
+	update.set_x_move( move.x );
+	update.set_y_move( move.y );
+	update.set_sequence( ++m_controls_sequence );
+	m_connection.SendComponentUpdate( entity_id, update );
+	return m_controls_sequence;
+}
+
+//--------------------------------------------------------------------------
+/**
+* UpdatePing
+*/
+void ClientSession::UpdatePing( worker::EntityId client_entity_id )
+{
+	std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+	if( !m_has_api_entity || m_ping_pending || std::chrono::duration<double>( now - m_ping_sent ).count() < m_ping_interval )
+	{
+		return;
+	}
+
+	ClientPing::Request request;
+	request.set_client_entity_id( client_entity_id );
+	request.set_rtt_ms( (float)( 1000.0 * m_ping_stats.smoothed_rtt_seconds ) );
+	request.set_jitter_ms( (float)( 1000.0 * m_ping_stats.jitter_seconds ) );
+	worker::Option<uint64_t> request_id = m_connection.SendCommandRequest( m_api_entity_id, request );
+	m_ping_sent = now;
+	if( request_id )
+	{
+		m_ping_request_id = *request_id;
+		m_ping_pending = true;
+		++m_ping_stats.sent;
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* AddPingSample
+* Smoothed the way RTP and TCP do it.
+*/
+void ClientSession::AddPingSample( double rtt_seconds )
+{
+	client_ping_stats_t& stats = m_ping_stats;
+	if( stats.received == 0 )
+	{
+		stats.smoothed_rtt_seconds = rtt_seconds;
+		stats.min_rtt_seconds = rtt_seconds;
+		stats.max_rtt_seconds = rtt_seconds;
+	}
+	else
+	{
+		stats.jitter_seconds += ( std::abs( rtt_seconds - stats.last_rtt_seconds ) - stats.jitter_seconds ) / 16.0;
+		stats.smoothed_rtt_seconds += ( rtt_seconds - stats.smoothed_rtt_seconds ) / 8.0;
+		stats.min_rtt_seconds = std::min( stats.min_rtt_seconds, rtt_seconds );
+		stats.max_rtt_seconds = std::max( stats.max_rtt_seconds, rtt_seconds );
+	}
+	stats.last_rtt_seconds = rtt_seconds;
+	++stats.received;
+}
@@ -0,0 +1,77 @@
+#pragma once
+#include "Shared/WorkerConnection.hpp"
+
+#include "Engine/Math/Vec2.hpp"
+
+#include <chrono>
+#include <functional>
+
+struct client_ping_stats_t
+{
+	uint64_t sent = 0;
+	uint64_t received = 0;
+	uint64_t failed = 0;				// Timed out or refused by the server.
+	double last_rtt_seconds = 0.0;
+	double smoothed_rtt_seconds = 0.0;	// Moving average, an eighth of each new sample.
+	double jitter_seconds = 0.0;		// Smoothed change between consecutive RTTs, a sixteenth of each new sample.
+	double min_rtt_seconds = 0.0;
+	double max_rtt_seconds = 0.0;
+};
+
+//--------------------------------------------------------------------------
+// The External worker's side of joining the game, shared by the Game client and the bots:
+// find the API entity, ask it for a player with CreateClientEntity, send PlayerControls,
+// and DeleteClientEntity on the way out. While playing it pings the server with ClientPing,
+// which measures round trips and keeps the player from being evicted as idle.
+// Takes over the dispatcher's entity query and ServerAPI response callbacks.
+//--------------------------------------------------------------------------
+class ClientSession
+{
+public:
+	ClientSession( WorkerConnection& connection, WorkerDispatcher& dispatcher );
+	~ClientSession() {};
+
+	ClientSession( const ClientSession& ) = delete;
+	ClientSession& operator=( const ClientSession& ) = delete;
+
+public:
+	// on_api_found runs once the query comes back with an API entity.
+	void FindAPIEntity();
+	bool HasAPIEntity() const							{ return m_has_api_entity; }
+	worker::EntityId GetAPIEntityId() const				{ return m_api_entity_id; }
+
+	// Request id to match against on_client_entity_created, empty if it couldn't be sent.
+	worker::Option<uint64_t> RequestClientEntity();
+	void RequestClientEntityDeletion( worker::EntityId entity_id );
+
+	// Returns the sequence the update went out with, the server echoes it back in PlayerMovement.
+	uint32_t SendPlayerControls( worker::EntityId entity_id, const Vec2& move );
+
+	// Sends a ClientPing for the player once ping_interval has passed and the last one came back.
+	void UpdatePing( worker::EntityId client_entity_id );
+	void SetPingInterval( double seconds )				{ m_ping_interval = seconds; }
+	const client_ping_stats_t& GetPingStats() const		{ return m_ping_stats; }
+
+private:
+	void AddPingSample( double rtt_seconds );
+
+public:
+	std::function<void( worker::EntityId api_entity_id )> on_api_found;
+	std::function<void( uint64_t request_id, bool success, worker::EntityId created_id )> on_client_entity_created;
+
+private:
+	WorkerConnection& m_connection;
+
+	uint64_t m_api_query_request_id = 0;
+	bool m_has_api_entity = false;
+	worker::EntityId m_api_entity_id = 0;
+	uint32_t m_controls_sequence = 0;
+
+	// One ping in flight at a time, the command timeout bounds how long it's waited on.
+	double m_ping_interval = 1.0;
+	bool m_ping_pending = false;
+	uint64_t m_ping_request_id = 0;
+	std::chrono::steady_clock::time_point m_ping_sent;
+	client_ping_stats_t m_ping_stats;
+
+};
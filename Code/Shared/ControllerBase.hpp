@@ -1,8 +1,16 @@
 #pragma once
-
+#include <cstdint>
 
 class ActorBase;
 
+// Which controller an actor runs under, for rebuilding it without the controller itself.
+enum ControllerKind : uint8_t
+{
+	CONTROLLER_NONE,
+	CONTROLLER_SIM,
+	CONTROLLER_AI
+};
+
 class ControllerBase
 {
 	friend class ActorBase;
@@ -11,6 +19,7 @@ public:
 	virtual ~ControllerBase();
 
 	virtual void Update( float deltaTime ) = 0;
+	virtual ControllerKind GetKind() const { return CONTROLLER_NONE; }
 	ActorBase* GetActor() { return m_controlled; };
 
 protected:
@@ -0,0 +1,244 @@
+#include "Shared/DefinitionCache.hpp"
+
+#include "Shared/AbilityBaseDefinition.hpp"
+#include "Shared/ActorBaseDefinition.hpp"
+#include "Shared/AsyncLog.hpp"
+
+#include <cstdio>
+#include <cstring>
+#include <type_traits>
+#include <unordered_map>
+#include <vector>
+
+static const char kDefinitionCacheMagic[4] = { 'D', 'E', 'F', 'C' };
+
+static_assert( std::is_trivially_copyable<definition_cache_ability_t>::value, "Cache records are read in place" );
+static_assert( std::is_trivially_copyable<definition_cache_actor_t>::value, "Cache records are read in place" );
+static_assert( sizeof( definition_cache_header_t ) % alignof( definition_cache_ability_t ) == 0, "Records after the header must stay aligned" );
+static_assert( sizeof( definition_cache_ability_t ) % alignof( definition_cache_actor_t ) == 0, "Records after the abilities must stay aligned" );
+
+//--------------------------------------------------------------------------
+// Builds the string table, each distinct string stored once.
+//--------------------------------------------------------------------------
+class DefinitionCacheStrings
+{
+public:
+	uint32_t Add( const std::string& value )
+	{
+		auto found = m_offsets.find( value );
+		if( found != m_offsets.end() )
+		{
+			return found->second;
+		}
+		uint32_t offset = (uint32_t)m_data.size();
+		m_data.insert( m_data.end(), value.c_str(), value.c_str() + value.size() + 1 );
+		m_offsets.emplace( value, offset );
+		return offset;
+	}
+
+	const std::vector<char>& GetData() const { return m_data; }
+
+private:
+	std::vector<char> m_data;
+	std::unordered_map<std::string, uint32_t> m_offsets;
+};
+
+//--------------------------------------------------------------------------
+/**
+* GetSource
+*/
+bool DefinitionCache::GetSource( const std::string& xml_path, definition_cache_source_t& source )
+{
+	FILE* file = fopen( xml_path.c_str(), "rb" );
+	if( !file )
+	{
+		return false;
+	}
+
+	// FNV-1a, 64 bit.
+	uint64_t hash = 14695981039346656037ull;
+	uint64_t size = 0;
+	unsigned char buffer[4096];
+	size_t read;
+	while( ( read = fread( buffer, 1, sizeof( buffer ), file ) ) > 0 )
+	{
+		for( size_t idx = 0; idx < read; ++idx )
+		{
+			hash ^= buffer[idx];
+			hash *= 1099511628211ull;
+		}
+		size += read;
+	}
+	bool failed = ferror( file ) != 0;
+	fclose( file );
+	if( failed )
+	{
+		return false;
+	}
+
+	source.size = size;
+	source.content_hash = hash;
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Write
+*/
+bool DefinitionCache::Write( const std::string& path, const definition_cache_source_t& abilities_source, const definition_cache_source_t& actors_source )
+{
+	DefinitionCacheStrings strings;
+
+	std::vector<definition_cache_ability_t> abilities;
+	for( const AbilityBaseDefinition* def : AbilityBaseDefinition::s_abilityDefs )
+	{
+		if( !def )
+		{
+			continue;
+		}
+		definition_cache_ability_t record = {};
+		record.name = strings.Add( def->m_name );
+		record.speed = def->m_speed;
+		record.life_time = def->m_life_time;
+		record.ranged = def->m_ranged ? 1 : 0;
+		record.trigger = def->m_isTrigger ? 1 : 0;
+		abilities.push_back( record );
+	}
+
+	std::vector<definition_cache_actor_t> actors;
+	for( const ActorBaseDefinition* def : ActorBaseDefinition::s_actorDefs )
+	{
+		if( !def )
+		{
+			continue;
+		}
+		definition_cache_actor_t record = {};
+		record.name = strings.Add( def->m_name );
+		record.basic_attack = strings.Add( def->m_basic_attack );
+		record.speed = def->m_speed;
+		record.possessable = def->m_possessable ? 1 : 0;
+		actors.push_back( record );
+	}
+
+	const std::vector<char>& string_data = strings.GetData();
+
+	definition_cache_header_t header = {};
+	memcpy( header.magic, kDefinitionCacheMagic, sizeof( header.magic ) );
+	header.version = DEFINITION_CACHE_VERSION;
+	header.ability_size = sizeof( definition_cache_ability_t );
+	header.actor_size = sizeof( definition_cache_actor_t );
+	header.abilities_source = abilities_source;
+	header.actors_source = actors_source;
+	header.ability_count = (uint32_t)abilities.size();
+	header.actor_count = (uint32_t)actors.size();
+	header.abilities_offset = sizeof( header );
+	header.actors_offset = header.abilities_offset + abilities.size() * sizeof( definition_cache_ability_t );
+	header.strings_offset = header.actors_offset + actors.size() * sizeof( definition_cache_actor_t );
+	header.strings_size = string_data.size();
+
+	std::string temp_path = path + ".tmp";
+	FILE* file = fopen( temp_path.c_str(), "wb" );
+	if( !file )
+	{
+		LOG_ERROR( "Definitions", "Couldn't open %s for writing", temp_path.c_str() );
+		return false;
+	}
+	bool written = fwrite( &header, sizeof( header ), 1, file ) == 1
+		&& fwrite( abilities.data(), sizeof( definition_cache_ability_t ), abilities.size(), file ) == abilities.size()
+		&& fwrite( actors.data(), sizeof( definition_cache_actor_t ), actors.size(), file ) == actors.size()
+		&& fwrite( string_data.data(), 1, string_data.size(), file ) == string_data.size();
+	written = fclose( file ) == 0 && written;
+
+	// A worker starting mid build maps either the old cache or the new one.
+	if( !written || !MappedFile::MoveOver( temp_path, path ) )
+	{
+		LOG_ERROR( "Definitions", "Couldn't write %s", path.c_str() );
+		remove( temp_path.c_str() );
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Open
+*/
+bool DefinitionCache::Open( const std::string& path )
+{
+	Close();
+	if( !m_file.Open( path ) )
+	{
+		return false;
+	}
+
+	const uint8_t* data = m_file.GetData();
+	size_t size = m_file.GetSize();
+	const definition_cache_header_t* header = (const definition_cache_header_t*)data;
+	bool valid = size >= sizeof( definition_cache_header_t )
+		&& memcmp( header->magic, kDefinitionCacheMagic, sizeof( header->magic ) ) == 0
+		&& header->version == DEFINITION_CACHE_VERSION
+		&& header->ability_size == sizeof( definition_cache_ability_t )
+		&& header->actor_size == sizeof( definition_cache_actor_t )
+		&& header->abilities_offset % alignof( definition_cache_ability_t ) == 0
+		&& header->actors_offset % alignof( definition_cache_actor_t ) == 0
+		&& header->abilities_offset + (uint64_t)header->ability_count * sizeof( definition_cache_ability_t ) <= size
+		&& header->actors_offset + (uint64_t)header->actor_count * sizeof( definition_cache_actor_t ) <= size
+		&& header->strings_offset + header->strings_size <= size
+		&& header->strings_size > 0
+		&& data[header->strings_offset + header->strings_size - 1] == '\0';
+
+	// Every string offset has to land in the table, the table ending in a null
+	// keeps each string inside it.
+	if( valid )
+	{
+		const definition_cache_ability_t* abilities = (const definition_cache_ability_t*)( data + header->abilities_offset );
+		for( uint32_t idx = 0; idx < header->ability_count && valid; ++idx )
+		{
+			valid = abilities[idx].name < header->strings_size;
+		}
+		const definition_cache_actor_t* actors = (const definition_cache_actor_t*)( data + header->actors_offset );
+		for( uint32_t idx = 0; idx < header->actor_count && valid; ++idx )
+		{
+			valid = actors[idx].name < header->strings_size && actors[idx].basic_attack < header->strings_size;
+		}
+	}
+
+	if( !valid )
+	{
+		LOG_WARNING( "Definitions", "%s isn't a version %u definition cache", path.c_str(), DEFINITION_CACHE_VERSION );
+		Close();
+		return false;
+	}
+
+	m_header = header;
+	m_abilities = (const definition_cache_ability_t*)( data + header->abilities_offset );
+	m_actors = (const definition_cache_actor_t*)( data + header->actors_offset );
+	m_strings = (const char*)( data + header->strings_offset );
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Close
+*/
+void DefinitionCache::Close()
+{
+	m_file.Close();
+	m_header = nullptr;
+	m_abilities = nullptr;
+	m_actors = nullptr;
+	m_strings = nullptr;
+}
+
+//--------------------------------------------------------------------------
+/**
+* IsCurrent
+*/
+bool DefinitionCache::IsCurrent( const definition_cache_source_t& abilities_source, const definition_cache_source_t& actors_source ) const
+{
+	return m_header
+		&& m_header->abilities_source.size == abilities_source.size
+		&& m_header->abilities_source.content_hash == abilities_source.content_hash
+		&& m_header->actors_source.size == actors_source.size
+		&& m_header->actors_source.content_hash == actors_source.content_hash;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#include "Shared/MappedFile.hpp"
+
+#include <cstdint>
+#include <string>
+
+constexpr uint32_t DEFINITION_CACHE_VERSION = 2;
+
+// Size and FNV-1a hash of a definition XML's bytes, the cache is stale once either changes.
+// Content rather than write time, so a checkout or copy that touches the file doesn't stale it.
+struct definition_cache_source_t
+{
+	uint64_t size;
+	uint64_t content_hash;
+};
+
+//--------------------------------------------------------------------------
+// Layout on disk, native byte order like the world checkpoint. The header is
+// followed by the ability records, the actor records, then the string table the
+// records point into. Abilities come first since actors name their basic attack.
+//--------------------------------------------------------------------------
+struct definition_cache_header_t
+{
+	char magic[4];
+	uint32_t version;
+	uint32_t ability_size;			// sizeof(definition_cache_ability_t) when written.
+	uint32_t actor_size;			// sizeof(definition_cache_actor_t) when written.
+	definition_cache_source_t abilities_source;
+	definition_cache_source_t actors_source;
+	uint32_t ability_count;
+	uint32_t actor_count;
+	uint64_t abilities_offset;
+	uint64_t actors_offset;
+	uint64_t strings_offset;
+	uint64_t strings_size;
+};
+
+// Strings are offsets into the string table, each null terminated.
+struct definition_cache_ability_t
+{
+	uint32_t name;
+	float speed;
+	float life_time;
+	uint8_t ranged;
+	uint8_t trigger;
+	uint8_t reserved[2];
+};
+
+struct definition_cache_actor_t
+{
+	uint32_t name;
+	uint32_t basic_attack;
+	float speed;
+	uint8_t possessable;
+	uint8_t reserved[3];
+};
+
+//--------------------------------------------------------------------------
+// Definitions compiled out of ActorDefinitions.xml and AbilityDefinitions.xml so
+// starting up maps one file instead of parsing XML. Written from whatever
+// definitions are loaded, so it always matches what the XML loads to.
+// Open maps the file and checks the header, the records are then read in place.
+//--------------------------------------------------------------------------
+class DefinitionCache
+{
+public:
+	static bool GetSource( const std::string& xml_path, definition_cache_source_t& source );
+
+	// Writes next to the path and moves it over, same as the world checkpoint.
+	static bool Write( const std::string& path, const definition_cache_source_t& abilities_source, const definition_cache_source_t& actors_source );
+
+public:
+	bool Open( const std::string& path );
+	void Close();
+
+	// Current when built from these exact XML files.
+	bool IsCurrent( const definition_cache_source_t& abilities_source, const definition_cache_source_t& actors_source ) const;
+
+	uint32_t GetAbilityCount() const							{ return m_header ? m_header->ability_count : 0; }
+	const definition_cache_ability_t* GetAbilities() const		{ return m_abilities; }
+	uint32_t GetActorCount() const								{ return m_header ? m_header->actor_count : 0; }
+	const definition_cache_actor_t* GetActors() const			{ return m_actors; }
+	const char* GetString( uint32_t offset ) const				{ return m_strings + offset; }
+
+private:
+	MappedFile m_file;
+	const definition_cache_header_t* m_header = nullptr;
+	const definition_cache_ability_t* m_abilities = nullptr;
+	const definition_cache_actor_t* m_actors = nullptr;
+	const char* m_strings = nullptr;
+};
@@ -14,8 +14,19 @@
 * Entity
 */
 EntityBase::EntityBase(  const std::string& name )
+	: EntityBase( EntityTypeRegistry::Find( name ) )
 {
 	m_name = name;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Entity
+*/
+EntityBase::EntityBase( EntityTypeId type_id )
+{
+	m_type_id = type_id;
+	m_name = EntityTypeRegistry::GetName( type_id );
 	Zone* zone = Zone::GetZone();
 	if( zone && zone->initialized )
 	{
@@ -30,6 +41,10 @@ EntityBase::EntityBase(  const std::string& name )
 		m_collider = zone->m_physics_system->CreateCollider( false, Vec2::ZERO, 0.5f );
 		m_rigidbody->SetCollider( m_collider );
 
+		if( EntityStore* store = zone->GetEntityStore() )
+		{
+			m_store_handle = store->Create( this, m_transform.m_position );
+		}
 		
 		zone->AddEntity( this );
 	}
@@ -43,10 +58,18 @@ EntityBase::EntityBase(  const std::string& name )
 EntityBase::~EntityBase()
 {
 	Zone* zone = Zone::GetZone();
+	if( zone && zone->m_on_entity_destroyed )
+	{
+		zone->m_on_entity_destroyed( this );
+	}
 	if ( m_rigidbody && zone )
 	{
 		zone->m_physics_system->RemoveRigidbody(m_rigidbody);
 	}
+	if( m_store_handle.IsSet() && zone )
+	{
+		zone->m_entity_store.Destroy( m_store_handle );
+	}
 
 	m_rigidbody = nullptr;
 	m_collider = nullptr;
@@ -58,6 +81,10 @@ EntityBase::~EntityBase()
 */
 void EntityBase::Die()
 {
+	if( Zone::DeferIfInPhase( [this]() { Die(); } ) )
+	{
+		return;
+	}
 	m_isDead = true;
 	m_isGarbage = true;
 }
@@ -115,6 +142,10 @@ Vec2 EntityBase::GetPosition() const
 void EntityBase::SetPosition( const Vec2& pos )
 {
 	m_transform.m_position = pos;
+	if( m_store_handle.IsSet() )
+	{
+		Zone::GetZone()->m_entity_store.SetPosition( m_store_handle, pos );
+	}
 }
 
 //--------------------------------------------------------------------------
@@ -123,8 +154,28 @@ void EntityBase::SetPosition( const Vec2& pos )
 */
 void EntityBase::SetPosition( float x, float y )
 {
-	m_transform.m_position.x = x;
-	m_transform.m_position.y = y;
+	SetPosition( Vec2( x, y ) );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetVelocity
+*/
+Vec2 EntityBase::GetVelocity() const
+{
+	return m_rigidbody ? m_rigidbody->GetVelocity() : Vec2::ZERO;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetVelocity
+*/
+void EntityBase::SetVelocity( const Vec2& velocity )
+{
+	if( m_rigidbody )
+	{
+		m_rigidbody->SetVelocity( velocity );
+	}
 }
 
 //--------------------------------------------------------------------------
@@ -148,11 +199,24 @@ EntityType EntityBase::GetType() const
 	return m_type;
 }
 
+//--------------------------------------------------------------------------
+/**
+* SetType
+*/
+void EntityBase::SetType( EntityType type )
+{
+	m_type = type;
+	if( m_store_handle.IsSet() )
+	{
+		Zone::GetZone()->m_entity_store.SetType( m_store_handle, type );
+	}
+}
+
 //--------------------------------------------------------------------------
 /**
 * GetName
 */
-std::string EntityBase::GetName() const
+const std::string& EntityBase::GetName() const
 {
 	return m_name;
 }
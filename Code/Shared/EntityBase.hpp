@@ -4,11 +4,14 @@
 #include "Engine/Math/Vec2.hpp"
 
 #include "Shared/EntityBaseDefinition.hpp"
+#include "Shared/EntityStore.hpp"
 
 class EntityBase
 {
+	friend class EntityStore;
 public:
 	EntityBase( const std::string& name );
+	EntityBase( EntityTypeId type_id );
 	virtual ~EntityBase();
 
 	virtual void Die();
@@ -23,19 +26,29 @@ public:
 	Vec2 GetPosition() const;
 	void SetPosition( const Vec2& pos );
 	void SetPosition( float x, float y );
+	virtual Vec2 GetVelocity() const;
+	virtual void SetVelocity( const Vec2& velocity );
 
 	// Game play
 	void TakeDamage(float damage);
 	EntityType GetType() const;
-	std::string GetName() const;
+	const std::string& GetName() const;
+	EntityTypeId GetTypeId() const { return m_type_id; }
+
+	bool IsInEntityStore() const { return m_store_handle.IsSet(); }
+
+protected:
+	void SetType( EntityType type );
 
 protected:
 	std::string m_name = "none";
+	EntityTypeId m_type_id = INVALID_ENTITY_TYPE_ID;
 	EntityType m_type = ENTITY_UNKNOWN_ENTITY_TYPE;
 
 	Rigidbody2D* m_rigidbody = nullptr;
 	Collider2D* m_collider = nullptr;
 	Transform2D m_transform;
+	entity_handle_t m_store_handle;
 
 	bool m_isAccelerating = false;
 	int m_rotateDirection = 0; // 1 for counter clockwise, -1 for clockwise, 0 for no movement.
@@ -7,4 +7,15 @@
 EntityBaseDefinition::EntityBaseDefinition(const XmlElement& element)
 {
 	m_name = ParseXmlAttribute( element, "name", "none" );
+	m_type_id = EntityTypeRegistry::Intern( m_name );
+}
+
+//--------------------------------------------------------------------------
+/**
+* EntityBaseDefinition
+*/
+EntityBaseDefinition::EntityBaseDefinition( const char* name )
+	: m_name( name )
+{
+	m_type_id = EntityTypeRegistry::Intern( m_name );
 }
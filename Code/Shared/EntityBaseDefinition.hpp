@@ -2,6 +2,8 @@
 #include "Engine/Core/EngineCommon.hpp"
 #include "Engine/Core/XML/XMLUtils.hpp"
 
+#include "Shared/EntityTypeRegistry.hpp"
+
 enum EntityType
 {
 	ENTITY_UNKNOWN_ENTITY_TYPE = -1,
@@ -16,10 +18,12 @@ class EntityBaseDefinition
 
 protected:
 	EntityBaseDefinition(const XmlElement& element);
+	EntityBaseDefinition( const char* name );
 
 
 protected:
 	std::string m_name = "NONE";
 	EntityType m_type = ENTITY_UNKNOWN_ENTITY_TYPE;
+	EntityTypeId m_type_id = INVALID_ENTITY_TYPE_ID;
 
 };
\ No newline at end of file
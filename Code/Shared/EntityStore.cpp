@@ -0,0 +1,249 @@
+#include "Shared/EntityStore.hpp"
+#include "Shared/EntityBase.hpp"
+
+//--------------------------------------------------------------------------
+/**
+* EntityStore
+*/
+EntityStore::EntityStore()
+{
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* ~EntityStore
+*/
+EntityStore::~EntityStore()
+{
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* Create
+*/
+entity_handle_t EntityStore::Create( EntityBase* entity, const Vec2& position )
+{
+	entity_handle_t handle;
+	if( !m_free_handles.empty() )
+	{
+		handle.index = m_free_handles.back();
+		m_free_handles.pop_back();
+	}
+	else
+	{
+		handle.index = (uint32_t) m_handle_to_dense.size();
+		m_handle_to_dense.push_back( entity_handle_t::INVALID_INDEX );
+		m_generations.push_back( 0 );
+	}
+	handle.generation = m_generations[handle.index];
+
+	m_handle_to_dense[handle.index] = GetCount();
+	m_positions.push_back( position );
+	m_velocities.push_back( Vec2::ZERO );
+	m_types.push_back( ENTITY_UNKNOWN_ENTITY_TYPE );
+	m_time_alive.push_back( 0.0f );
+	m_life_times.push_back( 0.0f );
+	m_entities.push_back( entity );
+	m_dense_to_handle.push_back( handle.index );
+
+	return handle;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Destroy
+*/
+void EntityStore::Destroy( const entity_handle_t& handle )
+{
+	uint32_t dense = GetDenseIndex( handle );
+	if( dense == entity_handle_t::INVALID_INDEX )
+	{
+		return;
+	}
+
+	// Swap the last entry into the hole to keep the arrays dense.
+	uint32_t last = GetCount() - 1;
+	if( dense != last )
+	{
+		m_positions[dense] = m_positions[last];
+		m_velocities[dense] = m_velocities[last];
+		m_types[dense] = m_types[last];
+		m_time_alive[dense] = m_time_alive[last];
+		m_life_times[dense] = m_life_times[last];
+		m_entities[dense] = m_entities[last];
+		m_dense_to_handle[dense] = m_dense_to_handle[last];
+		m_handle_to_dense[m_dense_to_handle[dense]] = dense;
+	}
+
+	m_positions.pop_back();
+	m_velocities.pop_back();
+	m_types.pop_back();
+	m_time_alive.pop_back();
+	m_life_times.pop_back();
+	m_entities.pop_back();
+	m_dense_to_handle.pop_back();
+
+	m_handle_to_dense[handle.index] = entity_handle_t::INVALID_INDEX;
+	++m_generations[handle.index];
+	m_free_handles.push_back( handle.index );
+}
+
+//--------------------------------------------------------------------------
+/**
+* IsValid
+*/
+bool EntityStore::IsValid( const entity_handle_t& handle ) const
+{
+	return GetDenseIndex( handle ) != entity_handle_t::INVALID_INDEX;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Clear
+*/
+void EntityStore::Clear()
+{
+	m_positions.clear();
+	m_velocities.clear();
+	m_types.clear();
+	m_time_alive.clear();
+	m_life_times.clear();
+	m_entities.clear();
+	m_dense_to_handle.clear();
+
+	// Keep the generations so stale handles stay invalid.
+	m_free_handles.clear();
+	for( uint32_t index = 0; index < (uint32_t) m_handle_to_dense.size(); ++index )
+	{
+		if( m_handle_to_dense[index] != entity_handle_t::INVALID_INDEX )
+		{
+			m_handle_to_dense[index] = entity_handle_t::INVALID_INDEX;
+			++m_generations[index];
+		}
+		m_free_handles.push_back( index );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetType
+*/
+void EntityStore::SetType( const entity_handle_t& handle, EntityType type )
+{
+	uint32_t dense = GetDenseIndex( handle );
+	if( dense != entity_handle_t::INVALID_INDEX )
+	{
+		m_types[dense] = type;
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetPosition
+*/
+void EntityStore::SetPosition( const entity_handle_t& handle, const Vec2& position )
+{
+	uint32_t dense = GetDenseIndex( handle );
+	if( dense != entity_handle_t::INVALID_INDEX )
+	{
+		m_positions[dense] = position;
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetVelocity
+*/
+void EntityStore::SetVelocity( const entity_handle_t& handle, const Vec2& velocity )
+{
+	uint32_t dense = GetDenseIndex( handle );
+	if( dense != entity_handle_t::INVALID_INDEX )
+	{
+		m_velocities[dense] = velocity;
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetLifeTime
+*/
+void EntityStore::SetLifeTime( const entity_handle_t& handle, float life_time )
+{
+	uint32_t dense = GetDenseIndex( handle );
+	if( dense != entity_handle_t::INVALID_INDEX )
+	{
+		m_life_times[dense] = life_time;
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* IntegrateProjectiles
+* Only abilities get their position written back, everything else is owned by physics.
+*/
+void EntityStore::IntegrateProjectiles( float deltaSeconds )
+{
+	uint32_t count = GetCount();
+	Vec2* positions = m_positions.data();
+	const Vec2* velocities = m_velocities.data();
+	float* time_alive = m_time_alive.data();
+	const float* life_times = m_life_times.data();
+
+	// Velocity is zero for anything that isn't a projectile so this is a straight run over the arrays.
+	for( uint32_t idx = 0; idx < count; ++idx )
+	{
+		positions[idx] += velocities[idx] * deltaSeconds;
+		time_alive[idx] += deltaSeconds;
+	}
+
+	m_expired.clear();
+	for( uint32_t idx = 0; idx < count; ++idx )
+	{
+		if( life_times[idx] > 0.0f && life_times[idx] < time_alive[idx] )
+		{
+			m_expired.push_back( idx );
+		}
+	}
+
+	for( uint32_t idx = 0; idx < count; ++idx )
+	{
+		if( m_types[idx] == ENTITY_ABILITY )
+		{
+			m_entities[idx]->m_transform.m_position = positions[idx];
+		}
+	}
+
+	// Die only flags the entity, the slot goes away when the Zone deletes it.
+	for( uint32_t idx : m_expired )
+	{
+		m_entities[idx]->Die();
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* GatherPositions
+*/
+void EntityStore::GatherPositions()
+{
+	uint32_t count = GetCount();
+	for( uint32_t idx = 0; idx < count; ++idx )
+	{
+		m_positions[idx] = m_entities[idx]->GetPosition();
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetDenseIndex
+*/
+uint32_t EntityStore::GetDenseIndex( const entity_handle_t& handle ) const
+{
+	if( handle.index >= (uint32_t) m_handle_to_dense.size() || m_generations[handle.index] != handle.generation )
+	{
+		return entity_handle_t::INVALID_INDEX;
+	}
+	return m_handle_to_dense[handle.index];
+}
\ No newline at end of file
@@ -0,0 +1,78 @@
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+
+#include "Shared/EntityBaseDefinition.hpp"
+
+#include <cstdint>
+#include <vector>
+
+class EntityBase;
+
+//--------------------------------------------------------------------------
+// Stable reference into the EntityStore. The generation catches handles that
+// outlived their entity and had their slot reused.
+//--------------------------------------------------------------------------
+struct entity_handle_t
+{
+	static constexpr uint32_t INVALID_INDEX = 0xffffffff;
+
+	uint32_t index = INVALID_INDEX;
+	uint32_t generation = 0;
+
+	bool IsSet() const { return index != INVALID_INDEX; }
+};
+
+//--------------------------------------------------------------------------
+// Structure of arrays copy of the per-entity state the Zone tick touches every frame.
+// The arrays are kept dense by swapping the last entry into a destroyed slot,
+// handles map onto the dense index through a sparse table.
+//--------------------------------------------------------------------------
+class EntityStore
+{
+public:
+	EntityStore();
+	~EntityStore();
+
+public:
+	entity_handle_t Create( EntityBase* entity, const Vec2& position );
+	void Destroy( const entity_handle_t& handle );
+	bool IsValid( const entity_handle_t& handle ) const;
+	void Clear();
+
+	void SetType( const entity_handle_t& handle, EntityType type );
+	void SetPosition( const entity_handle_t& handle, const Vec2& position );
+	void SetVelocity( const entity_handle_t& handle, const Vec2& velocity );
+	void SetLifeTime( const entity_handle_t& handle, float life_time );
+
+	// Moves projectiles, ages everything and kills what expired. Call before the physics step.
+	void IntegrateProjectiles( float deltaSeconds );
+	// Copies positions back out of the entities. Call after the physics step.
+	void GatherPositions();
+
+public:
+	uint32_t GetCount() const { return (uint32_t) m_entities.size(); }
+	const Vec2* GetPositions() const { return m_positions.data(); }
+	EntityBase* const* GetEntities() const { return m_entities.data(); }
+
+private:
+	uint32_t GetDenseIndex( const entity_handle_t& handle ) const;
+
+private:
+	// Dense, indexed by [0, GetCount())
+	std::vector<Vec2> m_positions;
+	std::vector<Vec2> m_velocities;
+	std::vector<EntityType> m_types;
+	std::vector<float> m_time_alive;
+	std::vector<float> m_life_times;		// 0 or less lives forever.
+	std::vector<EntityBase*> m_entities;
+	std::vector<uint32_t> m_dense_to_handle;
+
+	// Sparse, indexed by handle index
+	std::vector<uint32_t> m_handle_to_dense;
+	std::vector<uint32_t> m_generations;
+	std::vector<uint32_t> m_free_handles;
+
+	// Scratch for IntegrateProjectiles
+	std::vector<uint32_t> m_expired;
+
+};
\ No newline at end of file
@@ -0,0 +1,43 @@
+#include "Shared/EntityTypeRegistry.hpp"
+
+std::unordered_map<std::string, EntityTypeId> EntityTypeRegistry::s_ids;
+std::vector<std::string> EntityTypeRegistry::s_names;
+
+//--------------------------------------------------------------------------
+/**
+* Intern
+* Returns the existing id for the name or hands out the next one.
+*/
+EntityTypeId EntityTypeRegistry::Intern( const std::string& name )
+{
+	auto itr = s_ids.find( name );
+	if( itr != s_ids.end() )
+	{
+		return itr->second;
+	}
+
+	EntityTypeId id = (EntityTypeId) s_names.size();
+	s_ids[name] = id;
+	s_names.push_back( name );
+	return id;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Find
+*/
+EntityTypeId EntityTypeRegistry::Find( const std::string& name )
+{
+	auto itr = s_ids.find( name );
+	return itr != s_ids.end() ? itr->second : INVALID_ENTITY_TYPE_ID;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetName
+*/
+const std::string& EntityTypeRegistry::GetName( EntityTypeId id )
+{
+	static const std::string none = "none";
+	return id < s_names.size() ? s_names[id] : none;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+typedef uint16_t EntityTypeId;
+constexpr EntityTypeId INVALID_ENTITY_TYPE_ID = 0xffff;
+
+//--------------------------------------------------------------------------
+// Interns definition names into small dense ids at load time so per frame code
+// compares integers instead of strings. Ids are only ever added, never reused.
+// Not thread safe, intern while loading or from static initialisers.
+//--------------------------------------------------------------------------
+class EntityTypeRegistry
+{
+public:
+	static EntityTypeId Intern( const std::string& name );
+	static EntityTypeId Find( const std::string& name );
+	static const std::string& GetName( EntityTypeId id );
+	static size_t GetCount() { return s_names.size(); }
+
+private:
+	static std::unordered_map<std::string, EntityTypeId> s_ids;
+	static std::vector<std::string> s_names;
+
+};
\ No newline at end of file
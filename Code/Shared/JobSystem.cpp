@@ -0,0 +1,164 @@
+#include "Shared/JobSystem.hpp"
+
+//--------------------------------------------------------------------------
+/**
+* JobSystem
+*/
+JobSystem::JobSystem()
+{
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* ~JobSystem
+*/
+JobSystem::~JobSystem()
+{
+	Shutdown();
+}
+
+//--------------------------------------------------------------------------
+/**
+* Startup
+*/
+void JobSystem::Startup( uint32_t worker_count )
+{
+	Shutdown();
+
+	m_quit = false;
+	for( uint32_t idx = 0; idx < worker_count; ++idx )
+	{
+		m_workers.emplace_back( &JobSystem::WorkerLoop, this );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* Shutdown
+*/
+void JobSystem::Shutdown()
+{
+	{
+		std::lock_guard<std::mutex> lock( m_lock );
+		m_quit = true;
+	}
+	m_wake.notify_all();
+
+	for( std::thread& worker : m_workers )
+	{
+		worker.join();
+	}
+	m_workers.clear();
+}
+
+//--------------------------------------------------------------------------
+/**
+* ParallelFor
+*/
+void JobSystem::ParallelFor( uint32_t count, uint32_t chunk_size, const job_chunk_fn& fn )
+{
+	if( count == 0 )
+	{
+		return;
+	}
+	if( chunk_size == 0 )
+	{
+		chunk_size = 1;
+	}
+	uint32_t num_chunks = ( count + chunk_size - 1 ) / chunk_size;
+
+	// Nothing to share, skip the wake up.
+	if( m_workers.empty() || num_chunks == 1 )
+	{
+		for( uint32_t chunk = 0; chunk < num_chunks; ++chunk )
+		{
+			uint32_t begin = chunk * chunk_size;
+			uint32_t end = begin + chunk_size < count ? begin + chunk_size : count;
+			fn( chunk, begin, end );
+		}
+		return;
+	}
+
+	{
+		std::lock_guard<std::mutex> lock( m_lock );
+		m_job = &fn;
+		m_count = count;
+		m_chunk_size = chunk_size;
+		m_num_chunks = num_chunks;
+		m_chunks_remaining = num_chunks;
+		m_next_chunk = 0;
+		++m_generation;
+	}
+	m_wake.notify_all();
+
+	RunChunks();
+
+	// Wait for the workers to leave the job too, it's about to go out of scope.
+	std::unique_lock<std::mutex> lock( m_lock );
+	m_done.wait( lock, [this]() { return m_chunks_remaining == 0 && m_active_workers == 0; } );
+	m_job = nullptr;
+}
+
+//--------------------------------------------------------------------------
+/**
+* WorkerLoop
+*/
+void JobSystem::WorkerLoop()
+{
+	uint64_t seen_generation = 0;
+	{
+		std::lock_guard<std::mutex> lock( m_lock );
+		seen_generation = m_generation;
+	}
+
+	while( true )
+	{
+		{
+			std::unique_lock<std::mutex> lock( m_lock );
+			m_wake.wait( lock, [&]() { return m_quit || ( m_job && m_generation != seen_generation ); } );
+			if( m_quit )
+			{
+				return;
+			}
+			seen_generation = m_generation;
+			++m_active_workers;
+		}
+
+		RunChunks();
+
+		{
+			std::lock_guard<std::mutex> lock( m_lock );
+			--m_active_workers;
+		}
+		m_done.notify_all();
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* RunChunks
+*/
+void JobSystem::RunChunks()
+{
+	uint32_t finished = 0;
+	while( true )
+	{
+		uint32_t chunk = m_next_chunk.fetch_add( 1 );
+		if( chunk >= m_num_chunks )
+		{
+			break;
+		}
+		uint32_t begin = chunk * m_chunk_size;
+		uint32_t end = begin + m_chunk_size < m_count ? begin + m_chunk_size : m_count;
+		( *m_job )( chunk, begin, end );
+		++finished;
+	}
+
+	if( finished > 0 )
+	{
+		std::lock_guard<std::mutex> lock( m_lock );
+		m_chunks_remaining -= finished;
+	}
+	m_done.notify_all();
+}
\ No newline at end of file
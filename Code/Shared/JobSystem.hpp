@@ -0,0 +1,56 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// ( chunk_index, begin, end )
+typedef std::function<void( uint32_t, uint32_t, uint32_t )> job_chunk_fn;
+
+//--------------------------------------------------------------------------
+// Small fork/join pool for the Zone tick. ParallelFor splits a range into fixed
+// size chunks that the workers and the calling thread pull from until none are left.
+// Chunk boundaries only depend on the chunk size, never on the worker count.
+//--------------------------------------------------------------------------
+class JobSystem
+{
+public:
+	JobSystem();
+	~JobSystem();
+
+public:
+	// 0 workers runs every chunk on the calling thread.
+	void Startup( uint32_t worker_count );
+	void Shutdown();
+	uint32_t GetWorkerCount() const { return (uint32_t) m_workers.size(); }
+
+	// Blocks until every chunk has run.
+	void ParallelFor( uint32_t count, uint32_t chunk_size, const job_chunk_fn& fn );
+
+private:
+	void WorkerLoop();
+	void RunChunks();
+
+private:
+	std::vector<std::thread> m_workers;
+
+	std::mutex m_lock;
+	std::condition_variable m_wake;
+	std::condition_variable m_done;
+	bool m_quit = false;
+
+	// Current job, only changes while no worker is inside it.
+	const job_chunk_fn* m_job = nullptr;
+	uint32_t m_count = 0;
+	uint32_t m_chunk_size = 1;
+	uint32_t m_num_chunks = 0;
+	uint64_t m_generation = 0;
+	std::atomic<uint32_t> m_next_chunk{ 0 };
+	uint32_t m_chunks_remaining = 0;
+	uint32_t m_active_workers = 0;
+
+};
\ No newline at end of file
@@ -0,0 +1,1166 @@
+#include "Shared/LocalWorkerBus.hpp"
+#include "Shared/AsyncLog.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+
+//--------------------------------------------------------------------------
+/**
+* HasComponent
+*/
+template <typename... T>
+static bool HasComponent( const worker::Entity& entity, worker::ComponentId component_id, const worker::Components<T...>& )
+{
+	return ( ( T::ComponentId == component_id && entity.Get<T>() ) || ... );
+}
+
+//--------------------------------------------------------------------------
+/**
+* MakeUpdate
+* The bus only keeps full component state, so updates always carry every field.
+*/
+static improbable::Position::Update MakeUpdate( const improbable::PositionData& data )
+{
+	improbable::Position::Update update;
+	update.set_coords( data.coords() );
+	return update;
+}
+
+//--------------------------------------------------------------------------
+/**
+* MakeUpdate
+*/
+static improbable::Metadata::Update MakeUpdate( const improbable::MetadataData& data )
+{
+	improbable::Metadata::Update update;
+	update.set_entity_type( data.entity_type() );
+	return update;
+}
+
+//--------------------------------------------------------------------------
+/**
+* MakeUpdate
+*/
+static siren::PlayerControls::Update MakeUpdate( const siren::PlayerControlsData& data )
+{
+	siren::PlayerControls::Update update;
+	update.set_x_move( data.x_move() );
+	update.set_y_move( data.y_move() );
+	update.set_sequence( data.sequence() );
+	return update;
+}
+
+//--------------------------------------------------------------------------
+/**
+* MakeUpdate
+*/
+static siren::PlayerMovement::Update MakeUpdate( const siren::PlayerMovementData& data )
+{
+	siren::PlayerMovement::Update update;
+	update.set_input_sequence( data.input_sequence() );
+	update.set_position( data.position() );
+	update.set_velocity( data.velocity() );
+	return update;
+}
+
+//--------------------------------------------------------------------------
+/**
+* MakeUpdate
+*/
+static siren::PlanePosition::Update MakeUpdate( const siren::PlanePositionData& data )
+{
+	siren::PlanePosition::Update update;
+	update.set_keyframe_x( data.keyframe_x() );
+	update.set_keyframe_y( data.keyframe_y() );
+	update.set_delta_x( data.delta_x() );
+	update.set_delta_y( data.delta_y() );
+	return update;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GatherComponentOp
+* Turns the difference between what a worker last saw and the current state into an op.
+*/
+template <typename T>
+static void GatherComponentOp( std::vector<local_op_t>& out, worker::EntityId id, const worker::Entity& entity, uint64_t seen_version )
+{
+	auto data = entity.Get<T>();
+	if( !data )
+	{
+		out.push_back( [id]( WorkerDispatcher& dispatcher ) { dispatcher.RemoveComponent( id, T::ComponentId ); } );
+	}
+	else if( seen_version == 0 )
+	{
+		typename T::Data copy = *data;
+		out.push_back( [id, copy]( WorkerDispatcher& dispatcher ) { dispatcher.AddComponent( id, copy ); } );
+	}
+	else
+	{
+		typename T::Update update = MakeUpdate( *data );
+		out.push_back( [id, update]( WorkerDispatcher& dispatcher ) { dispatcher.UpdateComponent( id, update ); } );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* HasTrackedComponent
+*/
+static bool HasTrackedComponent( const worker::Entity& entity, int tracked_index )
+{
+	return HasComponent( entity, LOCAL_AUTHORITY_COMPONENTS[tracked_index], WorkerComponentRegistry{} );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetCellIndex
+*/
+static int32_t GetCellIndex( double value, double cell_size )
+{
+	return (int32_t)std::floor( value / cell_size );
+}
+
+//--------------------------------------------------------------------------
+/**
+* MakeCellKey
+*/
+static uint64_t MakeCellKey( int32_t x, int32_t z )
+{
+	return ( (uint64_t)(uint32_t)x << 32 ) | (uint64_t)(uint32_t)z;
+}
+
+//--------------------------------------------------------------------------
+/**
+* EraseValue
+* Order doesn't matter in any of the lists this is used on.
+*/
+template <typename T>
+static void EraseValue( std::vector<T>& values, const T& value )
+{
+	auto found = std::find( values.begin(), values.end(), value );
+	if( found != values.end() )
+	{
+		*found = values.back();
+		values.pop_back();
+	}
+}
+
+
+//--------------------------------------------------------------------------
+/**
+* LocalWorkerBus
+*/
+LocalWorkerBus::LocalWorkerBus( const local_bus_settings_t& settings )
+	: m_settings( settings )
+{
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* ~LocalWorkerBus
+* Connections left open see a disconnect the next time they process.
+*/
+LocalWorkerBus::~LocalWorkerBus()
+{
+	std::lock_guard<std::mutex> lg( m_lock );
+	for( LocalConnection* connection : m_connections )
+	{
+		// Queued first, a connection that sees m_bus go null then sees the disconnect too.
+		connection->m_queued_ops.push_back( []( WorkerDispatcher& dispatcher ) { dispatcher.DispatchDisconnect( "Local worker bus shut down" ); } );
+		connection->m_bus = nullptr;
+	}
+	m_connections.clear();
+}
+
+//--------------------------------------------------------------------------
+/**
+* Connect
+*/
+LocalConnection* LocalWorkerBus::Connect( const std::string& worker_type, const std::string& worker_id )
+{
+	std::vector<std::string> attributes;
+	attributes.push_back( worker_type == "Managed" ? "simulation" : "client" );
+	attributes.push_back( "workerId:" + worker_id );
+
+	std::lock_guard<std::mutex> lg( m_lock );
+	LocalConnection* connection = new LocalConnection( this, worker_id, attributes );
+	m_connections.push_back( connection );
+	if( connection->m_sees_everything )
+	{
+		m_simulation_connections.push_back( connection );
+		connection->m_rescan = true;
+	}
+
+	// Entities waiting on a worker like this one can have an owner now.
+	ResolveAllAuthority();
+	MarkChanged();
+	return connection;
+}
+
+//--------------------------------------------------------------------------
+/**
+* AddEntity
+*/
+bool LocalWorkerBus::AddEntity( worker::EntityId id, const worker::Entity& entity )
+{
+	std::lock_guard<std::mutex> lg( m_lock );
+	if( FindEntity( id ) )
+	{
+		return false;
+	}
+	InsertEntity( id, entity );
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetEntityCount
+*/
+size_t LocalWorkerBus::GetEntityCount() const
+{
+	std::lock_guard<std::mutex> lg( m_lock );
+	return m_entities.size();
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetConnectionCount
+*/
+size_t LocalWorkerBus::GetConnectionCount() const
+{
+	std::lock_guard<std::mutex> lg( m_lock );
+	return m_connections.size();
+}
+
+//--------------------------------------------------------------------------
+/**
+* InsertEntity
+*/
+void LocalWorkerBus::InsertEntity( worker::EntityId id, const worker::Entity& entity )
+{
+	MarkChanged();
+
+	local_entity_t& local_entity = m_entities[id];
+	local_entity.data = entity;
+	for( int idx = 0; idx < LOCAL_TRACKED_COMPONENT_COUNT; ++idx )
+	{
+		local_entity.versions[idx] = HasTrackedComponent( entity, idx ) ? m_version : 0;
+	}
+	ResolveAuthority( id, local_entity );
+	UpdateCell( id, local_entity );
+	MarkEntityDirty( id, local_entity );
+
+	m_next_entity_id = std::max( m_next_entity_id, id + 1 );
+}
+
+//--------------------------------------------------------------------------
+/**
+* ResolveAuthority
+* Workers that gain or lose authority get the entity marked dirty. PlayerControls is what
+* a client's view is built around, so that one changes their view too.
+*/
+void LocalWorkerBus::ResolveAuthority( worker::EntityId id, local_entity_t& entity )
+{
+	auto acl = entity.data.Get<improbable::EntityAcl>();
+	for( int idx = 0; idx < LOCAL_AUTHORITY_COMPONENT_COUNT; ++idx )
+	{
+		LocalConnection* owner = nullptr;
+		if( acl )
+		{
+			auto requirement = acl->component_write_acl().find( LOCAL_AUTHORITY_COMPONENTS[idx] );
+			if( requirement != acl->component_write_acl().end() )
+			{
+				for( LocalConnection* connection : m_connections )
+				{
+					if( connection->Satisfies( requirement->second ) )
+					{
+						owner = connection;
+						break;
+					}
+				}
+			}
+		}
+
+		LocalConnection* previous = entity.authority[idx];
+		if( owner == previous )
+		{
+			continue;
+		}
+		entity.authority[idx] = owner;
+
+		for( LocalConnection* connection : { previous, owner } )
+		{
+			if( !connection )
+			{
+				continue;
+			}
+			connection->m_dirty.insert( id );
+			if( idx == 2 )
+			{
+				if( connection == owner )
+				{
+					connection->m_controlled.insert( id );
+				}
+				else
+				{
+					connection->m_controlled.erase( id );
+				}
+				connection->m_view_dirty = true;
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* ResolveAllAuthority
+*/
+void LocalWorkerBus::ResolveAllAuthority()
+{
+	for( auto& entity_pair : m_entities )
+	{
+		ResolveAuthority( entity_pair.first, entity_pair.second );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* MarkChanged
+*/
+void LocalWorkerBus::MarkChanged()
+{
+	++m_version;
+	m_changed.notify_all();
+}
+
+//--------------------------------------------------------------------------
+/**
+* MarkEntityDirty
+* Simulation workers, whoever has it checked out now, and clients that could see it where it is.
+*/
+void LocalWorkerBus::MarkEntityDirty( worker::EntityId id, const local_entity_t& entity )
+{
+	for( LocalConnection* connection : m_simulation_connections )
+	{
+		connection->m_dirty.insert( id );
+	}
+	for( LocalConnection* connection : entity.watchers )
+	{
+		connection->m_dirty.insert( id );
+	}
+	if( entity.has_cell )
+	{
+		auto viewers = m_view_cells.find( entity.cell );
+		if( viewers != m_view_cells.end() )
+		{
+			for( LocalConnection* connection : viewers->second )
+			{
+				connection->m_dirty.insert( id );
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* UpdateCell
+* After the entity's Position changed.
+*/
+void LocalWorkerBus::UpdateCell( worker::EntityId id, local_entity_t& entity )
+{
+	auto position = entity.data.Get<improbable::Position>();
+	bool has_cell = (bool)position;
+	double cell_size = GetCellSize();
+	uint64_t cell = has_cell ? MakeCellKey( GetCellIndex( position->coords().x(), cell_size ), GetCellIndex( position->coords().z(), cell_size ) ) : 0;
+	if( has_cell == entity.has_cell && cell == entity.cell )
+	{
+		return;
+	}
+
+	if( entity.has_cell )
+	{
+		auto old_cell = m_entity_cells.find( entity.cell );
+		EraseValue( old_cell->second, id );
+		if( old_cell->second.empty() )
+		{
+			m_entity_cells.erase( old_cell );
+		}
+	}
+	if( has_cell )
+	{
+		m_entity_cells[cell].push_back( id );
+	}
+	entity.cell = cell;
+	entity.has_cell = has_cell;
+}
+
+//--------------------------------------------------------------------------
+/**
+* EraseEntity
+*/
+void LocalWorkerBus::EraseEntity( worker::EntityId id )
+{
+	local_entity_t* entity = FindEntity( id );
+	if( !entity )
+	{
+		return;
+	}
+
+	MarkChanged();
+	MarkEntityDirty( id, *entity );
+	if( LocalConnection* controller = entity->authority[2] )
+	{
+		controller->m_controlled.erase( id );
+		controller->m_view_dirty = true;
+	}
+	if( entity->has_cell )
+	{
+		auto cell = m_entity_cells.find( entity->cell );
+		EraseValue( cell->second, id );
+		if( cell->second.empty() )
+		{
+			m_entity_cells.erase( cell );
+		}
+	}
+	m_entities.erase( id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetCellSize
+*/
+double LocalWorkerBus::GetCellSize() const
+{
+	return std::max( (double)m_settings.client_view_radius, 1.0 );
+}
+
+//--------------------------------------------------------------------------
+/**
+* FindEntity
+*/
+LocalWorkerBus::local_entity_t* LocalWorkerBus::FindEntity( worker::EntityId id )
+{
+	auto found = m_entities.find( id );
+	return found != m_entities.end() ? &found->second : nullptr;
+}
+
+//--------------------------------------------------------------------------
+/**
+* FailCommand
+*/
+template <typename T>
+static void FailCommand( LocalConnection* caller, std::vector<local_op_t>& caller_ops, uint64_t caller_request_id, worker::EntityId entity_id, const std::string& message )
+{
+	if( !caller )
+	{
+		return;
+	}
+	command_response_t<T> response;
+	response.request_id = caller_request_id;
+	response.entity_id = entity_id;
+	response.status_code = worker::StatusCode::kNotFound;
+	response.message = message;
+	caller_ops.push_back( [response]( WorkerDispatcher& dispatcher ) { dispatcher.DispatchCommandResponse( response ); } );
+}
+
+//--------------------------------------------------------------------------
+/**
+* Disconnect
+*/
+void LocalWorkerBus::Disconnect( LocalConnection* connection )
+{
+	m_connections.erase( std::remove( m_connections.begin(), m_connections.end(), connection ), m_connections.end() );
+	EraseValue( m_simulation_connections, connection );
+
+	// Nothing gets routed to it anymore.
+	for( const auto& checkout_pair : connection->m_checked_out )
+	{
+		local_entity_t* entity = FindEntity( checkout_pair.first );
+		if( entity )
+		{
+			EraseValue( entity->watchers, connection );
+		}
+	}
+	for( uint64_t cell : connection->m_view_cells )
+	{
+		auto viewers = m_view_cells.find( cell );
+		EraseValue( viewers->second, connection );
+		if( viewers->second.empty() )
+		{
+			m_view_cells.erase( viewers );
+		}
+	}
+
+	// Commands it never answered fail, answers owed to it go nowhere.
+	auto itr = m_pending_commands.begin();
+	while( itr != m_pending_commands.end() )
+	{
+		pending_command_t& pending = itr->second;
+		if( pending.caller == connection )
+		{
+			pending.caller = nullptr;
+		}
+
+		if( pending.target == connection )
+		{
+			if( pending.caller )
+			{
+				pending.fail( pending.caller, pending.caller->m_queued_ops, pending.caller_request_id, pending.entity_id, "Authoritative worker disconnected" );
+			}
+			itr = m_pending_commands.erase( itr );
+		}
+		else
+		{
+			++itr;
+		}
+	}
+
+	ResolveAllAuthority();
+	MarkChanged();
+}
+
+
+//--------------------------------------------------------------------------
+/**
+* LocalConnection
+*/
+LocalConnection::LocalConnection( LocalWorkerBus* bus, const std::string& worker_id, const std::vector<std::string>& attributes )
+	: m_bus( bus )
+	, m_worker_id( worker_id )
+	, m_attributes( attributes )
+{
+	m_sees_everything = std::find( m_attributes.begin(), m_attributes.end(), "simulation" ) != m_attributes.end();
+}
+
+//--------------------------------------------------------------------------
+/**
+* ~LocalConnection
+*/
+LocalConnection::~LocalConnection()
+{
+	LocalWorkerBus* bus = m_bus;
+	if( bus )
+	{
+		std::lock_guard<std::mutex> lg( bus->m_lock );
+		bus->Disconnect( this );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* IsConnected
+*/
+bool LocalConnection::IsConnected() const
+{
+	return m_bus != nullptr;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Process
+* Responses and commands go first, then the checkout diff.
+*/
+void LocalConnection::Process( WorkerDispatcher& dispatcher, uint32_t timeout_millis )
+{
+	std::vector<local_op_t> ops;
+	LocalWorkerBus* bus = m_bus;
+	if( bus )
+	{
+		std::unique_lock<std::mutex> lock( bus->m_lock );
+		if( timeout_millis > 0 )
+		{
+			bus->m_changed.wait_for( lock, std::chrono::milliseconds( timeout_millis ), [this]() {
+				return HasStateChanges();
+				} );
+		}
+		ops.swap( m_queued_ops );
+		GatherStateOps( ops );
+	}
+	else
+	{
+		// Bus is gone, only the disconnect is left.
+		ops.swap( m_queued_ops );
+	}
+
+	for( const local_op_t& op : ops )
+	{
+		op( dispatcher );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendLogMessage
+*/
+void LocalConnection::SendLogMessage( worker::LogLevel level, const std::string& logger_name, const std::string& message )
+{
+	LogLevel log_level = level == worker::LogLevel::kError || level == worker::LogLevel::kFatal ? LOG_LEVEL_ERROR
+		: level == worker::LogLevel::kWarn ? LOG_LEVEL_WARNING
+		: level == worker::LogLevel::kDebug ? LOG_LEVEL_DEBUG
+		: LOG_LEVEL_INFO;
+	LOG_AT_LEVEL( log_level, "Local", "[%s] %s: %s", m_worker_id.c_str(), logger_name.c_str(), message.c_str() );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendComponentUpdate
+*/
+void LocalConnection::SendComponentUpdate( worker::EntityId entity_id, const improbable::Position::Update& update )
+{
+	ApplyUpdate<improbable::Position>( entity_id, 0, update );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendComponentUpdate
+*/
+void LocalConnection::SendComponentUpdate( worker::EntityId entity_id, const siren::PlayerControls::Update& update )
+{
+	ApplyUpdate<siren::PlayerControls>( entity_id, 2, update );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendComponentUpdate
+*/
+void LocalConnection::SendComponentUpdate( worker::EntityId entity_id, const siren::PlayerMovement::Update& update )
+{
+	ApplyUpdate<siren::PlayerMovement>( entity_id, 3, update );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendComponentUpdate
+*/
+void LocalConnection::SendComponentUpdate( worker::EntityId entity_id, const siren::PlanePosition::Update& update )
+{
+	ApplyUpdate<siren::PlanePosition>( entity_id, 4, update );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendComponentUpdate
+*/
+void LocalConnection::SendComponentUpdate( worker::EntityId entity_id, const siren::ClientHeartbeat::Update& update )
+{
+	ApplyUpdate<siren::ClientHeartbeat>( entity_id, 6, update );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendReserveEntityIdsRequest
+*/
+uint64_t LocalConnection::SendReserveEntityIdsRequest( uint32_t count )
+{
+	LocalWorkerBus* bus = m_bus;
+	if( !bus )
+	{
+		return m_next_request_id++;
+	}
+	std::lock_guard<std::mutex> lg( bus->m_lock );
+
+	reserve_entity_ids_response_t response;
+	response.request_id = m_next_request_id++;
+	response.first_entity_id = bus->m_next_entity_id;
+	bus->m_next_entity_id += count;
+
+	m_queued_ops.push_back( [response]( WorkerDispatcher& dispatcher ) { dispatcher.DispatchReserveEntityIdsResponse( response ); } );
+	bus->m_changed.notify_all();
+	return response.request_id;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCreateEntityRequest
+*/
+worker::Option<uint64_t> LocalConnection::SendCreateEntityRequest( const worker::Entity& entity, const worker::Option<worker::EntityId>& entity_id )
+{
+	LocalWorkerBus* bus = m_bus;
+	if( !bus )
+	{
+		return {};
+	}
+	std::lock_guard<std::mutex> lg( bus->m_lock );
+
+	create_entity_response_t response;
+	response.request_id = m_next_request_id++;
+	worker::EntityId id = entity_id ? *entity_id : bus->m_next_entity_id++;
+	if( bus->FindEntity( id ) )
+	{
+		response.status_code = worker::StatusCode::kApplicationError;
+		response.message = "Entity id already in use";
+	}
+	else
+	{
+		bus->InsertEntity( id, entity );
+		response.entity_id = id;
+	}
+
+	m_queued_ops.push_back( [response]( WorkerDispatcher& dispatcher ) { dispatcher.DispatchCreateEntityResponse( response ); } );
+	bus->m_changed.notify_all();
+	return worker::Option<uint64_t>( response.request_id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendDeleteEntityRequest
+*/
+uint64_t LocalConnection::SendDeleteEntityRequest( worker::EntityId entity_id )
+{
+	LocalWorkerBus* bus = m_bus;
+	if( !bus )
+	{
+		return m_next_request_id++;
+	}
+	std::lock_guard<std::mutex> lg( bus->m_lock );
+
+	delete_entity_response_t response;
+	response.request_id = m_next_request_id++;
+	response.entity_id = entity_id;
+	if( bus->FindEntity( entity_id ) )
+	{
+		bus->EraseEntity( entity_id );
+	}
+	else
+	{
+		response.status_code = worker::StatusCode::kNotFound;
+		response.message = "No such entity";
+	}
+
+	m_queued_ops.push_back( [response]( WorkerDispatcher& dispatcher ) { dispatcher.DispatchDeleteEntityResponse( response ); } );
+	bus->m_changed.notify_all();
+	return response.request_id;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendEntityQueryRequest
+*/
+uint64_t LocalConnection::SendEntityQueryRequest( worker::ComponentId component_id )
+{
+	LocalWorkerBus* bus = m_bus;
+	if( !bus )
+	{
+		return m_next_request_id++;
+	}
+	std::lock_guard<std::mutex> lg( bus->m_lock );
+
+	entity_query_response_t response;
+	response.request_id = m_next_request_id++;
+	for( const auto& entity_pair : bus->m_entities )
+	{
+		if( HasComponent( entity_pair.second.data, component_id, WorkerComponentRegistry{} ) )
+		{
+			response.entity_ids.push_back( entity_pair.first );
+		}
+	}
+
+	m_queued_ops.push_back( [response]( WorkerDispatcher& dispatcher ) { dispatcher.DispatchEntityQueryResponse( response ); } );
+	bus->m_changed.notify_all();
+	return response.request_id;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCommandRequest
+*/
+worker::Option<uint64_t> LocalConnection::SendCommandRequest( worker::EntityId entity_id, const CreateClientEntity::Request& request )
+{
+	return RouteCommand<CreateClientEntity>( entity_id, request );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCommandRequest
+*/
+worker::Option<uint64_t> LocalConnection::SendCommandRequest( worker::EntityId entity_id, const DeleteClientEntity::Request& request )
+{
+	return RouteCommand<DeleteClientEntity>( entity_id, request );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCommandResponse
+*/
+void LocalConnection::SendCommandResponse( uint64_t request_id, const CreateClientEntity::Response& response )
+{
+	RespondToCommand<CreateClientEntity>( request_id, response );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCommandResponse
+*/
+void LocalConnection::SendCommandResponse( uint64_t request_id, const DeleteClientEntity::Response& response )
+{
+	RespondToCommand<DeleteClientEntity>( request_id, response );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCommandRequest
+*/
+worker::Option<uint64_t> LocalConnection::SendCommandRequest( worker::EntityId entity_id, const ClientPing::Request& request )
+{
+	return RouteCommand<ClientPing>( entity_id, request );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCommandResponse
+*/
+void LocalConnection::SendCommandResponse( uint64_t request_id, const ClientPing::Response& response )
+{
+	RespondToCommand<ClientPing>( request_id, response );
+}
+
+//--------------------------------------------------------------------------
+/**
+* Satisfies
+* True if we have every attribute of any one of the requirement's sets.
+*/
+bool LocalConnection::Satisfies( const improbable::WorkerRequirementSet& requirement ) const
+{
+	for( const improbable::WorkerAttributeSet& attribute_set : requirement.attribute_set() )
+	{
+		bool has_all = true;
+		for( const std::string& attribute : attribute_set.attribute() )
+		{
+			if( std::find( m_attributes.begin(), m_attributes.end(), attribute ) == m_attributes.end() )
+			{
+				has_all = false;
+				break;
+			}
+		}
+		if( has_all )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------------------------------
+/**
+* HasStateChanges
+*/
+bool LocalConnection::HasStateChanges() const
+{
+	return !m_queued_ops.empty() || !m_dirty.empty() || m_rescan || m_view_dirty;
+}
+
+//--------------------------------------------------------------------------
+/**
+* IsInView
+* Clients see around whatever they control.
+*/
+bool LocalConnection::IsInView( const LocalWorkerBus* bus, const LocalWorkerBus::local_entity_t& entity ) const
+{
+	if( m_sees_everything )
+	{
+		return true;
+	}
+
+	auto position = entity.data.Get<improbable::Position>();
+	if( !position )
+	{
+		return false;
+	}
+	double radius = (double)bus->m_settings.client_view_radius;
+	for( const anchor_t& anchor : m_anchors )
+	{
+		if( std::abs( position->coords().x() - anchor.x ) <= radius && std::abs( position->coords().z() - anchor.z ) <= radius )
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RebuildView
+* Moves our registration to the cells around what we control now. Everything in those
+* cells could have come into view, everything checked out could have left it.
+*/
+void LocalConnection::RebuildView( LocalWorkerBus* bus, std::vector<worker::EntityId>& candidates )
+{
+	m_anchors.clear();
+	for( worker::EntityId id : m_controlled )
+	{
+		const LocalWorkerBus::local_entity_t* entity = bus->FindEntity( id );
+		if( !entity )
+		{
+			continue;
+		}
+		auto position = entity->data.Get<improbable::Position>();
+		if( position )
+		{
+			m_anchors.push_back( { position->coords().x(), position->coords().z() } );
+		}
+	}
+
+	for( uint64_t cell : m_view_cells )
+	{
+		auto viewers = bus->m_view_cells.find( cell );
+		EraseValue( viewers->second, this );
+		if( viewers->second.empty() )
+		{
+			bus->m_view_cells.erase( viewers );
+		}
+	}
+	m_view_cells.clear();
+
+	double radius = (double)bus->m_settings.client_view_radius;
+	double cell_size = bus->GetCellSize();
+	for( const anchor_t& anchor : m_anchors )
+	{
+		for( int32_t x = GetCellIndex( anchor.x - radius, cell_size ); x <= GetCellIndex( anchor.x + radius, cell_size ); ++x )
+		{
+			for( int32_t z = GetCellIndex( anchor.z - radius, cell_size ); z <= GetCellIndex( anchor.z + radius, cell_size ); ++z )
+			{
+				m_view_cells.push_back( MakeCellKey( x, z ) );
+			}
+		}
+	}
+	std::sort( m_view_cells.begin(), m_view_cells.end() );
+	m_view_cells.erase( std::unique( m_view_cells.begin(), m_view_cells.end() ), m_view_cells.end() );
+
+	for( uint64_t cell : m_view_cells )
+	{
+		bus->m_view_cells[cell].push_back( this );
+		auto entities = bus->m_entity_cells.find( cell );
+		if( entities != bus->m_entity_cells.end() )
+		{
+			candidates.insert( candidates.end(), entities->second.begin(), entities->second.end() );
+		}
+	}
+	for( const auto& checkout_pair : m_checked_out )
+	{
+		candidates.push_back( checkout_pair.first );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* GatherEntityOps
+* Diffs one entity against what we have checked out of it, once per pass.
+*/
+void LocalConnection::GatherEntityOps( LocalWorkerBus* bus, worker::EntityId id, std::vector<local_op_t>& out )
+{
+	auto checkout_itr = m_checked_out.find( id );
+	if( checkout_itr != m_checked_out.end() && checkout_itr->second.pass == m_pass )
+	{
+		return;
+	}
+
+	// Deleted or out of view.
+	LocalWorkerBus::local_entity_t* entity = bus->FindEntity( id );
+	if( !entity || !IsInView( bus, *entity ) )
+	{
+		if( checkout_itr != m_checked_out.end() )
+		{
+			out.push_back( [id]( WorkerDispatcher& dispatcher ) { dispatcher.RemoveEntity( id ); } );
+			m_checked_out.erase( checkout_itr );
+			if( entity )
+			{
+				EraseValue( entity->watchers, this );
+			}
+		}
+		return;
+	}
+
+	if( checkout_itr == m_checked_out.end() )
+	{
+		checkout_itr = m_checked_out.emplace( id, checkout_t() ).first;
+		entity->watchers.push_back( this );
+		out.push_back( [id]( WorkerDispatcher& dispatcher ) { dispatcher.AddEntity( id ); } );
+	}
+	checkout_t& checkout = checkout_itr->second;
+	checkout.pass = m_pass;
+
+	for( int idx = 0; idx < LOCAL_TRACKED_COMPONENT_COUNT; ++idx )
+	{
+		if( entity->versions[idx] != checkout.versions[idx] )
+		{
+			switch( idx )
+			{
+			case 0: GatherComponentOp<improbable::Position>( out, id, entity->data, checkout.versions[idx] ); break;
+			case 1: GatherComponentOp<improbable::Metadata>( out, id, entity->data, checkout.versions[idx] ); break;
+			case 2: GatherComponentOp<siren::PlayerControls>( out, id, entity->data, checkout.versions[idx] ); break;
+			case 3: GatherComponentOp<siren::PlayerMovement>( out, id, entity->data, checkout.versions[idx] ); break;
+			case 4: GatherComponentOp<siren::PlanePosition>( out, id, entity->data, checkout.versions[idx] ); break;
+			}
+			checkout.versions[idx] = entity->versions[idx];
+		}
+	}
+
+	for( int idx = 0; idx < LOCAL_AUTHORITY_COMPONENT_COUNT; ++idx )
+	{
+		bool authoritative = entity->authority[idx] == this;
+		if( authoritative != checkout.authoritative[idx] )
+		{
+			worker::ComponentId component_id = LOCAL_AUTHORITY_COMPONENTS[idx];
+			worker::Authority authority = authoritative ? worker::Authority::kAuthoritative : worker::Authority::kNotAuthoritative;
+			out.push_back( [id, component_id, authority]( WorkerDispatcher& dispatcher ) { dispatcher.ChangeAuthority( id, component_id, authority ); } );
+			checkout.authoritative[idx] = authoritative;
+		}
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* GatherStateOps
+* Only the entities the bus marked dirty for us, plus the ones around us when our view moved.
+*/
+void LocalConnection::GatherStateOps( std::vector<local_op_t>& out )
+{
+	if( !m_rescan && !m_view_dirty && m_dirty.empty() )
+	{
+		return;
+	}
+	LocalWorkerBus* bus = m_bus;
+	++m_pass;
+
+	std::vector<worker::EntityId> candidates( m_dirty.begin(), m_dirty.end() );
+	m_dirty.clear();
+	if( m_rescan )
+	{
+		m_rescan = false;
+		for( const auto& entity_pair : bus->m_entities )
+		{
+			candidates.push_back( entity_pair.first );
+		}
+	}
+	if( m_view_dirty )
+	{
+		m_view_dirty = false;
+		if( !m_sees_everything )
+		{
+			RebuildView( bus, candidates );
+		}
+	}
+
+	for( worker::EntityId id : candidates )
+	{
+		GatherEntityOps( bus, id, out );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* ApplyUpdate
+* Like the runtime, updates from a worker without authority are dropped.
+* Components past the tracked ones are only stored, nobody is sent them.
+*/
+template <typename T>
+void LocalConnection::ApplyUpdate( worker::EntityId entity_id, int tracked_index, const typename T::Update& update )
+{
+	LocalWorkerBus* bus = m_bus;
+	if( !bus )
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> lg( bus->m_lock );
+	LocalWorkerBus::local_entity_t* entity = bus->FindEntity( entity_id );
+	if( !entity || entity->authority[tracked_index] != this || !entity->data.Get<T>() )
+	{
+		return;
+	}
+
+	entity->data.Update<T>( update );
+	if( tracked_index < LOCAL_TRACKED_COMPONENT_COUNT )
+	{
+		bus->MarkChanged();
+		entity->versions[tracked_index] = bus->m_version;
+		if( T::ComponentId == improbable::Position::ComponentId )
+		{
+			bus->UpdateCell( entity_id, *entity );
+			if( entity->authority[2] )
+			{
+				entity->authority[2]->m_view_dirty = true;
+			}
+		}
+		bus->MarkEntityDirty( entity_id, *entity );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* RouteCommand
+* Commands go to whoever is authoritative on the entity's ServerAPI.
+*/
+template <typename T>
+worker::Option<uint64_t> LocalConnection::RouteCommand( worker::EntityId entity_id, const typename T::Request& request )
+{
+	LocalWorkerBus* bus = m_bus;
+	if( !bus )
+	{
+		return {};
+	}
+	std::lock_guard<std::mutex> lg( bus->m_lock );
+	uint64_t request_id = m_next_request_id++;
+
+	LocalWorkerBus::local_entity_t* entity = bus->FindEntity( entity_id );
+	LocalConnection* target = entity ? entity->authority[5] : nullptr;
+	if( !target )
+	{
+		FailCommand<T>( this, m_queued_ops, request_id, entity_id, "No worker is authoritative over the command" );
+		bus->m_changed.notify_all();
+		return worker::Option<uint64_t>( request_id );
+	}
+
+	LocalWorkerBus::pending_command_t pending;
+	pending.caller = this;
+	pending.target = target;
+	pending.caller_request_id = request_id;
+	pending.entity_id = entity_id;
+	pending.fail = &FailCommand<T>;
+	uint64_t command_id = bus->m_next_command_id++;
+	bus->m_pending_commands[command_id] = pending;
+
+	command_request_t<T> op;
+	op.request_id = command_id;
+	op.entity_id = entity_id;
+	op.caller_worker_id = m_worker_id;
+	op.request = request;
+	target->m_queued_ops.push_back( [op]( WorkerDispatcher& dispatcher ) { dispatcher.DispatchCommandRequest( op ); } );
+	bus->m_changed.notify_all();
+	return worker::Option<uint64_t>( request_id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* RespondToCommand
+*/
+template <typename T>
+void LocalConnection::RespondToCommand( uint64_t request_id, const typename T::Response& response )
+{
+	LocalWorkerBus* bus = m_bus;
+	if( !bus )
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> lg( bus->m_lock );
+	auto found = bus->m_pending_commands.find( request_id );
+	if( found == bus->m_pending_commands.end() || found->second.target != this )
+	{
+		return;
+	}
+
+	LocalWorkerBus::pending_command_t pending = found->second;
+	bus->m_pending_commands.erase( found );
+	if( !pending.caller )
+	{
+		return;
+	}
+
+	command_response_t<T> op;
+	op.request_id = pending.caller_request_id;
+	op.entity_id = pending.entity_id;
+	op.response = response;
+	pending.caller->m_queued_ops.push_back( [op]( WorkerDispatcher& dispatcher ) { dispatcher.DispatchCommandResponse( op ); } );
+	bus->m_changed.notify_all();
+}
@@ -0,0 +1,219 @@
+#pragma once
+#include "Shared/WorkerConnection.hpp"
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+class LocalConnection;
+
+struct local_bus_settings_t
+{
+	float client_view_radius = 20.5f;		// Half extent of the box a client sees around entities it controls.
+};
+
+// One op waiting to be handed to a WorkerDispatcher.
+typedef std::function<void( WorkerDispatcher& )> local_op_t;
+
+// Components the bus hands out authority for. The first LOCAL_TRACKED_COMPONENT_COUNT
+// are also the ones it replicates to workers.
+constexpr int LOCAL_TRACKED_COMPONENT_COUNT = 5;
+constexpr int LOCAL_AUTHORITY_COMPONENT_COUNT = 7;
+constexpr worker::ComponentId LOCAL_AUTHORITY_COMPONENTS[LOCAL_AUTHORITY_COMPONENT_COUNT] = {
+	improbable::Position::ComponentId,
+	improbable::Metadata::ComponentId,
+	siren::PlayerControls::ComponentId,
+	siren::PlayerMovement::ComponentId,
+	siren::PlanePosition::ComponentId,
+	siren::ServerAPI::ComponentId,
+	siren::ClientHeartbeat::ComponentId
+};
+
+//--------------------------------------------------------------------------
+// In-process stand-in for a SpatialOS deployment. Any number of workers connect
+// through LocalConnections and see each other's entities, updates and commands
+// without a receptionist or a network.
+// Authority comes from each entity's EntityAcl write list, first connected match wins.
+// Workers with the "simulation" attribute see every entity, the rest only what's within
+// client_view_radius of an entity they hold PlayerControls authority on.
+// Changes are routed as they happen to the connections that can see them: simulation
+// workers, whoever has the entity checked out, and clients whose view covers its grid
+// cell. Each connection only diffs those entities when it processes, so the cost is per
+// change per interested worker rather than per entity per worker.
+//--------------------------------------------------------------------------
+class LocalWorkerBus
+{
+	friend class LocalConnection;
+
+public:
+	LocalWorkerBus( const local_bus_settings_t& settings = local_bus_settings_t() );
+	~LocalWorkerBus();
+
+	// Not copyable, connections point back at it.
+	LocalWorkerBus( const LocalWorkerBus& ) = delete;
+	LocalWorkerBus& operator=( const LocalWorkerBus& ) = delete;
+
+public:
+	// Caller owns the connection, deleting it disconnects. "Managed" workers get the
+	// "simulation" attribute, anything else "client".
+	LocalConnection* Connect( const std::string& worker_type, const std::string& worker_id );
+
+	// Like loading an entity from a snapshot.
+	bool AddEntity( worker::EntityId id, const worker::Entity& entity );
+
+	size_t GetEntityCount() const;
+	size_t GetConnectionCount() const;
+
+private:
+	struct local_entity_t
+	{
+		worker::Entity data;
+		uint64_t versions[LOCAL_TRACKED_COMPONENT_COUNT] = {};					// When each tracked component last changed, 0 if missing.
+		LocalConnection* authority[LOCAL_AUTHORITY_COMPONENT_COUNT] = {};
+		std::vector<LocalConnection*> watchers;		// Connections that have it checked out.
+		uint64_t cell = 0;
+		bool has_cell = false;						// Only entities with a Position are in the grid.
+	};
+
+	struct pending_command_t
+	{
+		LocalConnection* caller = nullptr;
+		LocalConnection* target = nullptr;
+		uint64_t caller_request_id = 0;
+		worker::EntityId entity_id = 0;
+		void ( *fail )( LocalConnection* caller, std::vector<local_op_t>& caller_ops, uint64_t caller_request_id, worker::EntityId entity_id, const std::string& message ) = nullptr;
+	};
+
+	// All of these expect m_lock to be held.
+	void InsertEntity( worker::EntityId id, const worker::Entity& entity );
+	void ResolveAuthority( worker::EntityId id, local_entity_t& entity );
+	void ResolveAllAuthority();
+	void MarkChanged();
+	void MarkEntityDirty( worker::EntityId id, const local_entity_t& entity );
+	void UpdateCell( worker::EntityId id, local_entity_t& entity );
+	void EraseEntity( worker::EntityId id );
+	double GetCellSize() const;
+	local_entity_t* FindEntity( worker::EntityId id );
+	void Disconnect( LocalConnection* connection );
+
+private:
+	local_bus_settings_t m_settings;
+
+	mutable std::mutex m_lock;
+	std::condition_variable m_changed;
+
+	std::unordered_map<worker::EntityId, local_entity_t> m_entities;
+	std::vector<LocalConnection*> m_connections;
+	std::vector<LocalConnection*> m_simulation_connections;						// Of those, the ones that see everything.
+	std::unordered_map<uint64_t, pending_command_t> m_pending_commands;
+
+	// Grid cells client_view_radius across, so a client's view box covers at most nine.
+	std::unordered_map<uint64_t, std::vector<worker::EntityId>> m_entity_cells;
+	std::unordered_map<uint64_t, std::vector<LocalConnection*>> m_view_cells;	// Clients whose view box overlaps the cell.
+
+	worker::EntityId m_next_entity_id = 1;
+	uint64_t m_next_command_id = 1;
+	uint64_t m_version = 1;				// Bumped on every change, component versions come from it.
+
+};
+
+//--------------------------------------------------------------------------
+// WorkerConnection onto a LocalWorkerBus. Safe to use from a different thread
+// than other connections on the same bus.
+// Outliving the bus is fine, sends after that go nowhere like on a dropped connection.
+//--------------------------------------------------------------------------
+class LocalConnection
+	: public WorkerConnection
+{
+	friend class LocalWorkerBus;
+
+public:
+	~LocalConnection();
+
+	LocalConnection( const LocalConnection& ) = delete;
+	LocalConnection& operator=( const LocalConnection& ) = delete;
+
+public:
+	bool IsConnected() const override;
+	const std::string& GetWorkerId() const override { return m_worker_id; }
+	void Process( WorkerDispatcher& dispatcher, uint32_t timeout_millis ) override;
+
+public:
+	void SendLogMessage( worker::LogLevel level, const std::string& logger_name, const std::string& message ) override;
+
+	void SendComponentUpdate( worker::EntityId entity_id, const improbable::Position::Update& update ) override;
+	void SendComponentUpdate( worker::EntityId entity_id, const siren::PlayerControls::Update& update ) override;
+	void SendComponentUpdate( worker::EntityId entity_id, const siren::PlayerMovement::Update& update ) override;
+	void SendComponentUpdate( worker::EntityId entity_id, const siren::PlanePosition::Update& update ) override;
+	void SendComponentUpdate( worker::EntityId entity_id, const siren::ClientHeartbeat::Update& update ) override;
+
+	uint64_t SendReserveEntityIdsRequest( uint32_t count ) override;
+	worker::Option<uint64_t> SendCreateEntityRequest( const worker::Entity& entity, const worker::Option<worker::EntityId>& entity_id ) override;
+	uint64_t SendDeleteEntityRequest( worker::EntityId entity_id ) override;
+	uint64_t SendEntityQueryRequest( worker::ComponentId component_id ) override;
+
+	worker::Option<uint64_t> SendCommandRequest( worker::EntityId entity_id, const CreateClientEntity::Request& request ) override;
+	worker::Option<uint64_t> SendCommandRequest( worker::EntityId entity_id, const DeleteClientEntity::Request& request ) override;
+	worker::Option<uint64_t> SendCommandRequest( worker::EntityId entity_id, const ClientPing::Request& request ) override;
+	void SendCommandResponse( uint64_t request_id, const CreateClientEntity::Response& response ) override;
+	void SendCommandResponse( uint64_t request_id, const DeleteClientEntity::Response& response ) override;
+	void SendCommandResponse( uint64_t request_id, const ClientPing::Response& response ) override;
+
+private:
+	LocalConnection( LocalWorkerBus* bus, const std::string& worker_id, const std::vector<std::string>& attributes );
+
+	struct checkout_t
+	{
+		uint64_t versions[LOCAL_TRACKED_COMPONENT_COUNT] = {};
+		bool authoritative[LOCAL_AUTHORITY_COMPONENT_COUNT] = {};
+		uint32_t pass = 0;
+	};
+
+	struct anchor_t
+	{
+		double x;
+		double z;
+	};
+
+	// Bus lock held for these.
+	bool Satisfies( const improbable::WorkerRequirementSet& requirement ) const;
+	bool HasStateChanges() const;
+	bool IsInView( const LocalWorkerBus* bus, const LocalWorkerBus::local_entity_t& entity ) const;
+	void RebuildView( LocalWorkerBus* bus, std::vector<worker::EntityId>& candidates );
+	void GatherEntityOps( LocalWorkerBus* bus, worker::EntityId id, std::vector<local_op_t>& out );
+	void GatherStateOps( std::vector<local_op_t>& out );
+	template <typename T>
+	void ApplyUpdate( worker::EntityId entity_id, int tracked_index, const typename T::Update& update );
+	template <typename T>
+	worker::Option<uint64_t> RouteCommand( worker::EntityId entity_id, const typename T::Request& request );
+	template <typename T>
+	void RespondToCommand( uint64_t request_id, const typename T::Response& response );
+
+private:
+	std::atomic<LocalWorkerBus*> m_bus{ nullptr };		// Nulled by ~LocalWorkerBus from whichever thread owns the bus.
+	std::string m_worker_id;
+	std::vector<std::string> m_attributes;
+	bool m_sees_everything = false;
+
+	uint64_t m_next_request_id = 1;
+	uint32_t m_pass = 0;
+
+	std::vector<local_op_t> m_queued_ops;			// Responses and commands, ahead of any state change.
+	std::unordered_map<worker::EntityId, checkout_t> m_checked_out;
+
+	// Filled by the bus as changes happen, emptied by GatherStateOps.
+	std::unordered_set<worker::EntityId> m_dirty;
+	bool m_rescan = false;							// Diff every entity, for a simulation worker that just connected.
+	bool m_view_dirty = false;						// Something we control moved, was added or taken away.
+
+	// Clients only, what they see is around the entities they hold PlayerControls authority on.
+	std::unordered_set<worker::EntityId> m_controlled;
+	std::vector<anchor_t> m_anchors;
+	std::vector<uint64_t> m_view_cells;
+
+};
@@ -0,0 +1,153 @@
+#include "Shared/MappedFile.hpp"
+
+#if defined( _WIN32 )
+	#define WIN32_LEAN_AND_MEAN
+	#include <windows.h>
+#else
+	#include <cstdio>
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#endif
+
+//--------------------------------------------------------------------------
+/**
+* ~MappedFile
+*/
+MappedFile::~MappedFile()
+{
+	Close();
+}
+
+#if defined( _WIN32 )
+
+//--------------------------------------------------------------------------
+/**
+* Open
+*/
+bool MappedFile::Open( const std::string& path )
+{
+	Close();
+
+	HANDLE file = CreateFileA( path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr );
+	if( file == INVALID_HANDLE_VALUE )
+	{
+		return false;
+	}
+
+	LARGE_INTEGER size;
+	if( !GetFileSizeEx( file, &size ) || size.QuadPart == 0 )
+	{
+		CloseHandle( file );
+		return false;
+	}
+
+	HANDLE mapping = CreateFileMappingA( file, nullptr, PAGE_READONLY, 0, 0, nullptr );
+	void* data = mapping ? MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) : nullptr;
+	if( !data )
+	{
+		if( mapping )
+		{
+			CloseHandle( mapping );
+		}
+		CloseHandle( file );
+		return false;
+	}
+
+	m_file = file;
+	m_mapping = mapping;
+	m_data = (const uint8_t*)data;
+	m_size = (size_t)size.QuadPart;
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Close
+*/
+void MappedFile::Close()
+{
+	if( m_data )
+	{
+		UnmapViewOfFile( m_data );
+		CloseHandle( (HANDLE)m_mapping );
+		CloseHandle( (HANDLE)m_file );
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_file = nullptr;
+	m_mapping = nullptr;
+}
+
+//--------------------------------------------------------------------------
+/**
+* MoveOver
+* rename fails when to exists here.
+*/
+bool MappedFile::MoveOver( const std::string& from, const std::string& to )
+{
+	return MoveFileExA( from.c_str(), to.c_str(), MOVEFILE_REPLACE_EXISTING ) != 0;
+}
+
+#else
+
+//--------------------------------------------------------------------------
+/**
+* Open
+*/
+bool MappedFile::Open( const std::string& path )
+{
+	Close();
+
+	int fd = open( path.c_str(), O_RDONLY );
+	if( fd < 0 )
+	{
+		return false;
+	}
+
+	struct stat info;
+	if( fstat( fd, &info ) != 0 || info.st_size <= 0 )
+	{
+		close( fd );
+		return false;
+	}
+
+	// The mapping keeps the file alive on its own.
+	void* data = mmap( nullptr, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0 );
+	close( fd );
+	if( data == MAP_FAILED )
+	{
+		return false;
+	}
+
+	m_data = (const uint8_t*)data;
+	m_size = (size_t)info.st_size;
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Close
+*/
+void MappedFile::Close()
+{
+	if( m_data )
+	{
+		munmap( (void*)m_data, m_size );
+	}
+	m_data = nullptr;
+	m_size = 0;
+}
+
+//--------------------------------------------------------------------------
+/**
+* MoveOver
+* rename replaces to atomically, anything that has it mapped keeps the old file.
+*/
+bool MappedFile::MoveOver( const std::string& from, const std::string& to )
+{
+	return rename( from.c_str(), to.c_str() ) == 0;
+}
+
+#endif
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+//--------------------------------------------------------------------------
+// Read only view of a whole file mapped into memory. Pages are brought in as
+// they're touched, so opening costs the same however big the file is.
+//--------------------------------------------------------------------------
+class MappedFile
+{
+public:
+	MappedFile() {};
+	~MappedFile();
+
+	// Not copyable, owns the mapping.
+	MappedFile( const MappedFile& ) = delete;
+	MappedFile& operator=( const MappedFile& ) = delete;
+
+public:
+	bool Open( const std::string& path );
+	void Close();
+
+	bool IsOpen() const					{ return m_data != nullptr; }
+	const uint8_t* GetData() const		{ return m_data; }
+	size_t GetSize() const				{ return m_size; }
+
+	// For writers of files that get mapped. Moves from over to in one step, so a reader or
+	// a crash sees either the old file or the new one, never neither.
+	static bool MoveOver( const std::string& from, const std::string& to );
+
+private:
+	const uint8_t* m_data = nullptr;
+	size_t m_size = 0;
+
+#if defined( _WIN32 )
+	void* m_file = nullptr;
+	void* m_mapping = nullptr;
+#endif
+};
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <new>
+#include <vector>
+
+//--------------------------------------------------------------------------
+// Counters for one pool. high_water is the most blocks ever live at once.
+//--------------------------------------------------------------------------
+struct pool_stats_t
+{
+	uint32_t live = 0;
+	uint32_t high_water = 0;
+	uint32_t capacity = 0;
+	uint64_t allocations = 0;
+	uint64_t fallbacks = 0;		// Requests that didn't fit a block and went to the global heap.
+};
+
+//--------------------------------------------------------------------------
+// Fixed size blocks for objects of type T, carved out of slabs that are never
+// handed back until the pool dies. Freed blocks go on an intrusive free list.
+// Used through class level operator new/delete so callers keep using new and delete.
+//--------------------------------------------------------------------------
+template <typename T, size_t BLOCKS_PER_SLAB = 64>
+class ObjectPool
+{
+public:
+	ObjectPool() = default;
+	~ObjectPool()
+	{
+		for( void* slab : m_slabs )
+		{
+			::operator delete( slab );
+		}
+	}
+
+	ObjectPool( const ObjectPool& ) = delete;
+	ObjectPool& operator=( const ObjectPool& ) = delete;
+
+public:
+	void* Allocate( size_t size )
+	{
+		std::lock_guard<std::mutex> lock( m_lock );
+		// Derived types are bigger than the block, let the heap have them.
+		if( size > BLOCK_SIZE )
+		{
+			++m_stats.fallbacks;
+			return ::operator new( size );
+		}
+
+		if( !m_free_list )
+		{
+			AddSlab();
+		}
+		free_block_t* block = m_free_list;
+		m_free_list = block->next;
+
+		++m_stats.allocations;
+		if( ++m_stats.live > m_stats.high_water )
+		{
+			m_stats.high_water = m_stats.live;
+		}
+		return block;
+	}
+
+	void Free( void* ptr, size_t size )
+	{
+		if( !ptr )
+		{
+			return;
+		}
+
+		std::lock_guard<std::mutex> lock( m_lock );
+		if( size > BLOCK_SIZE )
+		{
+			::operator delete( ptr );
+			return;
+		}
+
+		free_block_t* block = (free_block_t*) ptr;
+		block->next = m_free_list;
+		m_free_list = block;
+		--m_stats.live;
+	}
+
+	// Grows the pool up front so the first burst doesn't hit the heap.
+	void Reserve( uint32_t count )
+	{
+		std::lock_guard<std::mutex> lock( m_lock );
+		while( m_stats.capacity - m_stats.live < count )
+		{
+			AddSlab();
+		}
+	}
+
+	pool_stats_t GetStats() const
+	{
+		std::lock_guard<std::mutex> lock( m_lock );
+		return m_stats;
+	}
+
+private:
+	struct free_block_t
+	{
+		free_block_t* next;
+	};
+
+	static constexpr size_t ALIGNMENT = alignof( T ) > alignof( free_block_t ) ? alignof( T ) : alignof( free_block_t );
+	static constexpr size_t RAW_SIZE = sizeof( T ) > sizeof( free_block_t ) ? sizeof( T ) : sizeof( free_block_t );
+	static constexpr size_t BLOCK_SIZE = ( RAW_SIZE + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT;
+
+	static_assert( ALIGNMENT <= alignof( std::max_align_t ), "ObjectPool slabs are only max_align_t aligned" );
+
+	void AddSlab()
+	{
+		unsigned char* slab = (unsigned char*) ::operator new( BLOCK_SIZE * BLOCKS_PER_SLAB );
+		m_slabs.push_back( slab );
+
+		// Thread the new blocks onto the free list back to front so they come out in address order.
+		for( size_t idx = BLOCKS_PER_SLAB; idx > 0; --idx )
+		{
+			free_block_t* block = (free_block_t*)( slab + ( idx - 1 ) * BLOCK_SIZE );
+			block->next = m_free_list;
+			m_free_list = block;
+		}
+		m_stats.capacity += (uint32_t) BLOCKS_PER_SLAB;
+	}
+
+private:
+	mutable std::mutex m_lock;
+	std::vector<void*> m_slabs;
+	free_block_t* m_free_list = nullptr;
+	pool_stats_t m_stats;
+
+};
\ No newline at end of file
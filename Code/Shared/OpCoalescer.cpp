@@ -0,0 +1,352 @@
+#include "Shared/OpCoalescer.hpp"
+
+//--------------------------------------------------------------------------
+/**
+* OpCoalescer
+*/
+OpCoalescer::OpCoalescer()
+{
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* ~OpCoalescer
+*/
+OpCoalescer::~OpCoalescer()
+{
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* Flush
+*/
+void OpCoalescer::Flush( WorkerDispatcher& target )
+{
+	for( const pending_op_t& op : m_ops )
+	{
+		if( op.dropped )
+		{
+			continue;
+		}
+		++m_stats.applied;
+
+		switch( op.type )
+		{
+		case PENDING_ADD_ENTITY:
+			target.AddEntity( op.id );
+			break;
+		case PENDING_REMOVE_ENTITY:
+			target.RemoveEntity( op.id );
+			break;
+		case PENDING_ADD_COMPONENT:
+		case PENDING_UPDATE_COMPONENT:
+			FlushComponentOp<improbable::Position>( op, target )
+				|| FlushComponentOp<improbable::Metadata>( op, target )
+				|| FlushComponentOp<siren::PlayerControls>( op, target )
+				|| FlushComponentOp<siren::PlayerMovement>( op, target )
+				|| FlushComponentOp<siren::PlanePosition>( op, target );
+			break;
+		case PENDING_REMOVE_COMPONENT:
+			target.RemoveComponent( op.id, op.component_id );
+			break;
+		case PENDING_CHANGE_AUTHORITY:
+			target.ChangeAuthority( op.id, op.component_id, op.authority );
+			break;
+		}
+	}
+
+	m_ops.clear();
+	m_added_entities.clear();
+	m_components.clear();
+	m_entity_components.clear();
+	std::apply( []( auto&... payloads ) { ( ( payloads.adds.clear(), payloads.updates.clear() ), ... ); }, m_payloads );
+}
+
+//--------------------------------------------------------------------------
+/**
+* AddEntity
+*/
+void OpCoalescer::AddEntity( worker::EntityId id )
+{
+	++m_stats.received;
+	ForgetComponents( id, false );
+
+	pending_op_t op;
+	op.type = PENDING_ADD_ENTITY;
+	op.id = id;
+	m_added_entities[id] = Push( op );
+}
+
+//--------------------------------------------------------------------------
+/**
+* RemoveEntity
+* Checked out and back in within one batch, nobody needs to hear about it.
+*/
+void OpCoalescer::RemoveEntity( worker::EntityId id )
+{
+	++m_stats.received;
+	ForgetComponents( id, true );
+
+	auto added = m_added_entities.find( id );
+	if( added != m_added_entities.end() )
+	{
+		for( uint32_t op_index = added->second; op_index < (uint32_t) m_ops.size(); ++op_index )
+		{
+			if( m_ops[op_index].id == id && !m_ops[op_index].dropped )
+			{
+				Drop( op_index );
+			}
+		}
+		m_added_entities.erase( added );
+		++m_stats.cancelled;
+		return;
+	}
+
+	pending_op_t op;
+	op.type = PENDING_REMOVE_ENTITY;
+	op.id = id;
+	Push( op );
+}
+
+//--------------------------------------------------------------------------
+/**
+* RemoveComponent
+*/
+void OpCoalescer::RemoveComponent( worker::EntityId id, worker::ComponentId component_id )
+{
+	++m_stats.received;
+
+	auto found = m_components.find( { id, component_id } );
+	if( found != m_components.end() )
+	{
+		pending_component_t pending = found->second;
+		m_components.erase( found );
+
+		if( pending.add != NO_OP )
+		{
+			// Added in this batch, the add and everything since goes.
+			Drop( pending.add );
+			if( pending.authority != NO_OP )
+			{
+				Drop( pending.authority );
+			}
+			++m_stats.cancelled;
+			return;
+		}
+
+		// Authority is kept, it still has to be given up before the component goes.
+		if( pending.update != NO_OP )
+		{
+			Drop( pending.update );
+		}
+	}
+
+	pending_op_t op;
+	op.type = PENDING_REMOVE_COMPONENT;
+	op.id = id;
+	op.component_id = component_id;
+	Push( op );
+}
+
+//--------------------------------------------------------------------------
+/**
+* ChangeAuthority
+*/
+void OpCoalescer::ChangeAuthority( worker::EntityId id, worker::ComponentId component_id, worker::Authority authority )
+{
+	++m_stats.received;
+
+	pending_component_t& pending = GetPending( id, component_id );
+	if( pending.authority != NO_OP )
+	{
+		m_ops[pending.authority].authority = authority;
+		++m_stats.merged;
+		return;
+	}
+
+	pending_op_t op;
+	op.type = PENDING_CHANGE_AUTHORITY;
+	op.id = id;
+	op.component_id = component_id;
+	op.authority = authority;
+	pending.authority = Push( op );
+}
+
+//--------------------------------------------------------------------------
+/**
+* Push
+*/
+uint32_t OpCoalescer::Push( const pending_op_t& op )
+{
+	m_ops.push_back( op );
+	return (uint32_t) m_ops.size() - 1;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Drop
+*/
+void OpCoalescer::Drop( uint32_t op_index )
+{
+	m_ops[op_index].dropped = true;
+	++m_stats.cancelled;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetPending
+*/
+OpCoalescer::pending_component_t& OpCoalescer::GetPending( worker::EntityId id, worker::ComponentId component_id )
+{
+	auto inserted = m_components.try_emplace( { id, component_id } );
+	if( inserted.second )
+	{
+		m_entity_components[id].push_back( component_id );
+	}
+	return inserted.first->second;
+}
+
+//--------------------------------------------------------------------------
+/**
+* ForgetComponents
+* Nothing after an entity is added or removed may fold into what came before,
+* authority for components without a payload included.
+*/
+void OpCoalescer::ForgetComponents( worker::EntityId id, bool drop_updates )
+{
+	auto components = m_entity_components.find( id );
+	if( components == m_entity_components.end() )
+	{
+		return;
+	}
+
+	for( worker::ComponentId component_id : components->second )
+	{
+		auto found = m_components.find( { id, component_id } );
+		if( found != m_components.end() )
+		{
+			if( drop_updates && found->second.update != NO_OP )
+			{
+				Drop( found->second.update );
+			}
+			m_components.erase( found );
+		}
+	}
+	m_entity_components.erase( components );
+}
+
+//--------------------------------------------------------------------------
+/**
+* FlushComponentOp
+*/
+template <typename T>
+bool OpCoalescer::FlushComponentOp( const pending_op_t& op, WorkerDispatcher& target )
+{
+	if( op.component_id != T::ComponentId )
+	{
+		return false;
+	}
+
+	pending_payloads_t<T>& payloads = GetPayloads<T>();
+	if( op.type == PENDING_ADD_COMPONENT )
+	{
+		target.AddComponent( op.id, payloads.adds[op.payload] );
+	}
+	else
+	{
+		target.UpdateComponent( op.id, payloads.updates[op.payload] );
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* MergeUpdate
+* Fields set in the later update win.
+*/
+void OpCoalescer::MergeUpdate( improbable::Position::Update& into, const improbable::Position::Update& from )
+{
+	if( from.coords() )
+	{
+		into.set_coords( *from.coords() );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* MergeUpdate
+*/
+void OpCoalescer::MergeUpdate( improbable::Metadata::Update& into, const improbable::Metadata::Update& from )
+{
+	if( from.entity_type() )
+	{
+		into.set_entity_type( *from.entity_type() );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* MergeUpdate
+*/
+void OpCoalescer::MergeUpdate( siren::PlayerControls::Update& into, const siren::PlayerControls::Update& from )
+{
+	if( from.x_move() )
+	{
+		into.set_x_move( *from.x_move() );
+	}
+	if( from.y_move() )
+	{
+		into.set_y_move( *from.y_move() );
+	}
+	if( from.sequence() )
+	{
+		into.set_sequence( *from.sequence() );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* MergeUpdate
+*/
+void OpCoalescer::MergeUpdate( siren::PlayerMovement::Update& into, const siren::PlayerMovement::Update& from )
+{
+	if( from.input_sequence() )
+	{
+		into.set_input_sequence( *from.input_sequence() );
+	}
+	if( from.position() )
+	{
+		into.set_position( *from.position() );
+	}
+	if( from.velocity() )
+	{
+		into.set_velocity( *from.velocity() );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* MergeUpdate
+* Keyframe and delta are separate fields, so a keyframe followed by deltas merges to the same position.
+*/
+void OpCoalescer::MergeUpdate( siren::PlanePosition::Update& into, const siren::PlanePosition::Update& from )
+{
+	if( from.keyframe_x() )
+	{
+		into.set_keyframe_x( *from.keyframe_x() );
+	}
+	if( from.keyframe_y() )
+	{
+		into.set_keyframe_y( *from.keyframe_y() );
+	}
+	if( from.delta_x() )
+	{
+		into.set_delta_x( *from.delta_x() );
+	}
+	if( from.delta_y() )
+	{
+		into.set_delta_y( *from.delta_y() );
+	}
+}
@@ -0,0 +1,186 @@
+#pragma once
+#include "Shared/WorkerDispatcher.hpp"
+
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+struct op_coalesce_stats_t
+{
+	uint64_t received = 0;			// State ops handed in.
+	uint64_t applied = 0;			// State ops handed on.
+	uint64_t merged = 0;			// Updates and authority changes folded into an earlier op.
+	uint64_t cancelled = 0;			// Dropped because an add was undone before it was applied.
+};
+
+//--------------------------------------------------------------------------
+// Sits between a connection and the WorkerDispatcher it feeds and buffers entity
+// and component state ops until Flush. While buffered, updates to the same
+// component of the same entity become one update, an update to a component added
+// in the same batch is folded into the add, repeated authority changes keep the
+// last, and an add undone by a remove in the same batch is dropped with
+// everything in between. Ops for different entities keep their order, so do
+// adds and removes of the same one.
+// Anything that isn't state should be dispatched after a Flush so it still sees
+// the state it followed.
+//--------------------------------------------------------------------------
+class OpCoalescer
+	: public WorkerDispatcher
+{
+public:
+	OpCoalescer();
+	~OpCoalescer();
+
+public:
+	void Flush( WorkerDispatcher& target );
+	const op_coalesce_stats_t& GetStats() const		{ return m_stats; }
+
+public:
+	// WorkerDispatcher
+	void AddEntity( worker::EntityId id ) override;
+	void RemoveEntity( worker::EntityId id ) override;
+	void AddComponent( worker::EntityId id, const improbable::PositionData& data ) override				{ PendAdd<improbable::Position>( id, data ); }
+	void AddComponent( worker::EntityId id, const improbable::MetadataData& data ) override				{ PendAdd<improbable::Metadata>( id, data ); }
+	void AddComponent( worker::EntityId id, const siren::PlayerControlsData& data ) override			{ PendAdd<siren::PlayerControls>( id, data ); }
+	void AddComponent( worker::EntityId id, const siren::PlayerMovementData& data ) override			{ PendAdd<siren::PlayerMovement>( id, data ); }
+	void AddComponent( worker::EntityId id, const siren::PlanePositionData& data ) override				{ PendAdd<siren::PlanePosition>( id, data ); }
+	void UpdateComponent( worker::EntityId id, const improbable::Position::Update& update ) override	{ PendUpdate<improbable::Position>( id, update ); }
+	void UpdateComponent( worker::EntityId id, const improbable::Metadata::Update& update ) override	{ PendUpdate<improbable::Metadata>( id, update ); }
+	void UpdateComponent( worker::EntityId id, const siren::PlayerControls::Update& update ) override	{ PendUpdate<siren::PlayerControls>( id, update ); }
+	void UpdateComponent( worker::EntityId id, const siren::PlayerMovement::Update& update ) override	{ PendUpdate<siren::PlayerMovement>( id, update ); }
+	void UpdateComponent( worker::EntityId id, const siren::PlanePosition::Update& update ) override	{ PendUpdate<siren::PlanePosition>( id, update ); }
+	void RemoveComponent( worker::EntityId id, worker::ComponentId component_id ) override;
+	void ChangeAuthority( worker::EntityId id, worker::ComponentId component_id, worker::Authority authority ) override;
+
+private:
+	static constexpr uint32_t NO_OP = 0xffffffff;
+
+	enum PendingOpType
+	{
+		PENDING_ADD_ENTITY,
+		PENDING_REMOVE_ENTITY,
+		PENDING_ADD_COMPONENT,
+		PENDING_UPDATE_COMPONENT,
+		PENDING_REMOVE_COMPONENT,
+		PENDING_CHANGE_AUTHORITY
+	};
+
+	struct pending_op_t
+	{
+		PendingOpType type = PENDING_ADD_ENTITY;
+		worker::EntityId id = 0;
+		worker::ComponentId component_id = 0;
+		uint32_t payload = NO_OP;				// Index into the component's adds or updates.
+		worker::Authority authority = worker::Authority::kNotAuthoritative;
+		bool dropped = false;
+	};
+
+	// Where this batch's ops for one component of one entity are, so later ones can fold in.
+	struct pending_component_t
+	{
+		uint32_t add = NO_OP;
+		uint32_t update = NO_OP;
+		uint32_t authority = NO_OP;
+	};
+
+	struct component_key_t
+	{
+		worker::EntityId id;
+		worker::ComponentId component_id;
+		bool operator==( const component_key_t& other ) const { return id == other.id && component_id == other.component_id; }
+	};
+
+	struct component_key_hash_t
+	{
+		size_t operator()( const component_key_t& key ) const { return std::hash<worker::EntityId>()( key.id ) ^ ( (size_t)key.component_id << 1 ); }
+	};
+
+	template <typename T>
+	struct pending_payloads_t
+	{
+		using Component = T;
+
+		std::vector<typename T::Data> adds;
+		std::vector<typename T::Update> updates;
+	};
+
+private:
+	uint32_t Push( const pending_op_t& op );
+	void Drop( uint32_t op_index );
+	void ForgetComponents( worker::EntityId id, bool drop_updates );
+	pending_component_t& GetPending( worker::EntityId id, worker::ComponentId component_id );
+
+	template <typename T>
+	bool FlushComponentOp( const pending_op_t& op, WorkerDispatcher& target );
+
+	template <typename T>
+	void PendAdd( worker::EntityId id, const typename T::Data& data )
+	{
+		++m_stats.received;
+		pending_payloads_t<T>& payloads = GetPayloads<T>();
+
+		pending_op_t op;
+		op.type = PENDING_ADD_COMPONENT;
+		op.id = id;
+		op.component_id = T::ComponentId;
+		op.payload = (uint32_t) payloads.adds.size();
+		payloads.adds.push_back( data );
+
+		pending_component_t& pending = GetPending( id, T::ComponentId );
+		pending = pending_component_t();
+		pending.add = Push( op );
+	}
+
+	template <typename T>
+	void PendUpdate( worker::EntityId id, const typename T::Update& update )
+	{
+		++m_stats.received;
+		pending_payloads_t<T>& payloads = GetPayloads<T>();
+		pending_component_t& pending = GetPending( id, T::ComponentId );
+		if( pending.add != NO_OP )
+		{
+			update.ApplyTo( payloads.adds[m_ops[pending.add].payload] );
+			++m_stats.merged;
+			return;
+		}
+		if( pending.update != NO_OP )
+		{
+			MergeUpdate( payloads.updates[m_ops[pending.update].payload], update );
+			++m_stats.merged;
+			return;
+		}
+
+		pending_op_t op;
+		op.type = PENDING_UPDATE_COMPONENT;
+		op.id = id;
+		op.component_id = T::ComponentId;
+		op.payload = (uint32_t) payloads.updates.size();
+		payloads.updates.push_back( update );
+		pending.update = Push( op );
+	}
+
+	template <typename T>
+	pending_payloads_t<T>& GetPayloads()	{ return std::get<pending_payloads_t<T>>( m_payloads ); }
+
+	static void MergeUpdate( improbable::Position::Update& into, const improbable::Position::Update& from );
+	static void MergeUpdate( improbable::Metadata::Update& into, const improbable::Metadata::Update& from );
+	static void MergeUpdate( siren::PlayerControls::Update& into, const siren::PlayerControls::Update& from );
+	static void MergeUpdate( siren::PlayerMovement::Update& into, const siren::PlayerMovement::Update& from );
+	static void MergeUpdate( siren::PlanePosition::Update& into, const siren::PlanePosition::Update& from );
+
+private:
+	std::vector<pending_op_t> m_ops;
+	std::unordered_map<worker::EntityId, uint32_t> m_added_entities;		// Entity id to its add in m_ops.
+	std::unordered_map<component_key_t, pending_component_t, component_key_hash_t> m_components;
+	std::unordered_map<worker::EntityId, std::vector<worker::ComponentId>> m_entity_components;	// Every component id of the entity's m_components entries.
+
+	std::tuple<
+		pending_payloads_t<improbable::Position>,
+		pending_payloads_t<improbable::Metadata>,
+		pending_payloads_t<siren::PlayerControls>,
+		pending_payloads_t<siren::PlayerMovement>,
+		pending_payloads_t<siren::PlanePosition>> m_payloads;
+
+	op_coalesce_stats_t m_stats;
+};
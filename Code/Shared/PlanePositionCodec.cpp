@@ -0,0 +1,149 @@
+#include "Shared/PlanePositionCodec.hpp"
+
+#include <cmath>
+#include <cstdlib>
+
+//--------------------------------------------------------------------------
+/**
+* QuantizePlaneCoordinate
+*/
+int32_t QuantizePlaneCoordinate( float value )
+{
+	return (int32_t) std::lround( value / PLANE_POSITION_QUANTUM );
+}
+
+//--------------------------------------------------------------------------
+/**
+* DequantizePlaneCoordinate
+*/
+float DequantizePlaneCoordinate( int32_t steps )
+{
+	return (float) steps * PLANE_POSITION_QUANTUM;
+}
+
+//--------------------------------------------------------------------------
+/**
+* EncodePlanePosition
+*/
+bool EncodePlanePosition( plane_position_encoder_t& encoder, const Vec2& position, const plane_position_settings_t& settings, siren::PlanePosition::Update& update )
+{
+	int32_t x = QuantizePlaneCoordinate( position.x );
+	int32_t y = QuantizePlaneCoordinate( position.y );
+	if( encoder.has_keyframe && x == encoder.keyframe_x + encoder.delta_x && y == encoder.keyframe_y + encoder.delta_y )
+	{
+		return false;
+	}
+
+	int32_t delta_x = x - encoder.keyframe_x;
+	int32_t delta_y = y - encoder.keyframe_y;
+	bool keyframe = !encoder.has_keyframe
+		|| encoder.updates_since_keyframe >= settings.keyframe_interval
+		|| std::abs( delta_x ) > settings.max_delta_steps
+		|| std::abs( delta_y ) > settings.max_delta_steps;
+
+	if( keyframe )
+	{
+		// Only what differs from the receiver's copy, the first keyframe has nothing to go on.
+		if( !encoder.has_keyframe || x != encoder.keyframe_x )
+		{
+			update.set_keyframe_x( x );
+		}
+		if( !encoder.has_keyframe || y != encoder.keyframe_y )
+		{
+			update.set_keyframe_y( y );
+		}
+		if( !encoder.has_keyframe || encoder.delta_x != 0 )
+		{
+			update.set_delta_x( 0 );
+		}
+		if( !encoder.has_keyframe || encoder.delta_y != 0 )
+		{
+			update.set_delta_y( 0 );
+		}
+		encoder.keyframe_x = x;
+		encoder.keyframe_y = y;
+		encoder.delta_x = 0;
+		encoder.delta_y = 0;
+		encoder.updates_since_keyframe = 0;
+		encoder.has_keyframe = true;
+		return true;
+	}
+
+	if( delta_x != encoder.delta_x )
+	{
+		update.set_delta_x( delta_x );
+	}
+	if( delta_y != encoder.delta_y )
+	{
+		update.set_delta_y( delta_y );
+	}
+	encoder.delta_x = delta_x;
+	encoder.delta_y = delta_y;
+	++encoder.updates_since_keyframe;
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* MakePlanePositionData
+*/
+siren::PlanePositionData MakePlanePositionData( const Vec2& position )
+{
+	siren::PlanePositionData data;
+	data.set_keyframe_x( QuantizePlaneCoordinate( position.x ) );
+	data.set_keyframe_y( QuantizePlaneCoordinate( position.y ) );
+	data.set_delta_x( 0 );
+	data.set_delta_y( 0 );
+	return data;
+}
+
+//--------------------------------------------------------------------------
+/**
+* DecodePlanePosition
+*/
+Vec2 DecodePlanePosition( const siren::PlanePositionData& data )
+{
+	return Vec2( DequantizePlaneCoordinate( data.keyframe_x() + data.delta_x() ), DequantizePlaneCoordinate( data.keyframe_y() + data.delta_y() ) );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetZigZagVarintSize
+* sint32 is zigzag encoded, small negative numbers stay small.
+*/
+static size_t GetZigZagVarintSize( int32_t value )
+{
+	uint32_t zigzag = ( (uint32_t) value << 1 ) ^ (uint32_t)( value >> 31 );
+	size_t size = 1;
+	while( zigzag >= 0x80 )
+	{
+		zigzag >>= 7;
+		++size;
+	}
+	return size;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetSerializedSize
+* Each field is a one byte tag, field ids are all below 16, then its zigzag varint.
+*/
+size_t GetSerializedSize( const siren::PlanePosition::Update& update )
+{
+	size_t size = 0;
+	size += update.keyframe_x() ? 1 + GetZigZagVarintSize( *update.keyframe_x() ) : 0;
+	size += update.keyframe_y() ? 1 + GetZigZagVarintSize( *update.keyframe_y() ) : 0;
+	size += update.delta_x() ? 1 + GetZigZagVarintSize( *update.delta_x() ) : 0;
+	size += update.delta_y() ? 1 + GetZigZagVarintSize( *update.delta_y() ) : 0;
+	return size;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetSerializedSize
+* Coordinates is a nested object of three doubles: tag and length, then a tag and eight bytes each.
+*/
+size_t GetSerializedSize( const improbable::Position::Update& update )
+{
+	return update.coords() ? 2 + 3 * ( 1 + 8 ) : 0;
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <improbable/worker.h>
+#include <improbable/standard_library.h>
+
+#include "ClientServer.h"
+
+#include "Engine/Math/Vec2.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+// World units per PlanePosition step. Finer than anything drawn, and a sint32 still covers far more world than we have.
+constexpr float PLANE_POSITION_QUANTUM = 1.0f / 64.0f;
+
+struct plane_position_settings_t
+{
+	uint32_t keyframe_interval = 30;	// Updates between keyframes, 0 to send every update as one.
+	int32_t max_delta_steps = 8191;		// Further from the keyframe starts a new one. 8191 still fits a two byte varint.
+};
+
+// What the receiving side holds for one entity, so only what changed needs to go out.
+struct plane_position_encoder_t
+{
+	int32_t keyframe_x = 0;
+	int32_t keyframe_y = 0;
+	int32_t delta_x = 0;
+	int32_t delta_y = 0;
+	uint32_t updates_since_keyframe = 0;
+	bool has_keyframe = false;
+};
+
+int32_t QuantizePlaneCoordinate( float value );
+float DequantizePlaneCoordinate( int32_t steps );
+
+// Fills update with the fields that differ from what the encoder last sent. False if the
+// position rounds to the same step, update is left alone then.
+bool EncodePlanePosition( plane_position_encoder_t& encoder, const Vec2& position, const plane_position_settings_t& settings, siren::PlanePosition::Update& update );
+
+// For a new entity, all keyframe. Encoders start without a keyframe so their first update is one anyway.
+siren::PlanePositionData MakePlanePositionData( const Vec2& position );
+Vec2 DecodePlanePosition( const siren::PlanePositionData& data );
+
+// Bytes the set fields take in the schema wire format, not counting the envelope every update pays.
+size_t GetSerializedSize( const siren::PlanePosition::Update& update );
+size_t GetSerializedSize( const improbable::Position::Update& update );
@@ -1,18 +1,50 @@
 #include "Shared/SharedCommon.hpp"
 #include "Shared/AbilityBaseDefinition.hpp"
 #include "Shared/ActorBaseDefinition.hpp"
+#include "Shared/AsyncLog.hpp"
+#include "Shared/DefinitionCache.hpp"
 
 #include "Engine/Core/XML/XMLUtils.hpp"
 
+static const char* kAbilityDefinitionsPath = "Data/Gameplay/AbilityDefinitions.xml";
+static const char* kActorDefinitionsPath = "Data/Gameplay/ActorDefinitions.xml";
 
 //--------------------------------------------------------------------------
 /**
-* LoadActors
+* OpenCurrentDefinitionCache
+* False when there's no cache or the XML changed since it was compiled.
 */
-void LoadActors()
+static bool OpenCurrentDefinitionCache( DefinitionCache& cache )
+{
+	if( !cache.Open( DEFINITION_CACHE_PATH ) )
+	{
+		return false;
+	}
+
+	// Without the XML there's nothing for the cache to be stale against.
+	definition_cache_source_t abilities_source;
+	definition_cache_source_t actors_source;
+	if( !DefinitionCache::GetSource( kAbilityDefinitionsPath, abilities_source ) || !DefinitionCache::GetSource( kActorDefinitionsPath, actors_source ) )
+	{
+		return true;
+	}
+	if( !cache.IsCurrent( abilities_source, actors_source ) )
+	{
+		LOG_WARNING( "Definitions", "%s doesn't match the XML, loading the XML until it's compiled again", DEFINITION_CACHE_PATH );
+		cache.Close();
+		return false;
+	}
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* LoadActorsFromXml
+*/
+static void LoadActorsFromXml()
 {
 	tinyxml2::XMLDocument gameConfig;
-	gameConfig.LoadFile("Data/Gameplay/ActorDefinitions.xml");
+	gameConfig.LoadFile(kActorDefinitionsPath);
 	XmlElement* root = gameConfig.RootElement();
 	for (XmlElement* element = root->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
 	{
@@ -22,15 +54,75 @@ void LoadActors()
 
 //--------------------------------------------------------------------------
 /**
-* LoadAbilities
+* LoadAbilitiesFromXml
 */
-void LoadAbilities()
+static void LoadAbilitiesFromXml()
 {
 	tinyxml2::XMLDocument gameConfig;
-	gameConfig.LoadFile("Data/Gameplay/AbilityDefinitions.xml");
+	gameConfig.LoadFile(kAbilityDefinitionsPath);
 	XmlElement* root = gameConfig.RootElement();
 	for (XmlElement* element = root->FirstChildElement(); element != nullptr; element = element->NextSiblingElement())
 	{
 		AbilityBaseDefinition::AddAbilityDefinition( *element );
 	}
 }
+
+//--------------------------------------------------------------------------
+/**
+* LoadActors
+*/
+void LoadActors()
+{
+	DefinitionCache cache;
+	if( !OpenCurrentDefinitionCache( cache ) )
+	{
+		LoadActorsFromXml();
+		return;
+	}
+
+	const definition_cache_actor_t* actors = cache.GetActors();
+	for( uint32_t idx = 0; idx < cache.GetActorCount(); ++idx )
+	{
+		ActorBaseDefinition::AddActorDefinition( actors[idx], cache );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* LoadAbilities
+*/
+void LoadAbilities()
+{
+	DefinitionCache cache;
+	if( !OpenCurrentDefinitionCache( cache ) )
+	{
+		LoadAbilitiesFromXml();
+		return;
+	}
+
+	const definition_cache_ability_t* abilities = cache.GetAbilities();
+	for( uint32_t idx = 0; idx < cache.GetAbilityCount(); ++idx )
+	{
+		AbilityBaseDefinition::AddAbilityDefinition( abilities[idx], cache );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* CompileDefinitions
+*/
+bool CompileDefinitions( const std::string& cache_path )
+{
+	definition_cache_source_t abilities_source;
+	definition_cache_source_t actors_source;
+	if( !DefinitionCache::GetSource( kAbilityDefinitionsPath, abilities_source ) || !DefinitionCache::GetSource( kActorDefinitionsPath, actors_source ) )
+	{
+		LOG_ERROR( "Definitions", "Couldn't find %s and %s", kAbilityDefinitionsPath, kActorDefinitionsPath );
+		return false;
+	}
+
+	// Same order as startup so ability ids get interned first.
+	LoadAbilitiesFromXml();
+	LoadActorsFromXml();
+	return DefinitionCache::Write( cache_path, abilities_source, actors_source );
+}
@@ -1,7 +1,13 @@
 
+#include <string>
 
 typedef unsigned int uint;
 
+// Compiled from the definition XML by DefCompiler, loaded in its place while current.
+#define DEFINITION_CACHE_PATH "Data/Gameplay/Definitions.cache"
 
 void LoadActors();
-void LoadAbilities();
\ No newline at end of file
+void LoadAbilities();
+
+// Loads both definition XMLs and writes them out as a definition cache.
+bool CompileDefinitions( const std::string& cache_path = DEFINITION_CACHE_PATH );
@@ -45,3 +45,31 @@ void SimController::SetMoveDirection( const Vec2& direction )
 {
 	m_moveDir = direction;
 }
+
+//--------------------------------------------------------------------------
+/**
+* operator new
+*/
+void* SimController::operator new( size_t size )
+{
+	return GetPool().Allocate( size );
+}
+
+//--------------------------------------------------------------------------
+/**
+* operator delete
+*/
+void SimController::operator delete( void* ptr, size_t size )
+{
+	GetPool().Free( ptr, size );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetPool
+*/
+ObjectPool<SimController>& SimController::GetPool()
+{
+	static ObjectPool<SimController> pool;
+	return pool;
+}
\ No newline at end of file
@@ -1,4 +1,5 @@
 #pragma once
+#include "Shared/ObjectPool.hpp"
 #include "Shared/ControllerBase.hpp"
 #include "Engine/Math/Vec2.hpp"
 
@@ -16,6 +17,13 @@ public:
 	~SimController();
 
 	virtual void Update( float deltaTime );
+	virtual ControllerKind GetKind() const { return CONTROLLER_SIM; }
+
+	// Allocations come out of the class pool, delete hands them back.
+	static void* operator new( size_t size );
+	static void operator delete( void* ptr, size_t size );
+	static ObjectPool<SimController>& GetPool();
+
 	void SetMoveDirection( const Vec2& direction );
 
 private:
@@ -0,0 +1,177 @@
+#include "Shared/SpatialHash.hpp"
+#include "Shared/EntityBase.hpp"
+
+#include <math.h>
+
+//--------------------------------------------------------------------------
+/**
+* SpatialHash
+*/
+SpatialHash::SpatialHash( float cell_size )
+{
+	SetCellSize( cell_size );
+}
+
+//--------------------------------------------------------------------------
+/**
+* ~SpatialHash
+*/
+SpatialHash::~SpatialHash()
+{
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetCellSize
+*/
+void SpatialHash::SetCellSize( float cell_size )
+{
+	if( cell_size <= 0.0f )
+	{
+		return;
+	}
+	m_cell_size = cell_size;
+	m_inv_cell_size = 1.0f / cell_size;
+
+	// Everything is in the wrong cell now.
+	m_cells.clear();
+	m_count = 0;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Clear
+* Keeps the cell buckets around so a rebuild doesn't reallocate them.
+*/
+void SpatialHash::Clear()
+{
+	// Drop the buckets entirely if entities have wandered through far more cells than are in use.
+	if( m_cells.size() > 4 * m_count + 64 )
+	{
+		m_cells.clear();
+	}
+	else
+	{
+		for( auto& cell : m_cells )
+		{
+			cell.second.clear();
+		}
+	}
+	m_count = 0;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Insert
+*/
+void SpatialHash::Insert( EntityBase* entity, const Vec2& position )
+{
+	int64_t key = GetCellKey( GetCellCoord( position.x ), GetCellCoord( position.y ) );
+	m_cells[key].push_back( { entity, position, entity->GetTypeId() } );
+	++m_count;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Rebuild
+*/
+void SpatialHash::Rebuild( const std::vector<EntityBase*>& entities )
+{
+	Clear();
+	for( EntityBase* entity : entities )
+	{
+		if( entity && !entity->IsGarbage() )
+		{
+			Insert( entity, entity->GetPosition() );
+		}
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* QueryRadius
+*/
+void SpatialHash::QueryRadius( const Vec2& center, float radius, std::vector<EntityBase*>& out ) const
+{
+	float radius_sq = radius * radius;
+	int min_x = GetCellCoord( center.x - radius );
+	int max_x = GetCellCoord( center.x + radius );
+	int min_y = GetCellCoord( center.y - radius );
+	int max_y = GetCellCoord( center.y + radius );
+
+	for( int cell_y = min_y; cell_y <= max_y; ++cell_y )
+	{
+		for( int cell_x = min_x; cell_x <= max_x; ++cell_x )
+		{
+			auto itr = m_cells.find( GetCellKey( cell_x, cell_y ) );
+			if( itr == m_cells.end() )
+			{
+				continue;
+			}
+			for( const entry_t& entry : itr->second )
+			{
+				if( ( entry.position - center ).GetLengthSquared() <= radius_sq )
+				{
+					out.push_back( entry.entity );
+				}
+			}
+		}
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* FindNearest
+* Closest entity of the given type strictly inside the radius.
+*/
+EntityBase* SpatialHash::FindNearest( const Vec2& center, float radius, EntityTypeId type_id, const EntityBase* ignore ) const
+{
+	float closest_sq = radius * radius;
+	EntityBase* closest = nullptr;
+
+	int min_x = GetCellCoord( center.x - radius );
+	int max_x = GetCellCoord( center.x + radius );
+	int min_y = GetCellCoord( center.y - radius );
+	int max_y = GetCellCoord( center.y + radius );
+
+	for( int cell_y = min_y; cell_y <= max_y; ++cell_y )
+	{
+		for( int cell_x = min_x; cell_x <= max_x; ++cell_x )
+		{
+			auto itr = m_cells.find( GetCellKey( cell_x, cell_y ) );
+			if( itr == m_cells.end() )
+			{
+				continue;
+			}
+			for( const entry_t& entry : itr->second )
+			{
+				float dist_sq = ( entry.position - center ).GetLengthSquared();
+				if( entry.type_id == type_id && dist_sq < closest_sq && entry.entity != ignore )
+				{
+					closest = entry.entity;
+					closest_sq = dist_sq;
+				}
+			}
+		}
+	}
+	return closest;
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetCellCoord
+*/
+int SpatialHash::GetCellCoord( float value ) const
+{
+	return (int) floorf( value * m_inv_cell_size );
+}
+
+//--------------------------------------------------------------------------
+/**
+* GetCellKey
+*/
+int64_t SpatialHash::GetCellKey( int cell_x, int cell_y )
+{
+	return (int64_t)( ( (uint64_t)(uint32_t) cell_x << 32 ) | (uint64_t)(uint32_t) cell_y );
+}
@@ -0,0 +1,54 @@
+#pragma once
+#include "Engine/Math/Vec2.hpp"
+
+#include "Shared/EntityTypeRegistry.hpp"
+
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+class EntityBase;
+
+//--------------------------------------------------------------------------
+// Uniform grid of entity positions for neighbour queries.
+// Positions are copied in on Rebuild so queries never chase entity pointers
+// until a candidate is inside the radius.
+//--------------------------------------------------------------------------
+class SpatialHash
+{
+public:
+	SpatialHash( float cell_size = 5.0f );
+	~SpatialHash();
+
+public:
+	void SetCellSize( float cell_size );
+	float GetCellSize() const { return m_cell_size; }
+
+	void Clear();
+	void Insert( EntityBase* entity, const Vec2& position );
+	void Rebuild( const std::vector<EntityBase*>& entities );
+
+	void QueryRadius( const Vec2& center, float radius, std::vector<EntityBase*>& out ) const;
+	EntityBase* FindNearest( const Vec2& center, float radius, EntityTypeId type_id, const EntityBase* ignore = nullptr ) const;
+
+	size_t GetCount() const { return m_count; }
+
+private:
+	struct entry_t
+	{
+		EntityBase* entity;
+		Vec2 position;
+		EntityTypeId type_id;
+	};
+
+	int GetCellCoord( float value ) const;
+	static int64_t GetCellKey( int cell_x, int cell_y );
+
+private:
+	float m_cell_size = 5.0f;
+	float m_inv_cell_size = 0.2f;
+	size_t m_count = 0;
+
+	std::unordered_map<int64_t, std::vector<entry_t>> m_cells;
+
+};
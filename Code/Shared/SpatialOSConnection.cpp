@@ -0,0 +1,342 @@
+#include "Shared/SpatialOSConnection.hpp"
+
+const std::uint32_t kEntityRequestTimeoutInMilliseconds = 5000;
+const std::uint32_t kCommandTimeoutInMilliseconds = 30000;
+
+//--------------------------------------------------------------------------
+/**
+* SpatialOSConnection
+*/
+SpatialOSConnection::SpatialOSConnection( worker::Connection&& connection )
+	: m_connection( std::move( connection ) )
+	, m_dispatcher( WorkerComponentRegistry{} )
+	, m_worker_id( m_connection.GetWorkerId() )
+{
+	m_dispatcher.OnDisconnect( [this]( const worker::DisconnectOp& op ) {
+		FlushedTarget().DispatchDisconnect( op.Reason );
+		});
+	m_dispatcher.OnLogMessage( [this]( const worker::LogMessageOp& op ) {
+		FlushedTarget().DispatchLogMessage( op.Level, op.Message );
+		});
+
+	m_dispatcher.OnAddEntity( [this]( const worker::AddEntityOp& op ) {
+		m_coalescer.AddEntity( op.EntityId );
+		});
+	m_dispatcher.OnRemoveEntity( [this]( const worker::RemoveEntityOp& op ) {
+		m_coalescer.RemoveEntity( op.EntityId );
+		});
+	ForwardComponent<improbable::Position>();
+	ForwardComponent<improbable::Metadata>();
+	ForwardComponent<siren::PlayerControls>();
+	ForwardComponent<siren::PlayerMovement>();
+	ForwardComponent<siren::PlanePosition>();
+
+	m_dispatcher.OnReserveEntityIdsResponse( [this]( const worker::ReserveEntityIdsResponseOp& op ) {
+		reserve_entity_ids_response_t response;
+		response.request_id = op.RequestId.Id;
+		response.status_code = op.StatusCode;
+		response.message = op.Message;
+		response.first_entity_id = op.FirstEntityId;
+		FlushedTarget().DispatchReserveEntityIdsResponse( response );
+		});
+	m_dispatcher.OnCreateEntityResponse( [this]( const worker::CreateEntityResponseOp& op ) {
+		create_entity_response_t response;
+		response.request_id = op.RequestId.Id;
+		response.status_code = op.StatusCode;
+		response.message = op.Message;
+		response.entity_id = op.EntityId;
+		FlushedTarget().DispatchCreateEntityResponse( response );
+		});
+	m_dispatcher.OnDeleteEntityResponse( [this]( const worker::DeleteEntityResponseOp& op ) {
+		delete_entity_response_t response;
+		response.request_id = op.RequestId.Id;
+		response.status_code = op.StatusCode;
+		response.message = op.Message;
+		response.entity_id = op.EntityId;
+		FlushedTarget().DispatchDeleteEntityResponse( response );
+		});
+	m_dispatcher.OnEntityQueryResponse( [this]( const worker::EntityQueryResponseOp& op ) {
+		entity_query_response_t response;
+		response.request_id = op.RequestId.Id;
+		response.status_code = op.StatusCode;
+		response.message = op.Message;
+		for( const auto& result : op.Result )
+		{
+			response.entity_ids.push_back( result.first );
+		}
+		FlushedTarget().DispatchEntityQueryResponse( response );
+		});
+
+	ForwardCommand<CreateClientEntity>();
+	ForwardCommand<DeleteClientEntity>();
+	ForwardCommand<ClientPing>();
+}
+
+//--------------------------------------------------------------------------
+/**
+* ~SpatialOSConnection
+*/
+SpatialOSConnection::~SpatialOSConnection()
+{
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* IsConnected
+*/
+bool SpatialOSConnection::IsConnected() const
+{
+	return m_connection.IsConnected();
+}
+
+//--------------------------------------------------------------------------
+/**
+* Process
+*/
+void SpatialOSConnection::Process( WorkerDispatcher& dispatcher, uint32_t timeout_millis )
+{
+	auto op_list = m_connection.GetOpList( timeout_millis );
+	m_target = &dispatcher;
+	m_dispatcher.Process( op_list );
+	m_coalescer.Flush( dispatcher );
+	m_target = nullptr;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendLogMessage
+*/
+void SpatialOSConnection::SendLogMessage( worker::LogLevel level, const std::string& logger_name, const std::string& message )
+{
+	m_connection.SendLogMessage( level, logger_name, message );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendComponentUpdate
+*/
+void SpatialOSConnection::SendComponentUpdate( worker::EntityId entity_id, const improbable::Position::Update& update )
+{
+	worker::UpdateParameters params;
+	m_connection.SendComponentUpdate<improbable::Position>( entity_id, update, params );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendComponentUpdate
+*/
+void SpatialOSConnection::SendComponentUpdate( worker::EntityId entity_id, const siren::PlayerControls::Update& update )
+{
+	worker::UpdateParameters params;
+	m_connection.SendComponentUpdate<siren::PlayerControls>( entity_id, update, params );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendComponentUpdate
+*/
+void SpatialOSConnection::SendComponentUpdate( worker::EntityId entity_id, const siren::PlayerMovement::Update& update )
+{
+	worker::UpdateParameters params;
+	m_connection.SendComponentUpdate<siren::PlayerMovement>( entity_id, update, params );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendComponentUpdate
+*/
+void SpatialOSConnection::SendComponentUpdate( worker::EntityId entity_id, const siren::PlanePosition::Update& update )
+{
+	worker::UpdateParameters params;
+	m_connection.SendComponentUpdate<siren::PlanePosition>( entity_id, update, params );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendComponentUpdate
+*/
+void SpatialOSConnection::SendComponentUpdate( worker::EntityId entity_id, const siren::ClientHeartbeat::Update& update )
+{
+	worker::UpdateParameters params;
+	m_connection.SendComponentUpdate<siren::ClientHeartbeat>( entity_id, update, params );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendReserveEntityIdsRequest
+*/
+uint64_t SpatialOSConnection::SendReserveEntityIdsRequest( uint32_t count )
+{
+	return m_connection.SendReserveEntityIdsRequest( count, {} ).Id;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCreateEntityRequest
+*/
+worker::Option<uint64_t> SpatialOSConnection::SendCreateEntityRequest( const worker::Entity& entity, const worker::Option<worker::EntityId>& entity_id )
+{
+	auto result = m_connection.SendCreateEntityRequest( entity, entity_id, kEntityRequestTimeoutInMilliseconds );
+	if( !result )
+	{
+		m_connection.SendLogMessage( worker::LogLevel::kError, "SendCreateEntityRequest Error", result.GetErrorMessage() );
+		return {};
+	}
+	return worker::Option<uint64_t>( (*result).Id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendDeleteEntityRequest
+*/
+uint64_t SpatialOSConnection::SendDeleteEntityRequest( worker::EntityId entity_id )
+{
+	return m_connection.SendDeleteEntityRequest( entity_id, kEntityRequestTimeoutInMilliseconds ).Id;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendEntityQueryRequest
+*/
+uint64_t SpatialOSConnection::SendEntityQueryRequest( worker::ComponentId component_id )
+{
+	worker::query::EntityQuery query
+	{
+		worker::query::ComponentConstraint{ component_id },
+		worker::query::SnapshotResultType{ {{ component_id }} }
+	};
+	return m_connection.SendEntityQueryRequest( query, {} ).Id;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCommandRequest
+*/
+worker::Option<uint64_t> SpatialOSConnection::SendCommandRequest( worker::EntityId entity_id, const CreateClientEntity::Request& request )
+{
+	auto result = m_connection.SendCommandRequest<CreateClientEntity>( entity_id, request, kCommandTimeoutInMilliseconds, {} );
+	if( !result )
+	{
+		return {};
+	}
+	return worker::Option<uint64_t>( result->Id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCommandRequest
+*/
+worker::Option<uint64_t> SpatialOSConnection::SendCommandRequest( worker::EntityId entity_id, const DeleteClientEntity::Request& request )
+{
+	auto result = m_connection.SendCommandRequest<DeleteClientEntity>( entity_id, request, kCommandTimeoutInMilliseconds, {} );
+	if( !result )
+	{
+		return {};
+	}
+	return worker::Option<uint64_t>( result->Id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCommandRequest
+*/
+worker::Option<uint64_t> SpatialOSConnection::SendCommandRequest( worker::EntityId entity_id, const ClientPing::Request& request )
+{
+	auto result = m_connection.SendCommandRequest<ClientPing>( entity_id, request, kCommandTimeoutInMilliseconds, {} );
+	if( !result )
+	{
+		return {};
+	}
+	return worker::Option<uint64_t>( result->Id );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCommandResponse
+*/
+void SpatialOSConnection::SendCommandResponse( uint64_t request_id, const CreateClientEntity::Response& response )
+{
+	worker::RequestId<worker::IncomingCommandRequest<CreateClientEntity>> command_request;
+	command_request.Id = request_id;
+	m_connection.SendCommandResponse<CreateClientEntity>( command_request, response );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCommandResponse
+*/
+void SpatialOSConnection::SendCommandResponse( uint64_t request_id, const DeleteClientEntity::Response& response )
+{
+	worker::RequestId<worker::IncomingCommandRequest<DeleteClientEntity>> command_request;
+	command_request.Id = request_id;
+	m_connection.SendCommandResponse<DeleteClientEntity>( command_request, response );
+}
+
+//--------------------------------------------------------------------------
+/**
+* SendCommandResponse
+*/
+void SpatialOSConnection::SendCommandResponse( uint64_t request_id, const ClientPing::Response& response )
+{
+	worker::RequestId<worker::IncomingCommandRequest<ClientPing>> command_request;
+	command_request.Id = request_id;
+	m_connection.SendCommandResponse<ClientPing>( command_request, response );
+}
+
+//--------------------------------------------------------------------------
+/**
+* FlushedTarget
+*/
+WorkerDispatcher& SpatialOSConnection::FlushedTarget()
+{
+	m_coalescer.Flush( *m_target );
+	return *m_target;
+}
+
+//--------------------------------------------------------------------------
+/**
+* ForwardComponent
+*/
+template <typename T>
+void SpatialOSConnection::ForwardComponent()
+{
+	m_dispatcher.OnAddComponent<T>( [this]( const worker::AddComponentOp<T>& op ) {
+		m_coalescer.AddComponent( op.EntityId, op.Data );
+		});
+	m_dispatcher.OnRemoveComponent<T>( [this]( const worker::RemoveComponentOp& op ) {
+		m_coalescer.RemoveComponent( op.EntityId, T::ComponentId );
+		});
+	m_dispatcher.OnComponentUpdate<T>( [this]( const worker::ComponentUpdateOp<T>& op ) {
+		m_coalescer.UpdateComponent( op.EntityId, op.Update );
+		});
+	m_dispatcher.OnAuthorityChange<T>( [this]( const worker::AuthorityChangeOp& op ) {
+		m_coalescer.ChangeAuthority( op.EntityId, T::ComponentId, op.Authority );
+		});
+}
+
+//--------------------------------------------------------------------------
+/**
+* ForwardCommand
+*/
+template <typename T>
+void SpatialOSConnection::ForwardCommand()
+{
+	m_dispatcher.OnCommandRequest<T>( [this]( const worker::CommandRequestOp<T>& op ) {
+		command_request_t<T> request;
+		request.request_id = op.RequestId.Id;
+		request.entity_id = op.EntityId;
+		request.caller_worker_id = op.CallerWorkerId;
+		request.request = op.Request;
+		FlushedTarget().DispatchCommandRequest( request );
+		});
+	m_dispatcher.OnCommandResponse<T>( [this]( const worker::CommandResponseOp<T>& op ) {
+		command_response_t<T> response;
+		response.request_id = op.RequestId.Id;
+		response.entity_id = op.EntityId;
+		response.status_code = op.StatusCode;
+		response.message = op.Message;
+		response.response = op.Response;
+		FlushedTarget().DispatchCommandResponse( response );
+		});
+}
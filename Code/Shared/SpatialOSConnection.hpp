@@ -0,0 +1,65 @@
+#pragma once
+#include "Shared/WorkerConnection.hpp"
+
+//--------------------------------------------------------------------------
+// WorkerConnection over a live worker::Connection. Ops are run through a
+// worker::Dispatcher that forwards them to whichever WorkerDispatcher is processing.
+// State ops go through an OpCoalescer first, so an op list that piled up during a
+// stall is applied as one net change per component.
+//--------------------------------------------------------------------------
+class SpatialOSConnection
+	: public WorkerConnection
+{
+public:
+	SpatialOSConnection( worker::Connection&& connection );
+	~SpatialOSConnection();
+
+	// Not copyable or movable, the dispatcher callbacks hold on to this.
+	SpatialOSConnection( const SpatialOSConnection& ) = delete;
+	SpatialOSConnection& operator=( const SpatialOSConnection& ) = delete;
+
+public:
+	bool IsConnected() const override;
+	const std::string& GetWorkerId() const override { return m_worker_id; }
+	void Process( WorkerDispatcher& dispatcher, uint32_t timeout_millis ) override;
+	op_coalesce_stats_t GetOpCoalesceStats() const override { return m_coalescer.GetStats(); }
+
+public:
+	void SendLogMessage( worker::LogLevel level, const std::string& logger_name, const std::string& message ) override;
+
+	void SendComponentUpdate( worker::EntityId entity_id, const improbable::Position::Update& update ) override;
+	void SendComponentUpdate( worker::EntityId entity_id, const siren::PlayerControls::Update& update ) override;
+	void SendComponentUpdate( worker::EntityId entity_id, const siren::PlayerMovement::Update& update ) override;
+	void SendComponentUpdate( worker::EntityId entity_id, const siren::PlanePosition::Update& update ) override;
+	void SendComponentUpdate( worker::EntityId entity_id, const siren::ClientHeartbeat::Update& update ) override;
+
+	uint64_t SendReserveEntityIdsRequest( uint32_t count ) override;
+	worker::Option<uint64_t> SendCreateEntityRequest( const worker::Entity& entity, const worker::Option<worker::EntityId>& entity_id ) override;
+	uint64_t SendDeleteEntityRequest( worker::EntityId entity_id ) override;
+	uint64_t SendEntityQueryRequest( worker::ComponentId component_id ) override;
+
+	worker::Option<uint64_t> SendCommandRequest( worker::EntityId entity_id, const CreateClientEntity::Request& request ) override;
+	worker::Option<uint64_t> SendCommandRequest( worker::EntityId entity_id, const DeleteClientEntity::Request& request ) override;
+	worker::Option<uint64_t> SendCommandRequest( worker::EntityId entity_id, const ClientPing::Request& request ) override;
+	void SendCommandResponse( uint64_t request_id, const CreateClientEntity::Response& response ) override;
+	void SendCommandResponse( uint64_t request_id, const DeleteClientEntity::Response& response ) override;
+	void SendCommandResponse( uint64_t request_id, const ClientPing::Response& response ) override;
+
+private:
+	template <typename T>
+	void ForwardComponent();
+	template <typename T>
+	void ForwardCommand();
+
+	// The target once the state before this op has reached it.
+	WorkerDispatcher& FlushedTarget();
+
+private:
+	worker::Connection m_connection;
+	worker::Dispatcher m_dispatcher;
+	std::string m_worker_id;
+
+	WorkerDispatcher* m_target = nullptr;		// Only set inside Process.
+	OpCoalescer m_coalescer;
+
+};
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+//--------------------------------------------------------------------------
+// Bounded lock-free ring for exactly one producer thread and one consumer thread.
+// Capacity is rounded up to a power of two. Neither side ever blocks, a full
+// or empty queue just returns false.
+//--------------------------------------------------------------------------
+template <typename T>
+class SpscQueue
+{
+public:
+	explicit SpscQueue( size_t capacity )
+	{
+		size_t size = 2;
+		while( size < capacity )
+		{
+			size <<= 1;
+		}
+		m_slots.resize( size );
+		m_mask = size - 1;
+	}
+
+	SpscQueue( const SpscQueue& ) = delete;
+	SpscQueue& operator=( const SpscQueue& ) = delete;
+
+public:
+	// Producer only. The item is left untouched when the queue is full.
+	bool TryPush( T&& item )
+	{
+		size_t tail = m_tail.load( std::memory_order_relaxed );
+		if( tail - m_head.load( std::memory_order_acquire ) > m_mask )
+		{
+			return false;
+		}
+		m_slots[tail & m_mask] = std::move( item );
+		m_tail.store( tail + 1, std::memory_order_release );
+		return true;
+	}
+
+	// Consumer only.
+	bool TryPop( T& out )
+	{
+		size_t head = m_head.load( std::memory_order_relaxed );
+		if( head == m_tail.load( std::memory_order_acquire ) )
+		{
+			return false;
+		}
+		out = std::move( m_slots[head & m_mask] );
+		m_slots[head & m_mask] = T();
+		m_head.store( head + 1, std::memory_order_release );
+		return true;
+	}
+
+	// Approximate from any thread other than the two users.
+	size_t GetSize() const { return m_tail.load( std::memory_order_acquire ) - m_head.load( std::memory_order_acquire ); }
+	size_t GetCapacity() const { return m_mask + 1; }
+
+private:
+	std::vector<T> m_slots;
+	size_t m_mask = 0;
+
+	// Kept on separate cache lines so the two threads don't fight over them.
+	alignas( 64 ) std::atomic<size_t> m_head{ 0 };		// Next slot to pop, written by the consumer.
+	alignas( 64 ) std::atomic<size_t> m_tail{ 0 };		// Next slot to push, written by the producer.
+
+};
\ No newline at end of file
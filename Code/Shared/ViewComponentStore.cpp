@@ -0,0 +1,130 @@
+#include "Shared/ViewComponentStore.hpp"
+
+//--------------------------------------------------------------------------
+/**
+* ViewComponentStore
+*/
+ViewComponentStore::ViewComponentStore()
+{
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* ~ViewComponentStore
+*/
+ViewComponentStore::~ViewComponentStore()
+{
+
+}
+
+//--------------------------------------------------------------------------
+/**
+* AddEntity
+*/
+uint32_t ViewComponentStore::AddEntity( worker::EntityId id )
+{
+	auto found = m_slots.find( id );
+	if( found != m_slots.end() )
+	{
+		return found->second;
+	}
+
+	uint32_t slot;
+	if( !m_free_slots.empty() )
+	{
+		slot = m_free_slots.back();
+		m_free_slots.pop_back();
+	}
+	else
+	{
+		slot = GetSlotCount();
+		m_slot_ids.push_back( 0 );
+		ForEachArray( []( auto& components ) {
+			components.data.emplace_back();
+			components.authority.push_back( worker::Authority::kNotAuthoritative );
+			} );
+	}
+
+	m_slot_ids[slot] = id;
+	m_slots[id] = slot;
+	return slot;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RemoveEntity
+*/
+bool ViewComponentStore::RemoveEntity( worker::EntityId id )
+{
+	auto found = m_slots.find( id );
+	if( found == m_slots.end() )
+	{
+		return false;
+	}
+
+	uint32_t slot = found->second;
+	ClearSlot( slot );
+	m_slot_ids[slot] = 0;
+	m_free_slots.push_back( slot );
+	m_slots.erase( found );
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* ClearSlot
+*/
+void ViewComponentStore::ClearSlot( uint32_t slot )
+{
+	ForEachArray( [slot]( auto& components ) {
+		components.data[slot].clear();
+		components.authority[slot] = worker::Authority::kNotAuthoritative;
+		} );
+}
+
+//--------------------------------------------------------------------------
+/**
+* FindSlot
+*/
+uint32_t ViewComponentStore::FindSlot( worker::EntityId id ) const
+{
+	auto found = m_slots.find( id );
+	return found != m_slots.end() ? found->second : INVALID_SLOT;
+}
+
+//--------------------------------------------------------------------------
+/**
+* RemoveComponent
+*/
+bool ViewComponentStore::RemoveComponent( uint32_t slot, worker::ComponentId component_id )
+{
+	bool removed = false;
+	ForEachArray( [slot, component_id, &removed]( auto& components ) {
+		using Component = typename std::decay_t<decltype( components )>::Component;
+		if( Component::ComponentId == component_id )
+		{
+			components.data[slot].clear();
+			removed = true;
+		}
+		} );
+	return removed;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetAuthority
+*/
+bool ViewComponentStore::SetAuthority( uint32_t slot, worker::ComponentId component_id, worker::Authority authority )
+{
+	bool found = false;
+	ForEachArray( [slot, component_id, authority, &found]( auto& components ) {
+		using Component = typename std::decay_t<decltype( components )>::Component;
+		if( Component::ComponentId == component_id )
+		{
+			components.authority[slot] = authority;
+			found = true;
+		}
+		} );
+	return found;
+}
@@ -0,0 +1,111 @@
+#pragma once
+#include <improbable/worker.h>
+#include <improbable/standard_library.h>
+
+#include "ClientServer.h"
+
+#include <cstdint>
+#include <tuple>
+#include <unordered_map>
+#include <vector>
+
+//--------------------------------------------------------------------------
+// Component state for the entities a View has checked out. Instead of a type-erased
+// worker::Entity per entity there is one array per component type, indexed by a slot
+// the entity keeps while it's in view. Slots are reused once their entity is removed
+// so the arrays only grow to the most entities seen at once.
+// Authority sits next to the data in each component's array.
+// Only the components a View is forwarded are stored: Position, Metadata, PlayerControls, PlayerMovement and PlanePosition.
+//--------------------------------------------------------------------------
+class ViewComponentStore
+{
+public:
+	static constexpr uint32_t INVALID_SLOT = 0xffffffff;
+
+public:
+	ViewComponentStore();
+	~ViewComponentStore();
+
+public:
+	// Returns the entity's slot, a new one with no components if it wasn't stored yet.
+	uint32_t AddEntity( worker::EntityId id );
+	bool RemoveEntity( worker::EntityId id );
+	// Drops every component and authority in the slot, the entity keeps it.
+	void ClearSlot( uint32_t slot );
+
+	uint32_t FindSlot( worker::EntityId id ) const;
+	worker::EntityId GetEntityId( uint32_t slot ) const		{ return m_slot_ids[slot]; }
+	uint32_t GetEntityCount() const							{ return (uint32_t) m_slots.size(); }
+	uint32_t GetSlotCount() const							{ return (uint32_t) m_slot_ids.size(); }
+
+	// Dispatch on a component id, false if it isn't one we store.
+	bool RemoveComponent( uint32_t slot, worker::ComponentId component_id );
+	bool SetAuthority( uint32_t slot, worker::ComponentId component_id, worker::Authority authority );
+
+public:
+	template <typename T>
+	const typename T::Data* Get( uint32_t slot ) const
+	{
+		const worker::Option<typename T::Data>& data = GetArray<T>().data[slot];
+		return data ? &*data : nullptr;
+	}
+
+	template <typename T>
+	void Set( uint32_t slot, const typename T::Data& data )
+	{
+		GetArray<T>().data[slot].emplace( data );
+	}
+
+	// False when the entity doesn't have the component, the update is dropped.
+	template <typename T>
+	bool Update( uint32_t slot, const typename T::Update& update )
+	{
+		worker::Option<typename T::Data>& data = GetArray<T>().data[slot];
+		if( !data )
+		{
+			return false;
+		}
+		update.ApplyTo( *data );
+		return true;
+	}
+
+	template <typename T>
+	worker::Authority GetAuthority( uint32_t slot ) const
+	{
+		return GetArray<T>().authority[slot];
+	}
+
+private:
+	template <typename T>
+	struct component_array_t
+	{
+		using Component = T;
+
+		// Indexed by slot
+		std::vector<worker::Option<typename T::Data>> data;
+		std::vector<worker::Authority> authority;
+	};
+
+	template <typename T>
+	component_array_t<T>& GetArray()				{ return std::get<component_array_t<T>>( m_components ); }
+	template <typename T>
+	const component_array_t<T>& GetArray() const	{ return std::get<component_array_t<T>>( m_components ); }
+
+	template <typename F>
+	void ForEachArray( F&& func )
+	{
+		std::apply( [&func]( auto&... arrays ) { ( func( arrays ), ... ); }, m_components );
+	}
+
+private:
+	std::tuple<
+		component_array_t<improbable::Position>,
+		component_array_t<improbable::Metadata>,
+		component_array_t<siren::PlayerControls>,
+		component_array_t<siren::PlayerMovement>,
+		component_array_t<siren::PlanePosition>> m_components;
+
+	std::unordered_map<worker::EntityId, uint32_t> m_slots;
+	std::vector<worker::EntityId> m_slot_ids;		// Indexed by slot, 0 when free.
+	std::vector<uint32_t> m_free_slots;
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include "Shared/WorkerDispatcher.hpp"
+#include "Shared/OpCoalescer.hpp"
+
+#include <cstdint>
+#include <string>
+
+// Every component either worker can serialize.
+using WorkerComponentRegistry
+	= worker::Components<
+	improbable::Position,
+	improbable::EntityAcl,
+	improbable::Metadata,
+	improbable::Persistence,
+	improbable::Interest,
+	siren::PlayerControls,
+	siren::PlayerMovement,
+	siren::PlanePosition,
+	siren::ClientHeartbeat,
+	siren::ServerAPI
+	>;
+
+//--------------------------------------------------------------------------
+// What the workers need from a connection: ops in through a WorkerDispatcher,
+// updates, entity requests and ServerAPI commands out.
+// SpatialOSConnection talks to a real deployment, LocalConnection to an in-process LocalWorkerBus.
+// Request ids are only unique per connection.
+//--------------------------------------------------------------------------
+class WorkerConnection
+{
+public:
+	virtual ~WorkerConnection() {};
+
+public:
+	virtual bool IsConnected() const = 0;
+	virtual const std::string& GetWorkerId() const = 0;
+
+	// Hands everything received so far to the dispatcher, waiting up to timeout_millis if there's nothing yet.
+	virtual void Process( WorkerDispatcher& dispatcher, uint32_t timeout_millis ) = 0;
+
+	// Totals for state ops merged or dropped before they reached a dispatcher, zero if the connection doesn't.
+	virtual op_coalesce_stats_t GetOpCoalesceStats() const { return op_coalesce_stats_t(); }
+
+public:
+	virtual void SendLogMessage( worker::LogLevel level, const std::string& logger_name, const std::string& message ) = 0;
+
+	virtual void SendComponentUpdate( worker::EntityId entity_id, const improbable::Position::Update& update ) = 0;
+	virtual void SendComponentUpdate( worker::EntityId entity_id, const siren::PlayerControls::Update& update ) = 0;
+	virtual void SendComponentUpdate( worker::EntityId entity_id, const siren::PlayerMovement::Update& update ) = 0;
+	virtual void SendComponentUpdate( worker::EntityId entity_id, const siren::PlanePosition::Update& update ) = 0;
+	virtual void SendComponentUpdate( worker::EntityId entity_id, const siren::ClientHeartbeat::Update& update ) = 0;
+
+	virtual uint64_t SendReserveEntityIdsRequest( uint32_t count ) = 0;
+	virtual worker::Option<uint64_t> SendCreateEntityRequest( const worker::Entity& entity, const worker::Option<worker::EntityId>& entity_id ) = 0;
+	virtual uint64_t SendDeleteEntityRequest( worker::EntityId entity_id ) = 0;
+
+	// Finds every entity that has the component.
+	virtual uint64_t SendEntityQueryRequest( worker::ComponentId component_id ) = 0;
+
+	virtual worker::Option<uint64_t> SendCommandRequest( worker::EntityId entity_id, const CreateClientEntity::Request& request ) = 0;
+	virtual worker::Option<uint64_t> SendCommandRequest( worker::EntityId entity_id, const DeleteClientEntity::Request& request ) = 0;
+	virtual worker::Option<uint64_t> SendCommandRequest( worker::EntityId entity_id, const ClientPing::Request& request ) = 0;
+	virtual void SendCommandResponse( uint64_t request_id, const CreateClientEntity::Response& response ) = 0;
+	virtual void SendCommandResponse( uint64_t request_id, const DeleteClientEntity::Response& response ) = 0;
+	virtual void SendCommandResponse( uint64_t request_id, const ClientPing::Response& response ) = 0;
+
+};
@@ -0,0 +1,145 @@
+#include "Shared/WorkerDispatcher.hpp"
+
+//--------------------------------------------------------------------------
+/**
+* DispatchDisconnect
+*/
+void WorkerDispatcher::DispatchDisconnect( const std::string& reason )
+{
+	if( m_on_disconnect )
+	{
+		m_on_disconnect( reason );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DispatchLogMessage
+*/
+void WorkerDispatcher::DispatchLogMessage( worker::LogLevel level, const std::string& message )
+{
+	if( m_on_log_message )
+	{
+		m_on_log_message( level, message );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DispatchReserveEntityIdsResponse
+*/
+void WorkerDispatcher::DispatchReserveEntityIdsResponse( const reserve_entity_ids_response_t& op )
+{
+	if( m_on_reserve_entity_ids_response )
+	{
+		m_on_reserve_entity_ids_response( op );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DispatchCreateEntityResponse
+*/
+void WorkerDispatcher::DispatchCreateEntityResponse( const create_entity_response_t& op )
+{
+	if( m_on_create_entity_response )
+	{
+		m_on_create_entity_response( op );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DispatchDeleteEntityResponse
+*/
+void WorkerDispatcher::DispatchDeleteEntityResponse( const delete_entity_response_t& op )
+{
+	if( m_on_delete_entity_response )
+	{
+		m_on_delete_entity_response( op );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DispatchEntityQueryResponse
+*/
+void WorkerDispatcher::DispatchEntityQueryResponse( const entity_query_response_t& op )
+{
+	if( m_on_entity_query_response )
+	{
+		m_on_entity_query_response( op );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DispatchCommandRequest
+*/
+void WorkerDispatcher::DispatchCommandRequest( const command_request_t<CreateClientEntity>& op )
+{
+	if( m_on_create_client_entity_request )
+	{
+		m_on_create_client_entity_request( op );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DispatchCommandRequest
+*/
+void WorkerDispatcher::DispatchCommandRequest( const command_request_t<DeleteClientEntity>& op )
+{
+	if( m_on_delete_client_entity_request )
+	{
+		m_on_delete_client_entity_request( op );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DispatchCommandResponse
+*/
+void WorkerDispatcher::DispatchCommandResponse( const command_response_t<CreateClientEntity>& op )
+{
+	if( m_on_create_client_entity_response )
+	{
+		m_on_create_client_entity_response( op );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DispatchCommandResponse
+*/
+void WorkerDispatcher::DispatchCommandResponse( const command_response_t<DeleteClientEntity>& op )
+{
+	if( m_on_delete_client_entity_response )
+	{
+		m_on_delete_client_entity_response( op );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DispatchCommandRequest
+*/
+void WorkerDispatcher::DispatchCommandRequest( const command_request_t<ClientPing>& op )
+{
+	if( m_on_client_ping_request )
+	{
+		m_on_client_ping_request( op );
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DispatchCommandResponse
+*/
+void WorkerDispatcher::DispatchCommandResponse( const command_response_t<ClientPing>& op )
+{
+	if( m_on_client_ping_response )
+	{
+		m_on_client_ping_response( op );
+	}
+}
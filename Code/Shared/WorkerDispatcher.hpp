@@ -0,0 +1,165 @@
+#pragma once
+#include <improbable/worker.h>
+#include <improbable/standard_library.h>
+
+#include "ClientServer.h"
+
+#include <functional>
+#include <string>
+#include <vector>
+
+using CreateClientEntity = siren::ServerAPI::Commands::CreateClientEntity;
+using DeleteClientEntity = siren::ServerAPI::Commands::DeleteClientEntity;
+using ClientPing = siren::ServerAPI::Commands::ClientPing;
+
+struct reserve_entity_ids_response_t
+{
+	uint64_t request_id = 0;
+	worker::StatusCode status_code = worker::StatusCode::kSuccess;
+	std::string message;
+	worker::Option<worker::EntityId> first_entity_id;
+};
+
+struct create_entity_response_t
+{
+	uint64_t request_id = 0;
+	worker::StatusCode status_code = worker::StatusCode::kSuccess;
+	std::string message;
+	worker::Option<worker::EntityId> entity_id;
+};
+
+struct delete_entity_response_t
+{
+	uint64_t request_id = 0;
+	worker::StatusCode status_code = worker::StatusCode::kSuccess;
+	std::string message;
+	worker::EntityId entity_id = 0;
+};
+
+struct entity_query_response_t
+{
+	uint64_t request_id = 0;
+	worker::StatusCode status_code = worker::StatusCode::kSuccess;
+	std::string message;
+	std::vector<worker::EntityId> entity_ids;
+};
+
+template <typename T>
+struct command_request_t
+{
+	uint64_t request_id = 0;
+	worker::EntityId entity_id = 0;
+	std::string caller_worker_id;
+	typename T::Request request;
+};
+
+template <typename T>
+struct command_response_t
+{
+	uint64_t request_id = 0;
+	worker::EntityId entity_id = 0;
+	worker::StatusCode status_code = worker::StatusCode::kSuccess;
+	std::string message;
+	worker::Option<typename T::Response> response;
+};
+
+// Which parts of a View's entity changed since its consumer last looked.
+enum ViewChangeBits : uint32_t
+{
+	VIEW_CHANGED_POSITION	= 1 << 0,
+	VIEW_CHANGED_METADATA	= 1 << 1,
+	VIEW_CHANGED_CONTROLS	= 1 << 2,
+	VIEW_CHANGED_AUTHORITY	= 1 << 3,
+	VIEW_CHANGED_ADDED		= 1 << 4,
+	VIEW_CHANGED_MOVEMENT	= 1 << 5,
+	VIEW_CHANGED_PLANE_POSITION	= 1 << 6,
+};
+
+inline uint32_t GetViewChangeBit( worker::ComponentId component_id )
+{
+	switch( component_id )
+	{
+	case improbable::Position::ComponentId:		return VIEW_CHANGED_POSITION;
+	case improbable::Metadata::ComponentId:		return VIEW_CHANGED_METADATA;
+	case siren::PlayerControls::ComponentId:	return VIEW_CHANGED_CONTROLS;
+	case siren::PlayerMovement::ComponentId:	return VIEW_CHANGED_MOVEMENT;
+	case siren::PlanePosition::ComponentId:		return VIEW_CHANGED_PLANE_POSITION;
+	default:									return 0;
+	}
+}
+
+//--------------------------------------------------------------------------
+// Receiving end of a WorkerConnection, registered the same way as a worker::Dispatcher
+// but fed by whichever connection is in use, SpatialOS or the in-process LocalWorkerBus.
+// Entity and component state goes through the virtuals so a View can track it,
+// everything else through the registered callbacks.
+// Only the components the game reads are forwarded: Position, Metadata, PlayerControls, PlayerMovement and PlanePosition.
+//--------------------------------------------------------------------------
+class WorkerDispatcher
+{
+public:
+	WorkerDispatcher() {};
+	virtual ~WorkerDispatcher() {};
+
+public:
+	// Registration
+	void OnDisconnect( const std::function<void( const std::string& )>& callback )								{ m_on_disconnect = callback; }
+	void OnLogMessage( const std::function<void( worker::LogLevel, const std::string& )>& callback )				{ m_on_log_message = callback; }
+	void OnReserveEntityIdsResponse( const std::function<void( const reserve_entity_ids_response_t& )>& callback )	{ m_on_reserve_entity_ids_response = callback; }
+	void OnCreateEntityResponse( const std::function<void( const create_entity_response_t& )>& callback )			{ m_on_create_entity_response = callback; }
+	void OnDeleteEntityResponse( const std::function<void( const delete_entity_response_t& )>& callback )			{ m_on_delete_entity_response = callback; }
+	void OnEntityQueryResponse( const std::function<void( const entity_query_response_t& )>& callback )			{ m_on_entity_query_response = callback; }
+	void OnCreateClientEntityRequest( const std::function<void( const command_request_t<CreateClientEntity>& )>& callback )		{ m_on_create_client_entity_request = callback; }
+	void OnDeleteClientEntityRequest( const std::function<void( const command_request_t<DeleteClientEntity>& )>& callback )		{ m_on_delete_client_entity_request = callback; }
+	void OnCreateClientEntityResponse( const std::function<void( const command_response_t<CreateClientEntity>& )>& callback )	{ m_on_create_client_entity_response = callback; }
+	void OnDeleteClientEntityResponse( const std::function<void( const command_response_t<DeleteClientEntity>& )>& callback )	{ m_on_delete_client_entity_response = callback; }
+	void OnClientPingRequest( const std::function<void( const command_request_t<ClientPing>& )>& callback )					{ m_on_client_ping_request = callback; }
+	void OnClientPingResponse( const std::function<void( const command_response_t<ClientPing>& )>& callback )					{ m_on_client_ping_response = callback; }
+
+public:
+	// Called by the connection while it processes.
+	void DispatchDisconnect( const std::string& reason );
+	void DispatchLogMessage( worker::LogLevel level, const std::string& message );
+	void DispatchReserveEntityIdsResponse( const reserve_entity_ids_response_t& op );
+	void DispatchCreateEntityResponse( const create_entity_response_t& op );
+	void DispatchDeleteEntityResponse( const delete_entity_response_t& op );
+	void DispatchEntityQueryResponse( const entity_query_response_t& op );
+	void DispatchCommandRequest( const command_request_t<CreateClientEntity>& op );
+	void DispatchCommandRequest( const command_request_t<DeleteClientEntity>& op );
+	void DispatchCommandResponse( const command_response_t<CreateClientEntity>& op );
+	void DispatchCommandResponse( const command_response_t<DeleteClientEntity>& op );
+	void DispatchCommandRequest( const command_request_t<ClientPing>& op );
+	void DispatchCommandResponse( const command_response_t<ClientPing>& op );
+
+public:
+	// Entity state, overridden by whoever tracks it.
+	virtual void AddEntity( worker::EntityId /*id*/ ) {};
+	virtual void RemoveEntity( worker::EntityId /*id*/ ) {};
+	virtual void AddComponent( worker::EntityId /*id*/, const improbable::PositionData& /*data*/ ) {};
+	virtual void AddComponent( worker::EntityId /*id*/, const improbable::MetadataData& /*data*/ ) {};
+	virtual void AddComponent( worker::EntityId /*id*/, const siren::PlayerControlsData& /*data*/ ) {};
+	virtual void AddComponent( worker::EntityId /*id*/, const siren::PlayerMovementData& /*data*/ ) {};
+	virtual void AddComponent( worker::EntityId /*id*/, const siren::PlanePositionData& /*data*/ ) {};
+	virtual void UpdateComponent( worker::EntityId /*id*/, const improbable::Position::Update& /*update*/ ) {};
+	virtual void UpdateComponent( worker::EntityId /*id*/, const improbable::Metadata::Update& /*update*/ ) {};
+	virtual void UpdateComponent( worker::EntityId /*id*/, const siren::PlayerControls::Update& /*update*/ ) {};
+	virtual void UpdateComponent( worker::EntityId /*id*/, const siren::PlayerMovement::Update& /*update*/ ) {};
+	virtual void UpdateComponent( worker::EntityId /*id*/, const siren::PlanePosition::Update& /*update*/ ) {};
+	virtual void RemoveComponent( worker::EntityId /*id*/, worker::ComponentId /*component_id*/ ) {};
+	virtual void ChangeAuthority( worker::EntityId /*id*/, worker::ComponentId /*component_id*/, worker::Authority /*authority*/ ) {};
+
+private:
+	std::function<void( const std::string& )> m_on_disconnect;
+	std::function<void( worker::LogLevel, const std::string& )> m_on_log_message;
+	std::function<void( const reserve_entity_ids_response_t& )> m_on_reserve_entity_ids_response;
+	std::function<void( const create_entity_response_t& )> m_on_create_entity_response;
+	std::function<void( const delete_entity_response_t& )> m_on_delete_entity_response;
+	std::function<void( const entity_query_response_t& )> m_on_entity_query_response;
+	std::function<void( const command_request_t<CreateClientEntity>& )> m_on_create_client_entity_request;
+	std::function<void( const command_request_t<DeleteClientEntity>& )> m_on_delete_client_entity_request;
+	std::function<void( const command_response_t<CreateClientEntity>& )> m_on_create_client_entity_response;
+	std::function<void( const command_response_t<DeleteClientEntity>& )> m_on_delete_client_entity_response;
+	std::function<void( const command_request_t<ClientPing>& )> m_on_client_ping_request;
+	std::function<void( const command_response_t<ClientPing>& )> m_on_client_ping_response;
+
+};
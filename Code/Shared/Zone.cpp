@@ -7,6 +7,9 @@
 
 #include "Engine/Physics/PhysicsSystem.hpp"
 
+// Deferred command list of the chunk this thread is running, null outside of a parallel phase.
+static thread_local std::vector<std::function<void()>>* t_deferred_commands = nullptr;
+
 //--------------------------------------------------------------------------
 /**
 * Zone
@@ -31,24 +34,39 @@ Zone::~Zone()
 */
 void Zone::Update(float deltaTime)
 {
-	for ( ControllerBase* contr : m_controllers )
+	if( m_spatial_hash_stale )
 	{
-		if (contr)
+		RebuildSpatialHash();
+	}
+
+	// Controllers only read last frame's state (the spatial hash and positions) and push forces on their own actor.
+	RunParallelPhase( (uint32_t) m_controllers.size(), [this, deltaTime]( uint32_t idx )
+	{
+		if( m_controllers[idx] )
 		{
-			contr->Update(deltaTime);
+			m_controllers[idx]->Update( deltaTime );
 		}
-	}
+	} );
 
-	for( EntityBase* entity : m_entities )
+	RunParallelPhase( (uint32_t) m_entities.size(), [this, deltaTime]( uint32_t idx )
 	{
-		if( entity )
+		if( m_entities[idx] )
 		{
-			entity->Update(deltaTime);
+			m_entities[idx]->Update( deltaTime );
 		}
+	} );
+
+	if( m_use_entity_store )
+	{
+		m_entity_store.IntegrateProjectiles( deltaTime );
 	}
 
 	m_physics_system->Update(deltaTime);
 
+	if( m_use_entity_store )
+	{
+		m_entity_store.GatherPositions();
+	}
 
 	// All entities with controllers
 	for (ControllerBase* contr : m_controllers)
@@ -68,6 +86,8 @@ void Zone::Update(float deltaTime)
 			SAFE_DELETE(entity);
 		}
 	}
+
+	RebuildSpatialHash();
 }
 
 
@@ -103,6 +123,102 @@ void Zone::Clear()
 	Init();
 }
 
+//--------------------------------------------------------------------------
+/**
+* SetSpatialHashCellSize
+*/
+void Zone::SetSpatialHashCellSize( float cell_size )
+{
+	m_spatial_hash.SetCellSize( cell_size );
+	RebuildSpatialHash();
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetEntityStoreEnabled
+* Only takes effect on an empty zone, entities already alive were never added to the store.
+*/
+void Zone::SetEntityStoreEnabled( bool enabled )
+{
+	for( EntityBase* entity : m_entities )
+	{
+		if( entity )
+		{
+			ERROR_RECOVERABLE( "Zone::SetEntityStoreEnabled called with entities alive" );
+			return;
+		}
+	}
+	m_use_entity_store = enabled;
+	m_entity_store.Clear();
+}
+
+//--------------------------------------------------------------------------
+/**
+* SetThreadCount
+*/
+void Zone::SetThreadCount( uint32_t thread_count )
+{
+	m_jobs.Startup( thread_count );
+}
+
+//--------------------------------------------------------------------------
+/**
+* RunParallelPhase
+* Spawns, deaths and removals issued from inside the phase are committed afterwards in chunk order,
+* which is the order a single thread would have issued them in.
+*/
+void Zone::RunParallelPhase( uint32_t count, const std::function<void( uint32_t )>& update )
+{
+	uint32_t num_chunks = ( count + PHASE_CHUNK_SIZE - 1 ) / PHASE_CHUNK_SIZE;
+	if( m_deferred.size() < num_chunks )
+	{
+		m_deferred.resize( num_chunks );
+	}
+
+	m_jobs.ParallelFor( count, PHASE_CHUNK_SIZE, [this, &update]( uint32_t chunk, uint32_t begin, uint32_t end )
+	{
+		t_deferred_commands = &m_deferred[chunk];
+		for( uint32_t idx = begin; idx < end; ++idx )
+		{
+			update( idx );
+		}
+		t_deferred_commands = nullptr;
+	} );
+
+	CommitDeferred( num_chunks );
+}
+
+//--------------------------------------------------------------------------
+/**
+* CommitDeferred
+*/
+void Zone::CommitDeferred( uint32_t num_chunks )
+{
+	for( uint32_t chunk = 0; chunk < num_chunks; ++chunk )
+	{
+		// Commands may spawn and queue nothing further since we're outside the phase now.
+		for( std::function<void()>& command : m_deferred[chunk] )
+		{
+			command();
+		}
+		m_deferred[chunk].clear();
+	}
+}
+
+//--------------------------------------------------------------------------
+/**
+* DeferIfInPhase
+*/
+bool Zone::DeferIfInPhase( std::function<void()> command )
+{
+	if( !t_deferred_commands )
+	{
+		return false;
+	}
+	t_deferred_commands->push_back( std::move( command ) );
+	return true;
+}
+
 //--------------------------------------------------------------------------
 /**
 * Init
@@ -131,12 +247,25 @@ void Zone::Deinit()
 
 	m_entities.clear();
 	m_controllers.clear();
+	m_spatial_hash.Clear();
+	m_spatial_hash_stale = false;
+	m_entity_store.Clear();
 
 
 	m_physics_system->Shutdown();
 	SAFE_DELETE(m_physics_system);
 }
 
+//--------------------------------------------------------------------------
+/**
+* RebuildSpatialHash
+*/
+void Zone::RebuildSpatialHash()
+{
+	m_spatial_hash.Rebuild( m_entities );
+	m_spatial_hash_stale = false;
+}
+
 //--------------------------------------------------------------------------
 /**
 * BeginFrame
@@ -190,6 +319,7 @@ void Zone::RemoveEntity( EntityBase* entity_to_remove )
 		if (entity == entity_to_remove)
 		{
 			SAFE_DELETE( entity );
+			m_spatial_hash_stale = true;
 			return;
 		}
 	}
@@ -290,4 +420,5 @@ void Zone::Shutdown()
 	Zone* zone = GetZone();
 
 	zone->Deinit();
+	zone->m_jobs.Shutdown();
 }
@@ -2,6 +2,11 @@
 #include "Engine/Core/EngineCommon.hpp"
 
 #include "Shared/SharedCommon.hpp"
+#include "Shared/SpatialHash.hpp"
+#include "Shared/EntityStore.hpp"
+#include "Shared/JobSystem.hpp"
+
+#include <functional>
 
 #include <map>
 
@@ -24,9 +29,27 @@ public:
 
 	void Clear();
 
+	const SpatialHash& GetSpatialHash() const { return m_spatial_hash; }
+	void SetSpatialHashCellSize( float cell_size );
+
+	// Null unless the store is enabled.
+	EntityStore* GetEntityStore() { return m_use_entity_store ? &m_entity_store : nullptr; }
+	const EntityStore* GetEntityStore() const { return m_use_entity_store ? &m_entity_store : nullptr; }
+	void SetEntityStoreEnabled( bool enabled );
+
+	// Called from ~EntityBase so anything holding entity pointers can drop them before a pool hands the memory out again.
+	void SetEntityDestroyedCallback( std::function<void( EntityBase* )> callback ) { m_on_entity_destroyed = std::move( callback ); }
+
+	// Worker threads used for the controller and entity phases, 0 keeps everything on the calling thread.
+	void SetThreadCount( uint32_t thread_count );
+	uint32_t GetThreadCount() const { return m_jobs.GetWorkerCount(); }
+
 private:
 	void Init();
 	void Deinit();
+	void RebuildSpatialHash();
+	void RunParallelPhase( uint32_t count, const std::function<void( uint32_t )>& update );
+	void CommitDeferred( uint32_t num_chunks );
 
 public:
 	static void BeginFrame();
@@ -40,6 +63,10 @@ public:
 	
 	static void ClearAllZones();
 
+	// Queues the command for the commit after the current parallel phase and returns true,
+	// or returns false when called outside of one so the caller goes ahead right away.
+	static bool DeferIfInPhase( std::function<void()> command );
+
 public:
 	void AddEntity( EntityBase* entity );
 	void RemoveEntity( EntityBase* entity );
@@ -54,4 +81,19 @@ public:
 private:
 	bool initialized = false;
 
+	// Entity positions as of the last physics step. Goes stale when an entity is removed outside of Update.
+	SpatialHash m_spatial_hash;
+	bool m_spatial_hash_stale = false;
+
+	// Hot per-entity state in contiguous arrays, only filled while enabled.
+	EntityStore m_entity_store;
+	bool m_use_entity_store = false;
+
+	std::function<void( EntityBase* )> m_on_entity_destroyed;
+
+	// Fixed so the chunking, and with it the commit order, doesn't change with the thread count.
+	static constexpr uint32_t PHASE_CHUNK_SIZE = 32;
+	JobSystem m_jobs;
+	std::vector<std::vector<std::function<void()>>> m_deferred;		// One list per chunk.
+
 };
\ No newline at end of file
@@ -0,0 +1,105 @@
+#include "SnapshotGen/SnapshotGenerator.hpp"
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <vector>
+
+// Relative to Run/, same as the workers.
+static const char* kDefaultLaunchPath = "../SpatialOS/default_launch.json";
+static const char* kDefaultActorsPath = "Data/Gameplay/ActorDefinitions.xml";
+
+//-----------------------------------------------------------------------------------------------
+static void PrintUsage()
+{
+	std::cout << "Usage: SnapshotGen <output> (--count <n> | --density <per_m2>) [options]" << std::endl;
+	std::cout << std::endl;
+	std::cout << "Streams a snapshot of actors spread over the deployment's world" << std::endl;
+	std::cout << "    <output>            - snapshot file to write." << std::endl;
+	std::cout << "    --count <n>         - how many actors, besides the API entity." << std::endl;
+	std::cout << "    --density <per_m2>  - actors per square meter of the world instead of a count." << std::endl;
+	std::cout << "    --mix <type=w,...>  - actor types and weights, every non player actor equally if left out." << std::endl;
+	std::cout << "    --launch <path>     - launch config the world bounds come from, " << kDefaultLaunchPath << " by default." << std::endl;
+	std::cout << "    --actors <path>     - actor definitions, " << kDefaultActorsPath << " by default." << std::endl;
+	std::cout << "    --seed <n>          - same seed, same snapshot." << std::endl;
+	std::cout << "    --threads <n>       - threads building entities, one per core by default." << std::endl;
+	std::cout << "    --batch <n>         - entities built ahead of the writer." << std::endl;
+	std::cout << "    --no-api            - leave out the ServerAPI entity." << std::endl;
+	std::cout << std::endl;
+}
+
+// Entry point
+int main( int argc, char** argv )
+{
+	std::vector<std::string> arguments( argv + 1, argv + argc );
+	if( arguments.empty() || arguments[0].compare( 0, 2, "--" ) == 0 )
+	{
+		PrintUsage();
+		return 1;
+	}
+
+	std::string output_path = arguments[0];
+	std::string launch_path = kDefaultLaunchPath;
+	std::string actors_path = kDefaultActorsPath;
+	std::string mix;
+	double density = 0.0;
+	bool has_count = false;
+	snapshot_layout_t layout;
+	snapshot_gen_settings_t settings;
+
+	for( size_t idx = 1; idx < arguments.size(); ++idx )
+	{
+		const std::string& flag = arguments[idx];
+		if( flag == "--no-api" )
+		{
+			layout.include_api = false;
+			continue;
+		}
+		if( idx + 1 >= arguments.size() )
+		{
+			PrintUsage();
+			return 1;
+		}
+
+		const std::string& value = arguments[++idx];
+		if( flag == "--count" )				{ layout.entity_count = strtoull( value.c_str(), nullptr, 10 ); has_count = true; }
+		else if( flag == "--density" )		{ density = atof( value.c_str() ); }
+		else if( flag == "--mix" )			{ mix = value; }
+		else if( flag == "--launch" )		{ launch_path = value; }
+		else if( flag == "--actors" )		{ actors_path = value; }
+		else if( flag == "--seed" )			{ layout.seed = strtoull( value.c_str(), nullptr, 10 ); }
+		else if( flag == "--threads" )		{ settings.thread_count = (uint32_t)atoi( value.c_str() ); }
+		else if( flag == "--batch" )		{ settings.batch_size = (uint32_t)atoi( value.c_str() ); }
+		else
+		{
+			PrintUsage();
+			return 1;
+		}
+	}
+
+	if( !LoadLaunchRegion( launch_path, layout ) )
+	{
+		std::cout << "Couldn't read the world dimensions from " << launch_path << ", using the default bounds" << std::endl;
+	}
+	if( !mix.empty() ? !ParseTypeMix( mix, layout ) : !LoadActorTypes( actors_path, layout ) )
+	{
+		std::cout << "No actor types, check --mix or " << actors_path << std::endl;
+		return 1;
+	}
+	if( !has_count )
+	{
+		layout.entity_count = (uint64_t)( density * layout.GetArea() );
+	}
+
+	std::cout << "Writing " << layout.entity_count << " actors over x [" << layout.min_x << ", " << layout.max_x
+		<< "] z [" << layout.min_z << ", " << layout.max_z << "] to " << output_path << std::endl;
+
+	snapshot_gen_stats_t stats;
+	SnapshotGenerator generator( layout );
+	bool written = generator.Write( output_path, settings, stats );
+
+	double rate = stats.total_seconds > 0.0 ? (double)stats.written / stats.total_seconds : 0.0;
+	std::cout << ( written ? "Wrote " : "Failed after " ) << stats.written << " entities in " << stats.total_seconds << " s ("
+		<< rate << " entities/s, " << stats.build_seconds << " s building)" << std::endl;
+	return written ? 0 : 1;
+}
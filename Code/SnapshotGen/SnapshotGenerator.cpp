@@ -0,0 +1,345 @@
+#include "SnapshotGen/SnapshotGenerator.hpp"
+
+#include "Engine/Core/XML/XMLUtils.hpp"
+
+#include "Shared/JobSystem.hpp"
+#include "Shared/PlanePositionCodec.hpp"
+#include "Shared/WorkerConnection.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <thread>
+
+//--------------------------------------------------------------------------
+/**
+* MixBits
+* splitmix64, cheap and good enough to scatter entities from their index.
+*/
+static uint64_t MixBits( uint64_t value )
+{
+	value += 0x9e3779b97f4a7c15ull;
+	value = ( value ^ ( value >> 30 ) ) * 0xbf58476d1ce4e5b9ull;
+	value = ( value ^ ( value >> 27 ) ) * 0x94d049bb133111ebull;
+	return value ^ ( value >> 31 );
+}
+
+//--------------------------------------------------------------------------
+/**
+* ToUnit
+* [0, 1) out of the top 53 bits.
+*/
+static double ToUnit( uint64_t bits )
+{
+	return (double)( bits >> 11 ) * ( 1.0 / 9007199254740992.0 );
+}
+
+//--------------------------------------------------------------------------
+/**
+* FindJsonNumber
+* First number after "key": in the text, no nesting is checked.
+*/
+static bool FindJsonNumber( const std::string& text, const std::string& key, double& value )
+{
+	size_t found = text.find( "\"" + key + "\"" );
+	if( found == std::string::npos )
+	{
+		return false;
+	}
+	found = text.find( ':', found );
+	if( found == std::string::npos )
+	{
+		return false;
+	}
+	const char* start = text.c_str() + found + 1;
+	char* end = nullptr;
+	value = strtod( start, &end );
+	return end != start;
+}
+
+//--------------------------------------------------------------------------
+/**
+* LoadLaunchRegion
+*/
+bool LoadLaunchRegion( const std::string& launch_path, snapshot_layout_t& layout )
+{
+	std::ifstream file( launch_path );
+	if( !file )
+	{
+		return false;
+	}
+	std::stringstream text;
+	text << file.rdbuf();
+
+	double x_meters = 0.0;
+	double z_meters = 0.0;
+	if( !FindJsonNumber( text.str(), "x_meters", x_meters ) || !FindJsonNumber( text.str(), "z_meters", z_meters )
+		|| x_meters <= 0.0 || z_meters <= 0.0 )
+	{
+		return false;
+	}
+
+	// SpatialOS centres the world on the origin.
+	layout.min_x = -0.5 * x_meters;
+	layout.max_x = 0.5 * x_meters;
+	layout.min_z = -0.5 * z_meters;
+	layout.max_z = 0.5 * z_meters;
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* LoadActorTypes
+*/
+bool LoadActorTypes( const std::string& actors_path, snapshot_layout_t& layout )
+{
+	tinyxml2::XMLDocument definitions;
+	if( definitions.LoadFile( actors_path.c_str() ) != tinyxml2::XML_SUCCESS || !definitions.RootElement() )
+	{
+		return false;
+	}
+
+	layout.types.clear();
+	for( XmlElement* element = definitions.RootElement()->FirstChildElement(); element != nullptr; element = element->NextSiblingElement() )
+	{
+		// Possessable actors are players, those come from clients joining.
+		if( ParseXmlAttribute( *element, "possess", false ) )
+		{
+			continue;
+		}
+		snapshot_entity_type_t type;
+		type.name = ParseXmlAttribute( *element, "name", "none" );
+		layout.types.push_back( type );
+	}
+	return !layout.types.empty();
+}
+
+//--------------------------------------------------------------------------
+/**
+* ParseTypeMix
+*/
+bool ParseTypeMix( const std::string& mix, snapshot_layout_t& layout )
+{
+	std::vector<snapshot_entity_type_t> types;
+	std::stringstream entries( mix );
+	std::string entry;
+	while( std::getline( entries, entry, ',' ) )
+	{
+		size_t equals = entry.find( '=' );
+		snapshot_entity_type_t type;
+		type.name = entry.substr( 0, equals );
+		type.weight = equals != std::string::npos ? atof( entry.c_str() + equals + 1 ) : 1.0;
+		if( type.name.empty() || type.weight <= 0.0 )
+		{
+			return false;
+		}
+		types.push_back( type );
+	}
+	if( types.empty() )
+	{
+		return false;
+	}
+	layout.types.swap( types );
+	return true;
+}
+
+//--------------------------------------------------------------------------
+/**
+* SnapshotGenerator
+*/
+SnapshotGenerator::SnapshotGenerator( const snapshot_layout_t& layout )
+	: m_layout( layout )
+{
+	double total = 0.0;
+	for( const snapshot_entity_type_t& type : m_layout.types )
+	{
+		total += type.weight;
+		m_cumulative_weights.push_back( total );
+	}
+	for( double& weight : m_cumulative_weights )
+	{
+		weight /= total;
+	}
+
+	improbable::WorkerAttributeSet client_attribute_set( { "client" } );
+	improbable::WorkerAttributeSet server_attribute_set( { "simulation" } );
+	improbable::WorkerRequirementSet client_requirement_set( { client_attribute_set } );
+	improbable::WorkerRequirementSet server_requirement_set( { server_attribute_set } );
+	improbable::WorkerRequirementSet client_or_server_requirement_set( { client_attribute_set, server_attribute_set } );
+
+	// Same as the hand written snapshot's turrets and crawlers.
+	worker::Map<worker::ComponentId, improbable::WorkerRequirementSet> actor_write_acl;
+	actor_write_acl[improbable::Position::ComponentId] = server_requirement_set;
+	actor_write_acl[siren::PlanePosition::ComponentId] = server_requirement_set;
+	actor_write_acl[improbable::EntityAcl::ComponentId] = server_requirement_set;
+	actor_write_acl[improbable::Metadata::ComponentId] = server_requirement_set;
+	actor_write_acl[siren::PlayerControls::ComponentId] = client_requirement_set;
+	m_actor_acl = improbable::EntityAcl::Data( client_or_server_requirement_set, actor_write_acl );
+
+	improbable::ComponentInterest::QueryConstraint relative_constraint;
+	relative_constraint.set_relative_box_constraint( { { { 20.5, 9999, 20.5 } } } );
+	improbable::ComponentInterest::Query relative_query;
+	relative_query.set_constraint( relative_constraint );
+	relative_query.set_full_snapshot_result( { true } );
+	m_actor_interest = improbable::InterestData( { { siren::Client::ComponentId, improbable::ComponentInterest( { relative_query } ) } } );
+
+	worker::Map<std::uint32_t, improbable::WorkerRequirementSet> api_write_acl;
+	api_write_acl.insert( { { siren::ServerAPI::ComponentId, server_requirement_set } } );
+	m_api_acl = improbable::EntityAcl::Data( client_or_server_requirement_set, api_write_acl );
+
+	improbable::ComponentInterest::QueryConstraint client_constraint;
+	client_constraint.set_component_constraint( siren::Client::ComponentId );
+	improbable::ComponentInterest::Query client_query;
+	client_query.set_constraint( client_constraint );
+	client_query.set_full_snapshot_result( { true } );
+	improbable::ComponentInterest client_interest;
+	client_interest.set_queries( { client_query } );
+	m_api_interest.component_interest()[siren::ServerAPI::ComponentId] = client_interest;
+}
+
+//--------------------------------------------------------------------------
+/**
+* PickType
+*/
+const std::string& SnapshotGenerator::PickType( double roll ) const
+{
+	for( size_t idx = 0; idx + 1 < m_cumulative_weights.size(); ++idx )
+	{
+		if( roll < m_cumulative_weights[idx] )
+		{
+			return m_layout.types[idx].name;
+		}
+	}
+	return m_layout.types.back().name;
+}
+
+//--------------------------------------------------------------------------
+/**
+* BuildEntity
+*/
+worker::Entity SnapshotGenerator::BuildEntity( uint64_t index ) const
+{
+	uint64_t bits = MixBits( m_layout.seed ^ MixBits( index ) );
+	double x = m_layout.min_x + ToUnit( bits ) * ( m_layout.max_x - m_layout.min_x );
+	bits = MixBits( bits );
+	double z = m_layout.min_z + ToUnit( bits ) * ( m_layout.max_z - m_layout.min_z );
+	bits = MixBits( bits );
+
+	worker::Entity entity;
+	entity.Add<improbable::Metadata>( { PickType( ToUnit( bits ) ) } );
+	entity.Add<improbable::Persistence>( {} );
+	entity.Add<improbable::Position>( { { x, 0.0, z } } );
+	entity.Add<siren::PlanePosition>( MakePlanePositionData( Vec2( (float)x, (float)z ) ) );
+	entity.Add<siren::PlayerControls>( siren::PlayerControls::Data() );
+	entity.Add<improbable::EntityAcl>( m_actor_acl );
+	entity.Add<improbable::Interest>( m_actor_interest );
+	return entity;
+}
+
+//--------------------------------------------------------------------------
+/**
+* BuildApiEntity
+*/
+worker::Entity SnapshotGenerator::BuildApiEntity() const
+{
+	worker::Entity entity;
+	entity.Add<improbable::Metadata>( { "API" } );
+	entity.Add<improbable::Persistence>( {} );
+	entity.Add<improbable::Position>( { { -100, -100, -100 } } );
+	entity.Add<siren::ServerAPI>( {} );
+	entity.Add<improbable::EntityAcl>( m_api_acl );
+	entity.Add<improbable::Interest>( m_api_interest );
+	return entity;
+}
+
+//--------------------------------------------------------------------------
+/**
+* Write
+* Builds batch n on every thread while the writer streams out batch n - 1.
+*/
+bool SnapshotGenerator::Write( const std::string& path, const snapshot_gen_settings_t& settings, snapshot_gen_stats_t& stats ) const
+{
+	using gen_clock = std::chrono::steady_clock;
+	gen_clock::time_point start = gen_clock::now();
+	stats = snapshot_gen_stats_t();
+
+	if( m_layout.entity_count > 0 && m_layout.types.empty() )
+	{
+		std::cout << "Snapshot: no entity types to pick from" << std::endl;
+		return false;
+	}
+
+	worker::Result<worker::SnapshotOutputStream, worker::StreamErrorCode> stream = worker::SnapshotOutputStream::Create( WorkerComponentRegistry{}, path );
+	if( !stream )
+	{
+		std::cout << "Snapshot: couldn't open " << path << ": " << stream.GetErrorMessage() << std::endl;
+		return false;
+	}
+
+	std::atomic<bool> failed{ false };
+	std::atomic<uint64_t> written{ 0 };
+	auto write_entity = [&]( worker::EntityId id, const worker::Entity& entity ) {
+		worker::Result<worker::None, worker::StreamErrorCode> result = stream->WriteEntity( id, entity );
+		if( !result )
+		{
+			std::cout << "Snapshot: failed writing entity " << id << ": " << result.GetErrorMessage() << std::endl;
+			failed = true;
+			return;
+		}
+		++written;
+	};
+
+	if( m_layout.include_api )
+	{
+		write_entity( API_ENTITY_ID, BuildApiEntity() );
+	}
+
+	uint32_t thread_count = settings.thread_count > 0 ? settings.thread_count : std::max( 1u, std::thread::hardware_concurrency() );
+	uint32_t batch_size = std::max( 1u, settings.batch_size );
+	JobSystem jobs;
+	jobs.Startup( thread_count - 1 );
+
+	std::vector<worker::Entity> batches[2];
+	std::thread writer;
+	for( uint64_t first = 0, batch = 0; first < m_layout.entity_count && !failed; first += batch_size, ++batch )
+	{
+		// The writer from two batches ago was joined before the last one started.
+		std::vector<worker::Entity>& entities = batches[batch & 1];
+		uint32_t count = (uint32_t)std::min<uint64_t>( batch_size, m_layout.entity_count - first );
+		entities.resize( count );
+
+		gen_clock::time_point build_start = gen_clock::now();
+		jobs.ParallelFor( count, 256, [&]( uint32_t, uint32_t begin, uint32_t end ) {
+			for( uint32_t idx = begin; idx < end; ++idx )
+			{
+				entities[idx] = BuildEntity( first + idx );
+			}
+			} );
+		stats.build_seconds += std::chrono::duration<double>( gen_clock::now() - build_start ).count();
+
+		if( writer.joinable() )
+		{
+			writer.join();
+		}
+		writer = std::thread( [&, first]( std::vector<worker::Entity>* to_write ) {
+			for( size_t idx = 0; idx < to_write->size() && !failed; ++idx )
+			{
+				write_entity( GetEntityId( first + idx ), ( *to_write )[idx] );
+			}
+			to_write->clear();
+			}, &entities );
+	}
+	if( writer.joinable() )
+	{
+		writer.join();
+	}
+	jobs.Shutdown();
+
+	stats.written = written;
+	stats.total_seconds = std::chrono::duration<double>( gen_clock::now() - start ).count();
+	return !failed;
+}
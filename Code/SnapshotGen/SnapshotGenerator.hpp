@@ -0,0 +1,91 @@
+#pragma once
+#include <improbable/worker.h>
+#include <improbable/standard_library.h>
+
+#include "ClientServer.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct snapshot_entity_type_t
+{
+	std::string name;
+	double weight = 1.0;
+};
+
+//--------------------------------------------------------------------------
+// What the snapshot should look like. Entities are spread uniformly over the
+// region, each picks its type by weight. The same layout and seed always gives
+// the same snapshot, however many threads built it.
+//--------------------------------------------------------------------------
+struct snapshot_layout_t
+{
+	// World units on the x and z axes, defaults to a 1500m world centred on the origin.
+	double min_x = -750.0;
+	double max_x = 750.0;
+	double min_z = -750.0;
+	double max_z = 750.0;
+
+	uint64_t entity_count = 0;
+	std::vector<snapshot_entity_type_t> types;
+	uint64_t seed = 1;
+	bool include_api = true;		// The ServerAPI entity clients send their commands to, as entity 1.
+
+	double GetArea() const { return ( max_x - min_x ) * ( max_z - min_z ); }
+};
+
+// Region from the world dimensions of a launch config, e.g. default_launch.json.
+bool LoadLaunchRegion( const std::string& launch_path, snapshot_layout_t& layout );
+// Every actor definition players can't possess, all weighted the same.
+bool LoadActorTypes( const std::string& actors_path, snapshot_layout_t& layout );
+// "turret=3,crawler=1", replaces the types.
+bool ParseTypeMix( const std::string& mix, snapshot_layout_t& layout );
+
+struct snapshot_gen_settings_t
+{
+	uint32_t thread_count = 0;			// Including the calling thread, 0 for one per core.
+	uint32_t batch_size = 4096;			// Entities built ahead of the writer, twice this is ever held at once.
+};
+
+struct snapshot_gen_stats_t
+{
+	uint64_t written = 0;
+	double build_seconds = 0.0;			// Spent waiting on entity construction.
+	double total_seconds = 0.0;
+};
+
+//--------------------------------------------------------------------------
+// Streams a snapshot_layout_t into a worker::SnapshotOutputStream. Entities are
+// built in batches across a JobSystem while a writer thread streams out the
+// previous batch, so memory stays at two batches whatever the entity count.
+//--------------------------------------------------------------------------
+class SnapshotGenerator
+{
+public:
+	explicit SnapshotGenerator( const snapshot_layout_t& layout );
+
+public:
+	bool Write( const std::string& path, const snapshot_gen_settings_t& settings, snapshot_gen_stats_t& stats ) const;
+
+	// Entity ids follow the API entity, the index alone decides the entity.
+	worker::EntityId GetEntityId( uint64_t index ) const { return FIRST_ENTITY_ID + (worker::EntityId)index; }
+	worker::Entity BuildEntity( uint64_t index ) const;
+	worker::Entity BuildApiEntity() const;
+
+private:
+	static constexpr worker::EntityId API_ENTITY_ID = 1;
+	static constexpr worker::EntityId FIRST_ENTITY_ID = 2;
+
+	const std::string& PickType( double roll ) const;
+
+private:
+	snapshot_layout_t m_layout;
+	std::vector<double> m_cumulative_weights;
+
+	// The same for every entity, built once and copied in.
+	improbable::EntityAcl::Data m_actor_acl;
+	improbable::InterestData m_actor_interest;
+	improbable::EntityAcl::Data m_api_acl;
+	improbable::InterestData m_api_interest;
+};